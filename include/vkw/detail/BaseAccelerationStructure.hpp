@@ -25,6 +25,7 @@
 #include "vkw/detail/AccelerationStructureBuildInfo.hpp"
 #include "vkw/detail/Buffer.hpp"
 #include "vkw/detail/Common.hpp"
+#include "vkw/detail/DebugUtils.hpp"
 #include "vkw/detail/Device.hpp"
 
 namespace vkw
@@ -42,6 +43,16 @@ class BaseAccelerationStructure
 
     auto getHandle() const { return accelerationStructure_; }
 
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(accelerationStructure_ != VK_NULL_HANDLE);
+        debug::setObjectName(
+            device_->getHandle(),
+            VK_OBJECT_TYPE_ACCELERATION_STRUCTURE_KHR,
+            accelerationStructure_,
+            name);
+    }
+
     bool buildOnHost() const { return buildOnHost_; }
 
     VkDeviceAddress getDeviceAddress() const
@@ -90,5 +101,6 @@ class BaseAccelerationStructure
         storageBuffer_.clear();
         device_ = nullptr;
     }
+
 };
 } // namespace vkw
\ No newline at end of file
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "vkw/detail/Common.hpp"
+#include "vkw/detail/DebugUtils.hpp"
 #include "vkw/detail/Device.hpp"
 #include "vkw/detail/MemoryCommon.hpp"
 #include "vkw/detail/utils.hpp"
@@ -75,6 +76,7 @@ class Buffer
 
         std::swap(hostPtr_, rhs.hostPtr_);
 
+        std::swap(generation_, rhs.generation_);
         std::swap(initialized_, rhs.initialized_);
 
         return *this;
@@ -84,6 +86,9 @@ class Buffer
 
     bool initialized() const { return initialized_; }
 
+    // Changes each time the buffer is created again, 0 when not initialized
+    uint64_t generation() const { return generation_; }
+
     bool init(
         Device& device,
         const VkBufferUsageFlags usage,
@@ -143,6 +148,7 @@ class Buffer
         utils::Log::Debug("vkw", "  hostCoherent: %s", hostCoherent() ? "True" : "False");
         utils::Log::Debug("vkw", "  hostCached:   %s", hostCached() ? "True" : "False");
 
+        generation_ = utils::nextGeneration();
         initialized_ = true;
 
         return true;
@@ -161,6 +167,7 @@ class Buffer
         usage_ = {};
         allocInfo_ = {};
 
+        generation_ = 0;
         initialized_ = false;
         device_ = nullptr;
     }
@@ -171,6 +178,12 @@ class Buffer
     VkBufferUsageFlags getUsage() const { return usage_; }
     VkBuffer getHandle() const { return buffer_; }
 
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(this->initialized());
+        debug::setObjectName(device_->getHandle(), VK_OBJECT_TYPE_BUFFER, buffer_, name);
+    }
+
     VkDescriptorBufferInfo getFullSizeInfo() const { return {buffer_, 0, sizeBytes()}; }
     VkDescriptorBufferInfo getDescriptorInfo(const size_t offset, const size_t size) const
     {
@@ -385,6 +398,7 @@ class Buffer
 
     T* hostPtr_{nullptr};
 
+    uint64_t generation_{0};
     bool initialized_{false};
 };
 
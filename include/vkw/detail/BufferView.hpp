@@ -24,6 +24,7 @@
 
 #include "vkw/detail/Buffer.hpp"
 #include "vkw/detail/Common.hpp"
+#include "vkw/detail/DebugUtils.hpp"
 #include "vkw/detail/Device.hpp"
 
 #include <cstdio>
@@ -123,6 +124,12 @@ class BufferView
 
     VkBufferView getHandle() const { return bufferView_; }
 
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(this->initialized());
+        debug::setObjectName(device_->getHandle(), VK_OBJECT_TYPE_BUFFER_VIEW, bufferView_, name);
+    }
+
   private:
     Device* device_{nullptr};
     VkBufferView bufferView_{VK_NULL_HANDLE};
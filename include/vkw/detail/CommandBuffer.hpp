@@ -26,17 +26,22 @@
 #include "vkw/detail/Buffer.hpp"
 #include "vkw/detail/Common.hpp"
 #include "vkw/detail/ComputePipeline.hpp"
+#include "vkw/detail/DebugUtils.hpp"
+#include "vkw/detail/DescriptorBuffer.hpp"
 #include "vkw/detail/DescriptorSet.hpp"
 #include "vkw/detail/Device.hpp"
 #include "vkw/detail/GraphicsPipeline.hpp"
 #include "vkw/detail/Image.hpp"
 #include "vkw/detail/Instance.hpp"
+#include "vkw/detail/QueryPool.hpp"
 #include "vkw/detail/RenderPass.hpp"
 #include "vkw/detail/RenderingAttachment.hpp"
+#include "vkw/detail/ShaderObject.hpp"
 #include "vkw/detail/Synchronization.hpp"
 #include "vkw/detail/TopLevelAccelerationStructure.hpp"
 #include "vkw/detail/utils.hpp"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 
@@ -153,6 +158,9 @@ static inline VkImageMemoryBarrier createImageMemoryBarrier(
 class CommandBuffer
 {
   public:
+    // Largest update allowed by vkCmdUpdateBuffer
+    static constexpr VkDeviceSize maxUpdateBufferSize = 65536;
+
     CommandBuffer() {}
     CommandBuffer(Device& device, VkCommandPool commandPool, VkCommandBufferLevel level)
     {
@@ -220,6 +228,13 @@ class CommandBuffer
 
     bool initialized() const { return initialized_; }
 
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(this->initialized());
+        debug::setObjectName(
+            device_->getHandle(), VK_OBJECT_TYPE_COMMAND_BUFFER, commandBuffer_, name);
+    }
+
     bool begin(VkCommandBufferUsageFlags usage = 0)
     {
         VKW_ASSERT(this->initialized());
@@ -236,6 +251,24 @@ class CommandBuffer
         return true;
     }
 
+    // Secondary command buffers must provide inheritance information
+    bool begin(
+        VkCommandBufferUsageFlags usage, const VkCommandBufferInheritanceInfo& inheritanceInfo)
+    {
+        VKW_ASSERT(this->initialized());
+
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.pNext = nullptr;
+        beginInfo.flags = usage;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+        VKW_CHECK_VK_RETURN_FALSE(device_->vk().vkBeginCommandBuffer(commandBuffer_, &beginInfo));
+        recording_ = true;
+
+        return true;
+    }
+
     bool end()
     {
         VKW_ASSERT(this->initialized());
@@ -251,7 +284,7 @@ class CommandBuffer
         VKW_CHECK_VK_RETURN_FALSE(device_->vk().vkResetCommandBuffer(commandBuffer_, 0));
         recording_ = false;
 
-        return false;
+        return true;
     }
 
     // ---------------------------------------------------------------------------------------------
@@ -278,13 +311,86 @@ class CommandBuffer
         VkBufferCopy copyData;
         copyData.dstOffset = 0;
         copyData.srcOffset = 0;
-        copyData.size = src.sizeBytes(),
+        copyData.size = std::min(src.sizeBytes(), dst.sizeBytes());
 
         device_->vk().vkCmdCopyBuffer(
             commandBuffer_, src.getHandle(), dst.getHandle(), 1, &copyData);
         return *this;
     }
 
+    // Offsets and size in bytes
+    template <typename SrcBufferType, typename DstBufferType>
+    CommandBuffer& copyBuffer(
+        SrcBufferType& src,
+        DstBufferType& dst,
+        const VkDeviceSize srcOffset,
+        const VkDeviceSize dstOffset,
+        const VkDeviceSize size)
+    {
+        VKW_ASSERT(recording_);
+        VKW_ASSERT(srcOffset + size <= src.sizeBytes());
+        VKW_ASSERT(dstOffset + size <= dst.sizeBytes());
+
+        VkBufferCopy copyData;
+        copyData.srcOffset = srcOffset;
+        copyData.dstOffset = dstOffset;
+        copyData.size = size;
+
+        device_->vk().vkCmdCopyBuffer(
+            commandBuffer_, src.getHandle(), dst.getHandle(), 1, &copyData);
+        return *this;
+    }
+
+    CommandBuffer& copyBuffer2(const VkCopyBufferInfo2& copyInfo)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdCopyBuffer2(commandBuffer_, &copyInfo);
+        return *this;
+    }
+
+    template <typename SrcBufferType, typename DstBufferType>
+    CommandBuffer& copyBuffer2(
+        const SrcBufferType& src,
+        const DstBufferType& dst,
+        const utils::Span<const VkBufferCopy2> regions)
+    {
+        VkCopyBufferInfo2 copyInfo = {};
+        copyInfo.sType = VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2;
+        copyInfo.pNext = nullptr;
+        copyInfo.srcBuffer = src.getHandle();
+        copyInfo.dstBuffer = dst.getHandle();
+        copyInfo.regionCount = static_cast<uint32_t>(regions.size());
+        copyInfo.pRegions = regions.data();
+
+        return copyBuffer2(copyInfo);
+    }
+
+    // Data is stored inline in the command buffer, the size is limited to maxUpdateBufferSize
+    // bytes. Size and offset must be multiples of 4.
+    template <typename BufferType>
+    CommandBuffer& updateBuffer(
+        BufferType& buffer,
+        const typename BufferType::value_type* data,
+        const size_t count,
+        const size_t offset = 0)
+    {
+        using T = typename BufferType::value_type;
+
+        VKW_ASSERT(recording_);
+        VKW_ASSERT(count * sizeof(T) <= maxUpdateBufferSize);
+        VKW_ASSERT((count * sizeof(T)) % 4 == 0);
+        VKW_ASSERT((offset * sizeof(T)) % 4 == 0);
+
+        device_->vk().vkCmdUpdateBuffer(
+            commandBuffer_,
+            buffer.getHandle(),
+            static_cast<VkDeviceSize>(offset * sizeof(T)),
+            static_cast<VkDeviceSize>(count * sizeof(T)),
+            data);
+        return *this;
+    }
+
     template <typename BufferType, typename T>
     CommandBuffer& fillBuffer(BufferType& buffer, T val, const size_t offset, const size_t size)
     {
@@ -359,6 +465,108 @@ class CommandBuffer
         return *this;
     }
 
+    template <typename SrcImageType, typename DstImageType>
+    CommandBuffer& copyImage(
+        const SrcImageType& src,
+        const VkImageLayout srcLayout,
+        const DstImageType& dst,
+        const VkImageLayout dstLayout,
+        const VkImageCopy& region)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdCopyImage(
+            commandBuffer_, src.getHandle(), srcLayout, dst.getHandle(), dstLayout, 1, &region);
+        return *this;
+    }
+
+    template <typename SrcImageType, typename DstImageType>
+    CommandBuffer& copyImage(
+        const SrcImageType& src,
+        const VkImageLayout srcLayout,
+        const DstImageType& dst,
+        const VkImageLayout dstLayout,
+        const utils::Span<const VkImageCopy> regions)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdCopyImage(
+            commandBuffer_,
+            src.getHandle(),
+            srcLayout,
+            dst.getHandle(),
+            dstLayout,
+            static_cast<uint32_t>(regions.size()),
+            regions.data());
+        return *this;
+    }
+
+    template <typename SrcImageType, typename DstImageType>
+    CommandBuffer& resolveImage(
+        const SrcImageType& src,
+        const VkImageLayout srcLayout,
+        const DstImageType& dst,
+        const VkImageLayout dstLayout,
+        const VkImageResolve& region)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdResolveImage(
+            commandBuffer_, src.getHandle(), srcLayout, dst.getHandle(), dstLayout, 1, &region);
+        return *this;
+    }
+
+    template <typename SrcImageType, typename DstImageType>
+    CommandBuffer& resolveImage(
+        const SrcImageType& src,
+        const VkImageLayout srcLayout,
+        const DstImageType& dst,
+        const VkImageLayout dstLayout,
+        const utils::Span<const VkImageResolve> regions)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdResolveImage(
+            commandBuffer_,
+            src.getHandle(),
+            srcLayout,
+            dst.getHandle(),
+            dstLayout,
+            static_cast<uint32_t>(regions.size()),
+            regions.data());
+        return *this;
+    }
+
+    template <typename ImageType>
+    CommandBuffer& clearColorImage(
+        const ImageType& image,
+        const VkImageLayout layout,
+        const VkClearColorValue& clearColor,
+        const VkImageSubresourceRange& range
+        = {VK_IMAGE_ASPECT_COLOR_BIT, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS})
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdClearColorImage(
+            commandBuffer_, image.getHandle(), layout, &clearColor, 1, &range);
+        return *this;
+    }
+
+    template <typename ImageType>
+    CommandBuffer& clearDepthStencilImage(
+        const ImageType& image,
+        const VkImageLayout layout,
+        const VkClearDepthStencilValue& clearValue,
+        const VkImageSubresourceRange& range
+        = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS})
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdClearDepthStencilImage(
+            commandBuffer_, image.getHandle(), layout, &clearValue, 1, &range);
+        return *this;
+    }
+
     template <typename SrcImageType, typename DstImageType>
     CommandBuffer& blitImage(
         const SrcImageType& src,
@@ -402,7 +610,7 @@ class CommandBuffer
         const VkImageLayout srcLayout,
         const DstImageType& dst,
         const VkImageLayout dstLayout,
-        const std::vector<VkImageBlit>& regions,
+        const utils::Span<const VkImageBlit> regions,
         const VkFilter filter = VK_FILTER_LINEAR)
     {
         VKW_ASSERT(recording_);
@@ -423,7 +631,7 @@ class CommandBuffer
         const VkImageLayout srcLayout,
         const VkImage dst,
         const VkImageLayout dstLayout,
-        const std::vector<VkImageBlit>& regions,
+        const utils::Span<const VkImageBlit> regions,
         const VkFilter filter = VK_FILTER_LINEAR)
     {
         VKW_ASSERT(recording_);
@@ -448,14 +656,16 @@ class CommandBuffer
     {
         VKW_ASSERT(recording_);
 
-        std::vector<VkMemoryBarrier> barrierList({std::forward<Args>(barriers)...});
+        static_assert(sizeof...(Args) > 0, "At least one barrier is required");
+
+        const VkMemoryBarrier barrierList[] = {std::forward<Args>(barriers)...};
         device_->vk().vkCmdPipelineBarrier(
             commandBuffer_,
             srcFlags,
             dstFlags,
             0,
-            static_cast<uint32_t>(barrierList.size()),
-            reinterpret_cast<const VkMemoryBarrier*>(barrierList.data()),
+            static_cast<uint32_t>(sizeof...(Args)),
+            barrierList,
             0,
             nullptr,
             0,
@@ -476,7 +686,9 @@ class CommandBuffer
     {
         VKW_ASSERT(recording_);
 
-        std::vector<VkBufferMemoryBarrier> barrierList({std::forward<Args>(barriers)...});
+        static_assert(sizeof...(Args) > 0, "At least one barrier is required");
+
+        const VkBufferMemoryBarrier barrierList[] = {std::forward<Args>(barriers)...};
         device_->vk().vkCmdPipelineBarrier(
             commandBuffer_,
             srcFlags,
@@ -484,8 +696,8 @@ class CommandBuffer
             0,
             0,
             nullptr,
-            static_cast<uint32_t>(barrierList.size()),
-            reinterpret_cast<const VkBufferMemoryBarrier*>(barrierList.data()),
+            static_cast<uint32_t>(sizeof...(Args)),
+            barrierList,
             0,
             nullptr);
         return *this;
@@ -506,7 +718,9 @@ class CommandBuffer
     {
         VKW_ASSERT(recording_);
 
-        std::vector<VkImageMemoryBarrier> barrierList({std::forward<Args>(barriers)...});
+        static_assert(sizeof...(Args) > 0, "At least one barrier is required");
+
+        const VkImageMemoryBarrier barrierList[] = {std::forward<Args>(barriers)...};
         device_->vk().vkCmdPipelineBarrier(
             commandBuffer_,
             srcFlags,
@@ -516,8 +730,8 @@ class CommandBuffer
             nullptr,
             0,
             nullptr,
-            static_cast<uint32_t>(barrierList.size()),
-            reinterpret_cast<const VkImageMemoryBarrier*>(barrierList.data()));
+            static_cast<uint32_t>(sizeof...(Args)),
+            barrierList);
         return *this;
     }
     CommandBuffer& imageMemoryBarrier(
@@ -530,6 +744,126 @@ class CommandBuffer
         return imageMemoryBarriers(srcFlags, dstFlags, barrier);
     }
 
+    // Queue family ownership transfer of exclusive resources. The release is recorded on the
+    // source queue and the matching acquire, with the same range and layouts, on the destination
+    // queue once the release has executed, usually behind a semaphore. When both queues belong to
+    // the same family the release is skipped and the acquire is a regular barrier.
+    template <typename BufferType>
+    CommandBuffer& releaseBufferOwnership(
+        const BufferType& buffer,
+        const Queue& srcQueue,
+        const Queue& dstQueue,
+        const VkPipelineStageFlags srcFlags,
+        const VkAccessFlags srcMask,
+        const VkDeviceSize offset = 0,
+        const VkDeviceSize size = VK_WHOLE_SIZE)
+    {
+        VKW_ASSERT(recording_);
+
+        if(srcQueue.queueFamilyIndex() == dstQueue.queueFamilyIndex())
+        {
+            return *this;
+        }
+
+        auto barrier = createBufferMemoryBarrier(buffer, srcMask, 0, offset, size);
+        barrier.srcQueueFamilyIndex = srcQueue.queueFamilyIndex();
+        barrier.dstQueueFamilyIndex = dstQueue.queueFamilyIndex();
+        return bufferMemoryBarrier(srcFlags, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, barrier);
+    }
+    template <typename BufferType>
+    CommandBuffer& acquireBufferOwnership(
+        const BufferType& buffer,
+        const Queue& srcQueue,
+        const Queue& dstQueue,
+        const VkPipelineStageFlags dstFlags,
+        const VkAccessFlags dstMask,
+        const VkDeviceSize offset = 0,
+        const VkDeviceSize size = VK_WHOLE_SIZE)
+    {
+        VKW_ASSERT(recording_);
+
+        if(srcQueue.queueFamilyIndex() == dstQueue.queueFamilyIndex())
+        {
+            const auto barrier = createBufferMemoryBarrier(
+                buffer, VK_ACCESS_MEMORY_WRITE_BIT, dstMask, offset, size);
+            return bufferMemoryBarrier(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, dstFlags, barrier);
+        }
+
+        auto barrier = createBufferMemoryBarrier(buffer, 0, dstMask, offset, size);
+        barrier.srcQueueFamilyIndex = srcQueue.queueFamilyIndex();
+        barrier.dstQueueFamilyIndex = dstQueue.queueFamilyIndex();
+        return bufferMemoryBarrier(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, dstFlags, barrier);
+    }
+
+    template <typename ImageType>
+    CommandBuffer& releaseImageOwnership(
+        const ImageType& image,
+        const Queue& srcQueue,
+        const Queue& dstQueue,
+        const VkPipelineStageFlags srcFlags,
+        const VkAccessFlags srcMask,
+        const VkImageLayout oldLayout,
+        const VkImageLayout newLayout,
+        const VkImageAspectFlags aspectFlags = VK_IMAGE_ASPECT_COLOR_BIT)
+    {
+        VKW_ASSERT(recording_);
+
+        if(srcQueue.queueFamilyIndex() == dstQueue.queueFamilyIndex())
+        {
+            return *this;
+        }
+
+        auto barrier = createImageMemoryBarrier(
+            image,
+            srcMask,
+            0,
+            oldLayout,
+            newLayout,
+            aspectFlags,
+            0,
+            VK_REMAINING_MIP_LEVELS,
+            0,
+            VK_REMAINING_ARRAY_LAYERS);
+        barrier.srcQueueFamilyIndex = srcQueue.queueFamilyIndex();
+        barrier.dstQueueFamilyIndex = dstQueue.queueFamilyIndex();
+        return imageMemoryBarrier(srcFlags, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, barrier);
+    }
+    template <typename ImageType>
+    CommandBuffer& acquireImageOwnership(
+        const ImageType& image,
+        const Queue& srcQueue,
+        const Queue& dstQueue,
+        const VkPipelineStageFlags dstFlags,
+        const VkAccessFlags dstMask,
+        const VkImageLayout oldLayout,
+        const VkImageLayout newLayout,
+        const VkImageAspectFlags aspectFlags = VK_IMAGE_ASPECT_COLOR_BIT)
+    {
+        VKW_ASSERT(recording_);
+
+        const bool sameFamily = (srcQueue.queueFamilyIndex() == dstQueue.queueFamilyIndex());
+
+        auto barrier = createImageMemoryBarrier(
+            image,
+            sameFamily ? VK_ACCESS_MEMORY_WRITE_BIT : 0,
+            dstMask,
+            oldLayout,
+            newLayout,
+            aspectFlags,
+            0,
+            VK_REMAINING_MIP_LEVELS,
+            0,
+            VK_REMAINING_ARRAY_LAYERS);
+        if(sameFamily)
+        {
+            return imageMemoryBarrier(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, dstFlags, barrier);
+        }
+
+        barrier.srcQueueFamilyIndex = srcQueue.queueFamilyIndex();
+        barrier.dstQueueFamilyIndex = dstQueue.queueFamilyIndex();
+        return imageMemoryBarrier(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, dstFlags, barrier);
+    }
+
     template <
         typename MemoryBarrierList,
         typename BufferMemoryBarrierList,
@@ -554,6 +888,7 @@ class CommandBuffer
             reinterpret_cast<const VkBufferMemoryBarrier*>(bufferMemoryBarriers.data()),
             static_cast<uint32_t>(imageMemoryBarriers.size()),
             reinterpret_cast<const VkImageMemoryBarrier*>(imageMemoryBarriers.data()));
+        return *this;
     }
 
     // ---------------------------------------------------------------------------------------------
@@ -570,9 +905,9 @@ class CommandBuffer
         const Event& event,
         const VkPipelineStageFlags srcFlags,
         const VkPipelineStageFlags dstFlags,
-        const std::vector<VkMemoryBarrier>& memoryBarriers,
-        const std::vector<VkBufferMemoryBarrier>& bufferMemoryBarriers,
-        const std::vector<VkImageMemoryBarrier>& imageMemoryBarriers)
+        const utils::Span<const VkMemoryBarrier> memoryBarriers,
+        const utils::Span<const VkBufferMemoryBarrier> bufferMemoryBarriers,
+        const utils::Span<const VkImageMemoryBarrier> imageMemoryBarriers)
     {
         VKW_ASSERT(recording_);
 
@@ -593,7 +928,143 @@ class CommandBuffer
 
     // ---------------------------------------------------------------------------------------------
 
-    CommandBuffer& bindComputePipeline(ComputePipeline& pipeline)
+    CommandBuffer& resetQueryPool(
+        const QueryPool& queryPool, const uint32_t firstQuery, const uint32_t queryCount)
+    {
+        VKW_ASSERT(recording_);
+        VKW_ASSERT(firstQuery + queryCount <= queryPool.size());
+
+        device_->vk().vkCmdResetQueryPool(
+            commandBuffer_, queryPool.getHandle(), firstQuery, queryCount);
+        return *this;
+    }
+
+    CommandBuffer& resetQueryPool(const QueryPool& queryPool)
+    {
+        return resetQueryPool(queryPool, 0, queryPool.size());
+    }
+
+    CommandBuffer& writeTimestamp(
+        const QueryPool& queryPool, const uint32_t query, const VkPipelineStageFlagBits stage)
+    {
+        VKW_ASSERT(recording_);
+        VKW_ASSERT(queryPool.type() == VK_QUERY_TYPE_TIMESTAMP);
+
+        device_->vk().vkCmdWriteTimestamp(commandBuffer_, stage, queryPool.getHandle(), query);
+        return *this;
+    }
+
+    // Debug labels, only visible in tools when VKW_DEBUG_UTILS is enabled
+    CommandBuffer& beginLabel(const char* name, const uint32_t color = debug::defaultLabelColor)
+    {
+        VKW_ASSERT(recording_);
+        debug::beginLabel(commandBuffer_, name, color);
+        return *this;
+    }
+
+    CommandBuffer& endLabel()
+    {
+        VKW_ASSERT(recording_);
+        debug::endLabel(commandBuffer_);
+        return *this;
+    }
+
+    CommandBuffer& insertLabel(const char* name, const uint32_t color = debug::defaultLabelColor)
+    {
+        VKW_ASSERT(recording_);
+        debug::insertLabel(commandBuffer_, name, color);
+        return *this;
+    }
+
+    CommandBuffer& beginQuery(
+        const QueryPool& queryPool, const uint32_t query, const VkQueryControlFlags flags = 0)
+    {
+        VKW_ASSERT(recording_);
+        VKW_ASSERT(queryPool.type() != VK_QUERY_TYPE_TIMESTAMP);
+
+        device_->vk().vkCmdBeginQuery(commandBuffer_, queryPool.getHandle(), query, flags);
+        return *this;
+    }
+
+    CommandBuffer& endQuery(const QueryPool& queryPool, const uint32_t query)
+    {
+        VKW_ASSERT(recording_);
+        VKW_ASSERT(queryPool.type() != VK_QUERY_TYPE_TIMESTAMP);
+
+        device_->vk().vkCmdEndQuery(commandBuffer_, queryPool.getHandle(), query);
+        return *this;
+    }
+
+    CommandBuffer& beginOcclusionQuery(
+        const QueryPool& queryPool, const uint32_t query, const bool precise = false)
+    {
+        VKW_ASSERT(queryPool.type() == VK_QUERY_TYPE_OCCLUSION);
+        return beginQuery(queryPool, query, precise ? VK_QUERY_CONTROL_PRECISE_BIT : 0);
+    }
+
+    CommandBuffer& endOcclusionQuery(const QueryPool& queryPool, const uint32_t query)
+    {
+        VKW_ASSERT(queryPool.type() == VK_QUERY_TYPE_OCCLUSION);
+        return endQuery(queryPool, query);
+    }
+
+    template <typename BufferType>
+    CommandBuffer& copyQueryPoolResults(
+        const QueryPool& queryPool,
+        const uint32_t firstQuery,
+        const uint32_t queryCount,
+        BufferType& dstBuffer,
+        const VkDeviceSize dstOffset,
+        const VkDeviceSize stride,
+        const VkQueryResultFlags flags = VK_QUERY_RESULT_WAIT_BIT)
+    {
+        VKW_ASSERT(recording_);
+        VKW_ASSERT(dstBuffer.getUsage() & VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+
+        device_->vk().vkCmdCopyQueryPoolResults(
+            commandBuffer_,
+            queryPool.getHandle(),
+            firstQuery,
+            queryCount,
+            dstBuffer.getHandle(),
+            dstOffset,
+            stride,
+            flags);
+        return *this;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    // Requires VK_EXT_conditional_rendering, the predicate is read as a 32 bits value
+    template <typename BufferType>
+    CommandBuffer& beginConditionalRendering(
+        const BufferType& buffer, const VkDeviceSize offset, const bool inverted = false)
+    {
+        VKW_ASSERT(recording_);
+        VKW_ASSERT(buffer.getUsage() & VK_BUFFER_USAGE_CONDITIONAL_RENDERING_BIT_EXT);
+        VKW_ASSERT((offset % 4) == 0);
+
+        VkConditionalRenderingBeginInfoEXT beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_CONDITIONAL_RENDERING_BEGIN_INFO_EXT;
+        beginInfo.pNext = nullptr;
+        beginInfo.buffer = buffer.getHandle();
+        beginInfo.offset = offset;
+        beginInfo.flags = inverted ? VK_CONDITIONAL_RENDERING_INVERTED_BIT_EXT : 0;
+        device_->vk().vkCmdBeginConditionalRenderingEXT(commandBuffer_, &beginInfo);
+        return *this;
+    }
+
+    CommandBuffer& endConditionalRendering()
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdEndConditionalRenderingEXT(commandBuffer_);
+        return *this;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    CommandBuffer& bindComputePipeline(const ComputePipeline& pipeline)
     {
         VKW_ASSERT(recording_);
 
@@ -624,26 +1095,107 @@ class CommandBuffer
 
     CommandBuffer& bindComputeDescriptorSets(
         const PipelineLayout& pipelineLayout,
-        const uint32_t firstSet,
-        const std::vector<DescriptorSet>& descriptorSets)
+        const uint32_t firstSet,
+        const utils::Span<const DescriptorSet> descriptorSets)
+    {
+        VKW_ASSERT(recording_);
+
+        utils::SmallVector<VkDescriptorSet, 8> descriptorList;
+        for(size_t i = 0; i < descriptorSets.size(); ++i)
+        {
+            descriptorList.push_back(descriptorSets[i].getHandle());
+        }
+        device_->vk().vkCmdBindDescriptorSets(
+            commandBuffer_,
+            VK_PIPELINE_BIND_POINT_COMPUTE,
+            pipelineLayout.getHandle(),
+            firstSet,
+            static_cast<uint32_t>(descriptorList.size()),
+            descriptorList.data(),
+            0,
+            nullptr);
+        return *this;
+    }
+
+    // Requires VK_KHR_push_descriptor, set must use a layout created with
+    // DescriptorSetLayout::setPushDescriptor().
+    CommandBuffer& pushDescriptorSet(
+        const VkPipelineBindPoint bindPoint,
+        const PipelineLayout& pipelineLayout,
+        const uint32_t set,
+        const DescriptorWriteList& writes)
+    {
+        VKW_ASSERT(recording_);
+
+        if(writes.empty())
+        {
+            return *this;
+        }
+
+        device_->vk().vkCmdPushDescriptorSetKHR(
+            commandBuffer_,
+            bindPoint,
+            pipelineLayout.getHandle(),
+            set,
+            writes.size(),
+            writes.data());
+        return *this;
+    }
+
+    CommandBuffer& pushComputeDescriptorSet(
+        const PipelineLayout& pipelineLayout, const uint32_t set, const DescriptorWriteList& writes)
+    {
+        return pushDescriptorSet(VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, set, writes);
+    }
+
+    // Descriptor buffers (VK_EXT_descriptor_buffer), pipelines must be created with
+    // VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT.
+    CommandBuffer& bindDescriptorBuffer(const DescriptorBuffer& descriptorBuffer)
+    {
+        VKW_ASSERT(recording_);
+
+        const auto bindingInfo = descriptorBuffer.bindingInfo();
+        device_->vk().vkCmdBindDescriptorBuffersEXT(commandBuffer_, 1, &bindingInfo);
+        return *this;
+    }
+
+    CommandBuffer& bindDescriptorBuffers(
+        const utils::Span<const VkDescriptorBufferBindingInfoEXT> bindingInfos)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdBindDescriptorBuffersEXT(
+            commandBuffer_, static_cast<uint32_t>(bindingInfos.size()), bindingInfos.data());
+        return *this;
+    }
+
+    CommandBuffer& setDescriptorBufferOffset(
+        const VkPipelineBindPoint bindPoint,
+        const PipelineLayout& pipelineLayout,
+        const uint32_t set,
+        const uint32_t bufferIndex,
+        const VkDeviceSize offset)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdSetDescriptorBufferOffsetsEXT(
+            commandBuffer_, bindPoint, pipelineLayout.getHandle(), set, 1, &bufferIndex, &offset);
+        return *this;
+    }
+
+    CommandBuffer& setComputeDescriptorBufferOffset(
+        const PipelineLayout& pipelineLayout,
+        const uint32_t set,
+        const DescriptorBuffer& descriptorBuffer,
+        const uint32_t descriptorSetId,
+        const uint32_t bufferIndex = 0)
     {
-        VKW_ASSERT(recording_);
-
-        std::vector<VkDescriptorSet> descriptorList;
-        for(size_t i = 0; i < descriptorSets.size(); ++i)
-        {
-            descriptorList.push_back(descriptorSets[i].getHandle());
-        }
-        device_->vk().vkCmdBindDescriptorSets(
-            commandBuffer_,
+        return setDescriptorBufferOffset(
             VK_PIPELINE_BIND_POINT_COMPUTE,
-            pipelineLayout.getHandle(),
-            firstSet,
-            static_cast<uint32_t>(descriptorList.size()),
-            descriptorList.data(),
-            0,
-            nullptr);
-        return *this;
+            pipelineLayout,
+            set,
+            bufferIndex,
+            descriptorBuffer.setOffset(descriptorSetId));
     }
 
     template <typename T>
@@ -682,6 +1234,20 @@ class CommandBuffer
         return *this;
     }
 
+    template <MemoryType memType, VkBufferUsageFlags additionalFlags>
+    CommandBuffer& dispatchIndirect(
+        const Buffer<VkDispatchIndirectCommand, memType, additionalFlags>& buffer,
+        const VkDeviceSize offset = 0)
+    {
+        static_assert(
+            (additionalFlags & VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT) != 0,
+            "Indirect buffer type must include VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT");
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdDispatchIndirect(commandBuffer_, buffer.getHandle(), offset);
+        return *this;
+    }
+
     // ---------------------------------------------------------------------------------------------
 
     CommandBuffer& beginRenderPass(
@@ -701,14 +1267,11 @@ class CommandBuffer
         renderPassInfo.renderArea.offset = offset;
         renderPassInfo.renderArea.extent = extent;
 
-        std::vector<VkClearValue> clearValues;
-        clearValues.push_back(VkClearValue{clearColor});
-        if(renderPass.useDepth())
-        {
-            clearValues.push_back(VkClearValue{{1.0f, 0}});
-        }
-        renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-        renderPassInfo.pClearValues = clearValues.data();
+        VkClearValue clearValues[2] = {};
+        clearValues[0].color = clearColor;
+        clearValues[1].depthStencil = {1.0f, 0};
+        renderPassInfo.clearValueCount = renderPass.useDepth() ? 2 : 1;
+        renderPassInfo.pClearValues = clearValues;
 
         device_->vk().vkCmdBeginRenderPass(
             commandBuffer_, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
@@ -769,7 +1332,7 @@ class CommandBuffer
     }
 
     CommandBuffer& beginRendering(
-        const std::vector<RenderingAttachment>& colorAttachments,
+        const utils::Span<const RenderingAttachment> colorAttachments,
         const VkRect2D renderArea,
         const uint32_t viewMask = 0,
         const uint32_t layerCount = 1,
@@ -777,13 +1340,10 @@ class CommandBuffer
     {
         VKW_ASSERT(recording_);
 
-        std::vector<VkRenderingAttachmentInfo> attachmentInfos;
-        attachmentInfos.resize(colorAttachments.size());
+        utils::SmallVector<VkRenderingAttachmentInfo, 8> attachmentInfos;
         for(const auto& colorAttachment : colorAttachments)
         {
-            attachmentInfos.emplace_back();
-
-            VkRenderingAttachmentInfo& attachmentInfo = attachmentInfos.back();
+            VkRenderingAttachmentInfo& attachmentInfo = attachmentInfos.emplace_back();
             attachmentInfo.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
             attachmentInfo.pNext = nullptr;
             attachmentInfo.imageView = colorAttachment.attachment_;
@@ -858,12 +1418,12 @@ class CommandBuffer
         renderingInfo.pDepthAttachment = &depthAttachmentInfo;
         renderingInfo.pStencilAttachment = nullptr;
 
-        device_->vk().vkCmdBeginRendering(commandBuffer_, nullptr);
+        device_->vk().vkCmdBeginRendering(commandBuffer_, &renderingInfo);
         return *this;
     }
 
     CommandBuffer& beginRendering(
-        const std::vector<RenderingAttachment>& colorAttachments,
+        const utils::Span<const RenderingAttachment> colorAttachments,
         RenderingAttachment& depthStencilAttachment,
         const VkRect2D renderArea,
         const uint32_t viewMask = 0,
@@ -872,13 +1432,10 @@ class CommandBuffer
     {
         VKW_ASSERT(recording_);
 
-        std::vector<VkRenderingAttachmentInfo> attachmentInfos;
-        attachmentInfos.resize(colorAttachments.size());
+        utils::SmallVector<VkRenderingAttachmentInfo, 8> attachmentInfos;
         for(const auto& colorAttachment : colorAttachments)
         {
-            attachmentInfos.emplace_back();
-
-            VkRenderingAttachmentInfo& attachmentInfo = attachmentInfos.back();
+            VkRenderingAttachmentInfo& attachmentInfo = attachmentInfos.emplace_back();
             attachmentInfo.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
             attachmentInfo.pNext = nullptr;
             attachmentInfo.imageView = colorAttachment.attachment_;
@@ -915,7 +1472,7 @@ class CommandBuffer
         renderingInfo.pDepthAttachment = &depthAttachmentInfo;
         renderingInfo.pStencilAttachment = nullptr;
 
-        device_->vk().vkCmdBeginRendering(commandBuffer_, nullptr);
+        device_->vk().vkCmdBeginRendering(commandBuffer_, &renderingInfo);
         return *this;
     }
 
@@ -936,6 +1493,33 @@ class CommandBuffer
         return *this;
     }
 
+    // Binds every stage of the shader object. Unlike pipelines, shader objects carry no state, all
+    // the dynamic states used by the draws must be set, see setVertexInput() and following.
+    CommandBuffer& bindShaders(const ShaderObject& shaderObject)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdBindShadersEXT(
+            commandBuffer_,
+            shaderObject.stageCount(),
+            shaderObject.stages(),
+            shaderObject.shaders());
+        return *this;
+    }
+
+    // Null handles unbind the matching stages
+    CommandBuffer& bindShaders(
+        const utils::Span<const VkShaderStageFlagBits> stages,
+        const utils::Span<const VkShaderEXT> shaders)
+    {
+        VKW_ASSERT(recording_);
+        VKW_ASSERT(stages.size() == shaders.size());
+
+        device_->vk().vkCmdBindShadersEXT(
+            commandBuffer_, static_cast<uint32_t>(stages.size()), stages.data(), shaders.data());
+        return *this;
+    }
+
     CommandBuffer& bindGraphicsDescriptorSet(
         const PipelineLayout& pipelineLayout,
         const uint32_t firstSet,
@@ -959,11 +1543,11 @@ class CommandBuffer
     CommandBuffer& bindGraphicsDescriptorSets(
         const PipelineLayout& pipelineLayout,
         const uint32_t firstSet,
-        const std::vector<DescriptorSet>& descriptorSets)
+        const utils::Span<const DescriptorSet> descriptorSets)
     {
         VKW_ASSERT(recording_);
 
-        std::vector<VkDescriptorSet> descriptorList;
+        utils::SmallVector<VkDescriptorSet, 8> descriptorList;
         for(size_t i = 0; i < descriptorSets.size(); ++i)
         {
             descriptorList.push_back(descriptorSets[i].getHandle());
@@ -980,6 +1564,27 @@ class CommandBuffer
         return *this;
     }
 
+    CommandBuffer& pushGraphicsDescriptorSet(
+        const PipelineLayout& pipelineLayout, const uint32_t set, const DescriptorWriteList& writes)
+    {
+        return pushDescriptorSet(VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, set, writes);
+    }
+
+    CommandBuffer& setGraphicsDescriptorBufferOffset(
+        const PipelineLayout& pipelineLayout,
+        const uint32_t set,
+        const DescriptorBuffer& descriptorBuffer,
+        const uint32_t descriptorSetId,
+        const uint32_t bufferIndex = 0)
+    {
+        return setDescriptorBufferOffset(
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            pipelineLayout,
+            set,
+            bufferIndex,
+            descriptorBuffer.setOffset(descriptorSetId));
+    }
+
     // ---------------------------------------------------------------------------------------------
 
     CommandBuffer& setViewport(
@@ -1012,7 +1617,8 @@ class CommandBuffer
         return *this;
     }
 
-    CommandBuffer& setViewport(const std::vector<VkViewport>& viewports, const uint32_t offset = 0)
+    CommandBuffer& setViewport(
+        const utils::Span<const VkViewport> viewports, const uint32_t offset = 0)
     {
         VKW_ASSERT(recording_);
 
@@ -1042,7 +1648,7 @@ class CommandBuffer
         return *this;
     }
 
-    CommandBuffer& setScissor(const std::vector<VkRect2D>& scissors, const uint32_t offset = 0)
+    CommandBuffer& setScissor(const utils::Span<const VkRect2D> scissors, const uint32_t offset = 0)
     {
         VKW_ASSERT(recording_);
 
@@ -1139,7 +1745,7 @@ class CommandBuffer
         return *this;
     }
 
-    CommandBuffer& setViewportWithCount(const std::vector<VkViewport>& viewports)
+    CommandBuffer& setViewportWithCount(const utils::Span<const VkViewport> viewports)
     {
         VKW_ASSERT(recording_);
 
@@ -1149,7 +1755,7 @@ class CommandBuffer
         return *this;
     }
 
-    CommandBuffer& setScissorWithCount(const std::vector<VkRect2D>& scissors)
+    CommandBuffer& setScissorWithCount(const utils::Span<const VkRect2D> scissors)
     {
         VKW_ASSERT(recording_);
 
@@ -1228,6 +1834,189 @@ class CommandBuffer
         return *this;
     }
 
+    CommandBuffer& setDepthBounds(const float minDepthBounds, const float maxDepthBounds)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdSetDepthBounds(commandBuffer_, minDepthBounds, maxDepthBounds);
+
+        return *this;
+    }
+
+    CommandBuffer& setRasterizerDiscardEnable(const VkBool32 rasterizerDiscardEnable)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdSetRasterizerDiscardEnable(commandBuffer_, rasterizerDiscardEnable);
+
+        return *this;
+    }
+
+    CommandBuffer& setPrimitiveRestartEnable(const VkBool32 primitiveRestartEnable)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdSetPrimitiveRestartEnable(commandBuffer_, primitiveRestartEnable);
+
+        return *this;
+    }
+
+    // States below come from VK_EXT_extended_dynamic_state3 and VK_EXT_vertex_input_dynamic_state,
+    // all of them are available with VK_EXT_shader_object.
+
+    CommandBuffer& setVertexInput(
+        const utils::Span<const VkVertexInputBindingDescription2EXT> bindings,
+        const utils::Span<const VkVertexInputAttributeDescription2EXT> attributes)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdSetVertexInputEXT(
+            commandBuffer_,
+            static_cast<uint32_t>(bindings.size()),
+            bindings.data(),
+            static_cast<uint32_t>(attributes.size()),
+            attributes.data());
+
+        return *this;
+    }
+
+    CommandBuffer& setPolygonMode(const VkPolygonMode polygonMode)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdSetPolygonModeEXT(commandBuffer_, polygonMode);
+
+        return *this;
+    }
+
+    CommandBuffer& setRasterizationSamples(const VkSampleCountFlagBits rasterizationSamples)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdSetRasterizationSamplesEXT(commandBuffer_, rasterizationSamples);
+
+        return *this;
+    }
+
+    // One mask word per 32 samples
+    CommandBuffer& setSampleMask(
+        const VkSampleCountFlagBits samples, const utils::Span<const VkSampleMask> sampleMask)
+    {
+        VKW_ASSERT(recording_);
+        VKW_ASSERT(sampleMask.size() >= (static_cast<size_t>(samples) + 31) / 32);
+
+        device_->vk().vkCmdSetSampleMaskEXT(commandBuffer_, samples, sampleMask.data());
+
+        return *this;
+    }
+
+    CommandBuffer& setAlphaToCoverageEnable(const VkBool32 alphaToCoverageEnable)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdSetAlphaToCoverageEnableEXT(commandBuffer_, alphaToCoverageEnable);
+
+        return *this;
+    }
+
+    CommandBuffer& setAlphaToOneEnable(const VkBool32 alphaToOneEnable)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdSetAlphaToOneEnableEXT(commandBuffer_, alphaToOneEnable);
+
+        return *this;
+    }
+
+    CommandBuffer& setLogicOpEnable(const VkBool32 logicOpEnable)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdSetLogicOpEnableEXT(commandBuffer_, logicOpEnable);
+
+        return *this;
+    }
+
+    CommandBuffer& setLogicOp(const VkLogicOp logicOp)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdSetLogicOpEXT(commandBuffer_, logicOp);
+
+        return *this;
+    }
+
+    CommandBuffer& setColorBlendEnable(
+        const utils::Span<const VkBool32> colorBlendEnables, const uint32_t firstAttachment = 0)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdSetColorBlendEnableEXT(
+            commandBuffer_,
+            firstAttachment,
+            static_cast<uint32_t>(colorBlendEnables.size()),
+            colorBlendEnables.data());
+
+        return *this;
+    }
+
+    CommandBuffer& setColorBlendEquation(
+        const utils::Span<const VkColorBlendEquationEXT> colorBlendEquations,
+        const uint32_t firstAttachment = 0)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdSetColorBlendEquationEXT(
+            commandBuffer_,
+            firstAttachment,
+            static_cast<uint32_t>(colorBlendEquations.size()),
+            colorBlendEquations.data());
+
+        return *this;
+    }
+
+    CommandBuffer& setColorWriteMask(
+        const utils::Span<const VkColorComponentFlags> colorWriteMasks,
+        const uint32_t firstAttachment = 0)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdSetColorWriteMaskEXT(
+            commandBuffer_,
+            firstAttachment,
+            static_cast<uint32_t>(colorWriteMasks.size()),
+            colorWriteMasks.data());
+
+        return *this;
+    }
+
+    CommandBuffer& setDepthClampEnable(const VkBool32 depthClampEnable)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdSetDepthClampEnableEXT(commandBuffer_, depthClampEnable);
+
+        return *this;
+    }
+
+    CommandBuffer& setPatchControlPoints(const uint32_t patchControlPoints)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdSetPatchControlPointsEXT(commandBuffer_, patchControlPoints);
+
+        return *this;
+    }
+
+    CommandBuffer& setTessellationDomainOrigin(const VkTessellationDomainOrigin domainOrigin)
+    {
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdSetTessellationDomainOriginEXT(commandBuffer_, domainOrigin);
+
+        return *this;
+    }
+
     // ---------------------------------------------------------------------------------------------
 
     template <typename BufferType>
@@ -1288,6 +2077,104 @@ class CommandBuffer
         return *this;
     }
 
+    template <MemoryType memType, VkBufferUsageFlags additionalFlags>
+    CommandBuffer& drawIndirect(
+        const Buffer<VkDrawIndirectCommand, memType, additionalFlags>& buffer,
+        const VkDeviceSize offset,
+        const uint32_t drawCount,
+        const uint32_t stride = sizeof(VkDrawIndirectCommand))
+    {
+        static_assert(
+            (additionalFlags & VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT) != 0,
+            "Indirect buffer type must include VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT");
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdDrawIndirect(
+            commandBuffer_, buffer.getHandle(), offset, drawCount, stride);
+        return *this;
+    }
+
+    template <MemoryType memType, VkBufferUsageFlags additionalFlags>
+    CommandBuffer& drawIndexedIndirect(
+        const Buffer<VkDrawIndexedIndirectCommand, memType, additionalFlags>& buffer,
+        const VkDeviceSize offset,
+        const uint32_t drawCount,
+        const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand))
+    {
+        static_assert(
+            (additionalFlags & VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT) != 0,
+            "Indirect buffer type must include VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT");
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdDrawIndexedIndirect(
+            commandBuffer_, buffer.getHandle(), offset, drawCount, stride);
+        return *this;
+    }
+
+    template <
+        MemoryType memType,
+        VkBufferUsageFlags additionalFlags,
+        MemoryType countMemType,
+        VkBufferUsageFlags countAdditionalFlags>
+    CommandBuffer& drawIndirectCount(
+        const Buffer<VkDrawIndirectCommand, memType, additionalFlags>& buffer,
+        const VkDeviceSize offset,
+        const Buffer<uint32_t, countMemType, countAdditionalFlags>& countBuffer,
+        const VkDeviceSize countBufferOffset,
+        const uint32_t maxDrawCount,
+        const uint32_t stride = sizeof(VkDrawIndirectCommand))
+    {
+        static_assert(
+            (additionalFlags & VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT) != 0,
+            "Indirect buffer type must include VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT");
+        static_assert(
+            (countAdditionalFlags & VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT) != 0,
+            "Count buffer type must include VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT");
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdDrawIndirectCount(
+            commandBuffer_,
+            buffer.getHandle(),
+            offset,
+            countBuffer.getHandle(),
+            countBufferOffset,
+            maxDrawCount,
+            stride);
+        return *this;
+    }
+
+    template <
+        MemoryType memType,
+        VkBufferUsageFlags additionalFlags,
+        MemoryType countMemType,
+        VkBufferUsageFlags countAdditionalFlags>
+    CommandBuffer& drawIndexedIndirectCount(
+        const Buffer<VkDrawIndexedIndirectCommand, memType, additionalFlags>& buffer,
+        const VkDeviceSize offset,
+        const Buffer<uint32_t, countMemType, countAdditionalFlags>& countBuffer,
+        const VkDeviceSize countBufferOffset,
+        const uint32_t maxDrawCount,
+        const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand))
+    {
+        static_assert(
+            (additionalFlags & VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT) != 0,
+            "Indirect buffer type must include VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT");
+        static_assert(
+            (countAdditionalFlags & VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT) != 0,
+            "Count buffer type must include VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT");
+        VKW_ASSERT(recording_);
+
+        device_->vk().vkCmdDrawIndexedIndirectCount(
+            commandBuffer_,
+            buffer.getHandle(),
+            offset,
+            countBuffer.getHandle(),
+            countBufferOffset,
+            maxDrawCount,
+            stride);
+        return *this;
+    }
+
     CommandBuffer& drawMeshTasks(
         const uint32_t groupCountX, const uint32_t groupCountY, const uint32_t groupCountZ)
     {
@@ -1410,10 +2297,25 @@ class CommandBuffer
     CommandBuffer& bindComputeProgram(const ComputeProgram& program, const uint32_t descriptorSetId)
     {
         VKW_ASSERT(recording_);
+        VKW_ASSERT(!program.usePushDescriptors());
 
         this->bindComputePipeline(program.computePipeline_);
         this->bindComputeDescriptorSet(
-            program.pipelineLayout_, 0, program.descriptorSets(descriptorSetId));
+            program.pipelineLayout_, 0, program.descriptorSet(descriptorSetId));
+
+        return *this;
+    }
+
+    // Fast path for programs built with push descriptors, no descriptor set is needed.
+    template <typename ComputeProgram>
+    CommandBuffer& bindComputeProgram(
+        const ComputeProgram& program, const DescriptorWriteList& writes)
+    {
+        VKW_ASSERT(recording_);
+        VKW_ASSERT(program.usePushDescriptors());
+
+        this->bindComputePipeline(program.computePipeline_);
+        this->pushComputeDescriptorSet(program.pipelineLayout_, 0, writes);
 
         return *this;
     }
@@ -1434,9 +2336,31 @@ class CommandBuffer
 
     // ---------------------------------------------------------------------------------------------
 
+    CommandBuffer& executeCommands(const CommandBuffer& secondaryCmdBuffer)
+    {
+        VKW_ASSERT(recording_);
+        device_->vk().vkCmdExecuteCommands(commandBuffer_, 1, &secondaryCmdBuffer.commandBuffer_);
+        return *this;
+    }
+
+    CommandBuffer& executeCommands(const utils::Span<const VkCommandBuffer> secondaryCmdBuffers)
+    {
+        VKW_ASSERT(recording_);
+        device_->vk().vkCmdExecuteCommands(
+            commandBuffer_,
+            static_cast<uint32_t>(secondaryCmdBuffers.size()),
+            secondaryCmdBuffers.data());
+        return *this;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
     VkCommandBuffer getHandle() const { return commandBuffer_; }
 
   private:
+    friend class CommandStream;
+    friend class CopyBatcher;
+
     Device* device_{nullptr};
     VkCommandPool cmdPool_{VK_NULL_HANDLE};
     VkCommandBuffer commandBuffer_{VK_NULL_HANDLE};
@@ -24,6 +24,7 @@
 
 #include "vkw/detail/CommandBuffer.hpp"
 #include "vkw/detail/Common.hpp"
+#include "vkw/detail/DebugUtils.hpp"
 #include "vkw/detail/Device.hpp"
 #include "vkw/detail/Instance.hpp"
 #include "vkw/detail/Queue.hpp"
@@ -96,6 +97,15 @@ class CommandPool
 
     bool initialized() const { return initialized_; }
 
+    // Every command buffer allocated from the pool goes back to the initial state
+    bool reset(const VkCommandPoolResetFlags flags = 0)
+    {
+        VKW_ASSERT(this->initialized());
+        VKW_CHECK_VK_RETURN_FALSE(
+            device_->vk().vkResetCommandPool(device_->getHandle(), commandPool_, flags));
+        return true;
+    }
+
     CommandBuffer createCommandBuffer(VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY)
     {
         VKW_ASSERT(this->initialized());
@@ -129,6 +139,12 @@ class CommandPool
     VkCommandPool& getHandle() { return commandPool_; }
     const VkCommandPool& getHandle() const { return commandPool_; }
 
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(this->initialized());
+        debug::setObjectName(device_->getHandle(), VK_OBJECT_TYPE_COMMAND_POOL, commandPool_, name);
+    }
+
   private:
     Device* device_{nullptr};
     VkCommandPool commandPool_{VK_NULL_HANDLE};
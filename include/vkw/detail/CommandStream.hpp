@@ -0,0 +1,639 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "vkw/detail/Buffer.hpp"
+#include "vkw/detail/Common.hpp"
+#include "vkw/detail/ComputePipeline.hpp"
+#include "vkw/detail/DescriptorSet.hpp"
+#include "vkw/detail/GraphicsPipeline.hpp"
+#include "vkw/detail/PipelineLayout.hpp"
+#include "vkw/detail/utils.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace vkw
+{
+class CommandBuffer;
+
+// Records commands as POD packets in a linear arena instead of a VkCommandBuffer. A stream does
+// not reference any device or command pool, so it can be filled on any thread without locking and
+// inspected before being translated into a CommandBuffer by the thread owning the pool. reset()
+// keeps the arena memory, recording does not allocate once the stream has reached its working
+// size.
+// Every dispatch and draw captures the bind state it was recorded with, which lets translate()
+// reorder them by pipeline between two ordering points (barriers and transfer commands), skip
+// binds that would not change the command buffer state and merge consecutive barriers.
+// Only pipelines, descriptor sets, push constants, vertex and index buffers, viewport and scissor
+// are part of the bind state. Shader objects and the other dynamic states (see GraphicsState) are
+// not recorded: draws using them must be recorded directly on a CommandBuffer.
+class CommandStream
+{
+  public:
+    static constexpr uint32_t maxDescriptorSets = 4;
+    static constexpr uint32_t maxPushConstantRanges = 4;
+    static constexpr uint32_t maxVertexBindings = 4;
+
+    struct TranslateOptions
+    {
+        // Dispatches between two ordering points have no ordering guarantees and can be sorted
+        bool sortDispatches{true};
+        // Draws are kept in recording order by default since blending depends on it
+        bool sortDraws{false};
+        bool mergeBarriers{true};
+    };
+
+    struct TranslateStats
+    {
+        uint32_t commandCount{0};
+        uint32_t bindCount{0};
+        uint32_t skippedBindCount{0};
+        uint32_t barrierCount{0};
+        uint32_t mergedBarrierCount{0};
+    };
+
+    CommandStream(const size_t blockSize = defaultBlockSize) : blockSize_{blockSize} {}
+
+    CommandStream(const CommandStream&) = delete;
+    CommandStream(CommandStream&& cp) { *this = std::move(cp); }
+
+    CommandStream& operator=(const CommandStream&) = delete;
+    CommandStream& operator=(CommandStream&& cp)
+    {
+        std::swap(blocks_, cp.blocks_);
+        std::swap(blockSize_, cp.blockSize_);
+        std::swap(blockId_, cp.blockId_);
+        std::swap(blockOffset_, cp.blockOffset_);
+        std::swap(packets_, cp.packets_);
+        std::swap(computeState_, cp.computeState_);
+        std::swap(graphicsState_, cp.graphicsState_);
+        std::swap(computeSnapshot_, cp.computeSnapshot_);
+        std::swap(graphicsSnapshot_, cp.graphicsSnapshot_);
+        std::swap(order_, cp.order_);
+        std::swap(memoryBarriers_, cp.memoryBarriers_);
+        std::swap(bufferMemoryBarriers_, cp.bufferMemoryBarriers_);
+        std::swap(imageMemoryBarriers_, cp.imageMemoryBarriers_);
+        return *this;
+    }
+
+    ~CommandStream() = default;
+
+    // Drops all recorded commands, arena memory is kept for the next recording
+    void reset();
+
+    // Frees the arena memory
+    void clear();
+
+    bool empty() const { return packets_.empty(); }
+    size_t commandCount() const { return packets_.size(); }
+    size_t memoryUsage() const;
+
+    // Must be called on a recording command buffer, outside or inside a render pass depending on
+    // the recorded commands. No bind state is assumed on entry.
+    TranslateStats translate(CommandBuffer& cmdBuffer, const TranslateOptions& options = {});
+
+    // ---------------------------------------------------------------------------------------------
+
+    CommandStream& bindComputePipeline(const ComputePipeline& pipeline)
+    {
+        computeState_.pipeline = pipeline.getHandle();
+        computeSnapshot_ = nullptr;
+        return *this;
+    }
+
+    CommandStream& bindGraphicsPipeline(const GraphicsPipeline& pipeline)
+    {
+        graphicsState_.pipeline = pipeline.getHandle();
+        graphicsSnapshot_ = nullptr;
+        return *this;
+    }
+
+    CommandStream& bindComputeDescriptorSet(
+        const PipelineLayout& pipelineLayout,
+        const uint32_t firstSet,
+        const DescriptorSet& descriptorSet)
+    {
+        bindDescriptorSet(
+            computeState_, pipelineLayout.getHandle(), firstSet, descriptorSet.getHandle());
+        computeSnapshot_ = nullptr;
+        return *this;
+    }
+
+    CommandStream& bindGraphicsDescriptorSet(
+        const PipelineLayout& pipelineLayout,
+        const uint32_t firstSet,
+        const DescriptorSet& descriptorSet)
+    {
+        bindDescriptorSet(
+            graphicsState_, pipelineLayout.getHandle(), firstSet, descriptorSet.getHandle());
+        graphicsSnapshot_ = nullptr;
+        return *this;
+    }
+
+    template <typename T>
+    CommandStream& pushConstants(
+        const PipelineLayout& pipelineLayout, const T& values, const ShaderStage stage)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Push constants must be POD");
+        return pushConstants(
+            pipelineLayout.getHandle(),
+            PipelineLayout::getVkShaderStage(stage),
+            0,
+            static_cast<uint32_t>(sizeof(T)),
+            &values);
+    }
+
+    CommandStream& pushConstants(
+        const VkPipelineLayout pipelineLayout,
+        const VkShaderStageFlags stages,
+        const uint32_t offset,
+        const uint32_t size,
+        const void* values);
+
+    CommandStream& dispatch(uint32_t x, uint32_t y = 1, uint32_t z = 1)
+    {
+        auto* packet = allocPacket<DispatchPacket>(PacketType::Dispatch);
+        packet->state = computeSnapshot();
+        packet->groupCount[0] = x;
+        packet->groupCount[1] = y;
+        packet->groupCount[2] = z;
+        return *this;
+    }
+
+    template <MemoryType memType, VkBufferUsageFlags additionalFlags>
+    CommandStream& dispatchIndirect(
+        const Buffer<VkDispatchIndirectCommand, memType, additionalFlags>& buffer,
+        const VkDeviceSize offset = 0)
+    {
+        static_assert(
+            (additionalFlags & VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT) != 0,
+            "Indirect buffer type must include VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT");
+
+        auto* packet = allocPacket<IndirectPacket>(PacketType::DispatchIndirect);
+        packet->state = computeSnapshot();
+        packet->buffer = buffer.getHandle();
+        packet->offset = offset;
+        packet->drawCount = 1;
+        packet->stride = 0;
+        return *this;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    template <typename BufferType>
+    CommandStream& bindVertexBuffer(
+        const uint32_t binding, const BufferType& buffer, const VkDeviceSize offset)
+    {
+        if(binding >= maxVertexBindings)
+        {
+            utils::Log::Error("vkw", "Vertex binding %u out of command stream range", binding);
+            return *this;
+        }
+        graphicsState_.vertexBuffers[binding] = buffer.getHandle();
+        graphicsState_.vertexOffsets[binding] = offset;
+        graphicsState_.vertexBufferMask |= (1u << binding);
+        graphicsSnapshot_ = nullptr;
+        return *this;
+    }
+
+    template <typename BufferType>
+    CommandStream& bindIndexBuffer(const BufferType& buffer, const VkIndexType indexType)
+    {
+        graphicsState_.indexBuffer = buffer.getHandle();
+        graphicsState_.indexType = indexType;
+        graphicsSnapshot_ = nullptr;
+        return *this;
+    }
+
+    CommandStream& setViewport(
+        const float offX,
+        const float offY,
+        const float width,
+        const float height,
+        const float minDepth = 0.0f,
+        const float maxDepth = 1.0f)
+    {
+        return setViewport(VkViewport{offX, offY, width, height, minDepth, maxDepth});
+    }
+
+    CommandStream& setViewport(const VkViewport& viewport)
+    {
+        graphicsState_.viewport = viewport;
+        graphicsState_.hasViewport = true;
+        graphicsSnapshot_ = nullptr;
+        return *this;
+    }
+
+    CommandStream& setScissor(const VkOffset2D& offset, const VkExtent2D& extent)
+    {
+        return setScissor(VkRect2D{offset, extent});
+    }
+
+    CommandStream& setScissor(const VkRect2D& scissor)
+    {
+        graphicsState_.scissor = scissor;
+        graphicsState_.hasScissor = true;
+        graphicsSnapshot_ = nullptr;
+        return *this;
+    }
+
+    CommandStream& draw(
+        const uint32_t vertexCount,
+        const uint32_t instanceCount,
+        const uint32_t firstVertex,
+        const uint32_t firstInstance)
+    {
+        auto* packet = allocPacket<DrawPacket>(PacketType::Draw);
+        packet->state = graphicsSnapshot();
+        packet->count = vertexCount;
+        packet->instanceCount = instanceCount;
+        packet->first = firstVertex;
+        packet->vertexOffset = 0;
+        packet->firstInstance = firstInstance;
+        return *this;
+    }
+
+    CommandStream& drawIndexed(
+        const uint32_t indexCount,
+        const uint32_t instanceCount,
+        const uint32_t firstIndex,
+        const uint32_t vertexOffset,
+        const uint32_t firstInstance)
+    {
+        auto* packet = allocPacket<DrawPacket>(PacketType::DrawIndexed);
+        packet->state = graphicsSnapshot();
+        packet->count = indexCount;
+        packet->instanceCount = instanceCount;
+        packet->first = firstIndex;
+        packet->vertexOffset = static_cast<int32_t>(vertexOffset);
+        packet->firstInstance = firstInstance;
+        return *this;
+    }
+
+    template <MemoryType memType, VkBufferUsageFlags additionalFlags>
+    CommandStream& drawIndirect(
+        const Buffer<VkDrawIndirectCommand, memType, additionalFlags>& buffer,
+        const VkDeviceSize offset,
+        const uint32_t drawCount,
+        const uint32_t stride = sizeof(VkDrawIndirectCommand))
+    {
+        static_assert(
+            (additionalFlags & VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT) != 0,
+            "Indirect buffer type must include VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT");
+
+        auto* packet = allocPacket<IndirectPacket>(PacketType::DrawIndirect);
+        packet->state = graphicsSnapshot();
+        packet->buffer = buffer.getHandle();
+        packet->offset = offset;
+        packet->drawCount = drawCount;
+        packet->stride = stride;
+        return *this;
+    }
+
+    template <MemoryType memType, VkBufferUsageFlags additionalFlags>
+    CommandStream& drawIndexedIndirect(
+        const Buffer<VkDrawIndexedIndirectCommand, memType, additionalFlags>& buffer,
+        const VkDeviceSize offset,
+        const uint32_t drawCount,
+        const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand))
+    {
+        static_assert(
+            (additionalFlags & VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT) != 0,
+            "Indirect buffer type must include VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT");
+
+        auto* packet = allocPacket<IndirectPacket>(PacketType::DrawIndexedIndirect);
+        packet->state = graphicsSnapshot();
+        packet->buffer = buffer.getHandle();
+        packet->offset = offset;
+        packet->drawCount = drawCount;
+        packet->stride = stride;
+        return *this;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    template <typename SrcBufferType, typename DstBufferType>
+    CommandStream& copyBuffer(SrcBufferType& src, DstBufferType& dst)
+    {
+        VkBufferCopy region{};
+        region.srcOffset = 0;
+        region.dstOffset = 0;
+        region.size = src.sizeBytes();
+        return copyBuffer(src.getHandle(), dst.getHandle(), &region, 1);
+    }
+
+    template <typename SrcBufferType, typename DstBufferType, typename ArrayType>
+    CommandStream& copyBuffer(SrcBufferType& src, DstBufferType& dst, ArrayType& regions)
+    {
+        return copyBuffer(
+            src.getHandle(),
+            dst.getHandle(),
+            reinterpret_cast<const VkBufferCopy*>(regions.data()),
+            static_cast<uint32_t>(regions.size()));
+    }
+
+    CommandStream& copyBuffer(
+        const VkBuffer src,
+        const VkBuffer dst,
+        const VkBufferCopy* regions,
+        const uint32_t regionCount);
+
+    template <typename BufferType, typename T>
+    CommandStream& fillBuffer(BufferType& buffer, T val, const size_t offset, const size_t size)
+    {
+        static_assert(sizeof(T) == sizeof(uint32_t), "Fill value must be 32 bits wide");
+
+        auto* packet = allocPacket<FillBufferPacket>(PacketType::FillBuffer);
+        packet->buffer = buffer.getHandle();
+        packet->offset = static_cast<VkDeviceSize>(offset * sizeof(T));
+        packet->size = static_cast<VkDeviceSize>(size);
+        std::memcpy(&packet->data, &val, sizeof(uint32_t));
+        return *this;
+    }
+
+    template <typename SrcBufferType, typename DstImageType>
+    CommandStream& copyBufferToImage(
+        SrcBufferType& buffer,
+        DstImageType& image,
+        VkImageLayout dstLayout,
+        VkBufferImageCopy region)
+    {
+        auto* packet = allocPacket<CopyBufferToImagePacket>(PacketType::CopyBufferToImage);
+        packet->buffer = buffer.getHandle();
+        packet->image = image.getHandle();
+        packet->layout = dstLayout;
+        packet->region = region;
+        return *this;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    CommandStream& memoryBarrier(
+        VkPipelineStageFlags srcFlags,
+        VkPipelineStageFlags dstFlags,
+        const VkMemoryBarrier& barrier)
+    {
+        return pipelineBarrier(srcFlags, dstFlags, &barrier, 1, nullptr, 0, nullptr, 0);
+    }
+
+    CommandStream& bufferMemoryBarrier(
+        VkPipelineStageFlags srcFlags,
+        VkPipelineStageFlags dstFlags,
+        const VkBufferMemoryBarrier& barrier)
+    {
+        return pipelineBarrier(srcFlags, dstFlags, nullptr, 0, &barrier, 1, nullptr, 0);
+    }
+
+    CommandStream& imageMemoryBarrier(
+        VkPipelineStageFlags srcFlags,
+        VkPipelineStageFlags dstFlags,
+        const VkImageMemoryBarrier& barrier)
+    {
+        return pipelineBarrier(srcFlags, dstFlags, nullptr, 0, nullptr, 0, &barrier, 1);
+    }
+
+    template <
+        typename MemoryBarrierList,
+        typename BufferMemoryBarrierList,
+        typename ImageMemoryBarrierList>
+    CommandStream& pipelineBarrier(
+        const VkPipelineStageFlags srcFlags,
+        const VkPipelineStageFlags dstFlags,
+        const MemoryBarrierList& memoryBarriers,
+        const BufferMemoryBarrierList& bufferMemoryBarriers,
+        const ImageMemoryBarrierList& imageMemoryBarriers)
+    {
+        return pipelineBarrier(
+            srcFlags,
+            dstFlags,
+            reinterpret_cast<const VkMemoryBarrier*>(memoryBarriers.data()),
+            static_cast<uint32_t>(memoryBarriers.size()),
+            reinterpret_cast<const VkBufferMemoryBarrier*>(bufferMemoryBarriers.data()),
+            static_cast<uint32_t>(bufferMemoryBarriers.size()),
+            reinterpret_cast<const VkImageMemoryBarrier*>(imageMemoryBarriers.data()),
+            static_cast<uint32_t>(imageMemoryBarriers.size()));
+    }
+
+    CommandStream& pipelineBarrier(
+        const VkPipelineStageFlags srcFlags,
+        const VkPipelineStageFlags dstFlags,
+        const VkMemoryBarrier* memoryBarriers,
+        const uint32_t memoryBarrierCount,
+        const VkBufferMemoryBarrier* bufferMemoryBarriers,
+        const uint32_t bufferMemoryBarrierCount,
+        const VkImageMemoryBarrier* imageMemoryBarriers,
+        const uint32_t imageMemoryBarrierCount);
+
+  private:
+    class Translator;
+
+    static constexpr size_t defaultBlockSize = 64 * 1024;
+    static constexpr size_t packetAlignment = 8;
+
+    // Dispatches and draws must stay first, translate() relies on it
+    enum class PacketType : uint32_t
+    {
+        Dispatch,
+        DispatchIndirect,
+        Draw,
+        DrawIndexed,
+        DrawIndirect,
+        DrawIndexedIndirect,
+        CopyBuffer,
+        FillBuffer,
+        CopyBufferToImage,
+        PipelineBarrier
+    };
+
+    struct PacketHeader
+    {
+        PacketType type;
+    };
+
+    struct PushConstantsPacket
+    {
+        VkPipelineLayout layout;
+        VkShaderStageFlags stages;
+        uint32_t offset;
+        uint32_t size;
+        // Followed by size bytes of data
+    };
+
+    // Bind state captured by dispatches and draws
+    struct BindState
+    {
+        VkPipeline pipeline{VK_NULL_HANDLE};
+        VkPipelineLayout layout{VK_NULL_HANDLE};
+        VkDescriptorSet descriptorSets[maxDescriptorSets]{};
+        uint32_t descriptorSetMask{0};
+        const PushConstantsPacket* pushConstants[maxPushConstantRanges]{};
+        uint32_t pushConstantCount{0};
+
+        VkBuffer vertexBuffers[maxVertexBindings]{};
+        VkDeviceSize vertexOffsets[maxVertexBindings]{};
+        uint32_t vertexBufferMask{0};
+        VkBuffer indexBuffer{VK_NULL_HANDLE};
+        VkIndexType indexType{VK_INDEX_TYPE_UINT32};
+        VkViewport viewport{};
+        VkRect2D scissor{};
+        bool hasViewport{false};
+        bool hasScissor{false};
+    };
+
+    struct DispatchPacket
+    {
+        PacketHeader header;
+        const BindState* state;
+        uint32_t groupCount[3];
+    };
+
+    struct DrawPacket
+    {
+        PacketHeader header;
+        const BindState* state;
+        uint32_t count;
+        uint32_t instanceCount;
+        uint32_t first;
+        int32_t vertexOffset;
+        uint32_t firstInstance;
+    };
+
+    struct IndirectPacket
+    {
+        PacketHeader header;
+        const BindState* state;
+        VkBuffer buffer;
+        VkDeviceSize offset;
+        uint32_t drawCount;
+        uint32_t stride;
+    };
+
+    struct CopyBufferPacket
+    {
+        PacketHeader header;
+        VkBuffer src;
+        VkBuffer dst;
+        uint32_t regionCount;
+        // Followed by regionCount VkBufferCopy
+    };
+
+    struct FillBufferPacket
+    {
+        PacketHeader header;
+        VkBuffer buffer;
+        VkDeviceSize offset;
+        VkDeviceSize size;
+        uint32_t data;
+    };
+
+    struct CopyBufferToImagePacket
+    {
+        PacketHeader header;
+        VkBuffer buffer;
+        VkImage image;
+        VkImageLayout layout;
+        VkBufferImageCopy region;
+    };
+
+    struct PipelineBarrierPacket
+    {
+        PacketHeader header;
+        VkPipelineStageFlags srcFlags;
+        VkPipelineStageFlags dstFlags;
+        uint32_t memoryBarrierCount;
+        uint32_t bufferMemoryBarrierCount;
+        uint32_t imageMemoryBarrierCount;
+        // Followed by the memory, buffer and image barriers, in that order
+    };
+
+    struct Block
+    {
+        std::unique_ptr<uint8_t[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks_{};
+    size_t blockSize_{defaultBlockSize};
+    size_t blockId_{0};
+    size_t blockOffset_{0};
+
+    std::vector<const PacketHeader*> packets_{};
+
+    BindState computeState_{};
+    BindState graphicsState_{};
+    const BindState* computeSnapshot_{nullptr};
+    const BindState* graphicsSnapshot_{nullptr};
+
+    // Translation scratch memory, kept between frames
+    std::vector<uint32_t> order_{};
+    std::vector<VkMemoryBarrier> memoryBarriers_{};
+    std::vector<VkBufferMemoryBarrier> bufferMemoryBarriers_{};
+    std::vector<VkImageMemoryBarrier> imageMemoryBarriers_{};
+
+    void* allocate(const size_t size);
+
+    template <typename T>
+    T* allocPacket(const PacketType type, const size_t extraSize = 0)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "Packets must be POD");
+        auto* packet = reinterpret_cast<T*>(allocate(sizeof(T) + extraSize));
+        packet->header.type = type;
+        packets_.push_back(&packet->header);
+        return packet;
+    }
+
+    static void bindDescriptorSet(
+        BindState& state,
+        const VkPipelineLayout layout,
+        const uint32_t firstSet,
+        const VkDescriptorSet descriptorSet);
+
+    const BindState* snapshot(const BindState& state);
+    const BindState* computeSnapshot()
+    {
+        if(computeSnapshot_ == nullptr)
+        {
+            computeSnapshot_ = snapshot(computeState_);
+        }
+        return computeSnapshot_;
+    }
+    const BindState* graphicsSnapshot()
+    {
+        if(graphicsSnapshot_ == nullptr)
+        {
+            graphicsSnapshot_ = snapshot(graphicsState_);
+        }
+        return graphicsSnapshot_;
+    }
+
+    template <typename T>
+    static const T* trailingData(const void* packet, const size_t offset)
+    {
+        return reinterpret_cast<const T*>(reinterpret_cast<const uint8_t*>(packet) + offset);
+    }
+};
+} // namespace vkw
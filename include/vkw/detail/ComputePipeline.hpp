@@ -24,6 +24,7 @@
 
 #include "vkw/detail/Buffer.hpp"
 #include "vkw/detail/Common.hpp"
+#include "vkw/detail/DebugUtils.hpp"
 #include "vkw/detail/DescriptorPool.hpp"
 #include "vkw/detail/Device.hpp"
 #include "vkw/detail/Instance.hpp"
@@ -55,7 +56,7 @@ class ComputePipeline
 
     bool initialized() const { return initialized_; }
 
-    bool createPipeline(PipelineLayout& pipelineLayout);
+    bool createPipeline(PipelineLayout& pipelineLayout, const VkPipelineCreateFlags flags = 0);
 
     template <typename T>
     ComputePipeline& addSpec(const T value)
@@ -81,11 +82,21 @@ class ComputePipeline
     VkPipeline& getHandle() { return pipeline_; }
     const VkPipeline& getHandle() const { return pipeline_; }
 
+    // Changes each time the pipeline is created, 0 before
+    uint64_t generation() const { return generation_; }
+
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(this->initialized());
+        debug::setObjectName(device_->getHandle(), VK_OBJECT_TYPE_PIPELINE, pipeline_, name);
+    }
+
   private:
     Device* device_{nullptr};
     std::string shaderSource_{};
     VkPipeline pipeline_{VK_NULL_HANDLE};
 
+    uint64_t generation_{0};
     bool initialized_{false};
 
     std::vector<char> specData_{};
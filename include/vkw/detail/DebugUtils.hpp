@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include "vkw/detail/Common.hpp"
+
+#include <cstdint>
+#include <type_traits>
+
+// Object names and labels of VK_EXT_debug_utils, shown by validation layers and GPU debuggers.
+// Enabled by default in debug builds, or with VKW_DEBUG_UTILS=1. When disabled every function
+// below is an empty inline function. The extension must also be enabled on the instance, calls
+// are ignored otherwise.
+#ifndef VKW_DEBUG_UTILS
+#    ifdef DEBUG
+#        define VKW_DEBUG_UTILS 1
+#    else
+#        define VKW_DEBUG_UTILS 0
+#    endif
+#endif
+
+namespace vkw
+{
+namespace debug
+{
+    // Label colors are packed as 0xRRGGBBAA
+    static constexpr uint32_t defaultLabelColor = 0xffffffff;
+
+#if VKW_DEBUG_UTILS
+    template <typename H>
+    inline uint64_t handleValue(const H handle)
+    {
+        if constexpr(std::is_pointer<H>::value)
+        {
+            return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(handle));
+        }
+        else
+        {
+            return static_cast<uint64_t>(handle);
+        }
+    }
+
+    inline VkDebugUtilsLabelEXT makeLabel(const char* name, const uint32_t color)
+    {
+        VkDebugUtilsLabelEXT label = {};
+        label.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+        label.pNext = nullptr;
+        label.pLabelName = name;
+        label.color[0] = float((color >> 24) & 0xff) / 255.0f;
+        label.color[1] = float((color >> 16) & 0xff) / 255.0f;
+        label.color[2] = float((color >> 8) & 0xff) / 255.0f;
+        label.color[3] = float(color & 0xff) / 255.0f;
+        return label;
+    }
+
+    template <typename H>
+    inline void setObjectName(
+        const VkDevice device, const VkObjectType type, const H handle, const char* name)
+    {
+        if(vkSetDebugUtilsObjectNameEXT == nullptr || name == nullptr)
+        {
+            return;
+        }
+
+        VkDebugUtilsObjectNameInfoEXT nameInfo = {};
+        nameInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
+        nameInfo.pNext = nullptr;
+        nameInfo.objectType = type;
+        nameInfo.objectHandle = handleValue(handle);
+        nameInfo.pObjectName = name;
+        vkSetDebugUtilsObjectNameEXT(device, &nameInfo);
+    }
+
+    inline void beginLabel(
+        const VkCommandBuffer cmdBuffer,
+        const char* name,
+        const uint32_t color = defaultLabelColor)
+    {
+        if(vkCmdBeginDebugUtilsLabelEXT != nullptr)
+        {
+            const auto label = makeLabel(name, color);
+            vkCmdBeginDebugUtilsLabelEXT(cmdBuffer, &label);
+        }
+    }
+
+    inline void endLabel(const VkCommandBuffer cmdBuffer)
+    {
+        if(vkCmdEndDebugUtilsLabelEXT != nullptr)
+        {
+            vkCmdEndDebugUtilsLabelEXT(cmdBuffer);
+        }
+    }
+
+    inline void insertLabel(
+        const VkCommandBuffer cmdBuffer,
+        const char* name,
+        const uint32_t color = defaultLabelColor)
+    {
+        if(vkCmdInsertDebugUtilsLabelEXT != nullptr)
+        {
+            const auto label = makeLabel(name, color);
+            vkCmdInsertDebugUtilsLabelEXT(cmdBuffer, &label);
+        }
+    }
+
+    inline void beginLabel(
+        const VkQueue queue, const char* name, const uint32_t color = defaultLabelColor)
+    {
+        if(vkQueueBeginDebugUtilsLabelEXT != nullptr)
+        {
+            const auto label = makeLabel(name, color);
+            vkQueueBeginDebugUtilsLabelEXT(queue, &label);
+        }
+    }
+
+    inline void endLabel(const VkQueue queue)
+    {
+        if(vkQueueEndDebugUtilsLabelEXT != nullptr)
+        {
+            vkQueueEndDebugUtilsLabelEXT(queue);
+        }
+    }
+
+    inline void insertLabel(
+        const VkQueue queue, const char* name, const uint32_t color = defaultLabelColor)
+    {
+        if(vkQueueInsertDebugUtilsLabelEXT != nullptr)
+        {
+            const auto label = makeLabel(name, color);
+            vkQueueInsertDebugUtilsLabelEXT(queue, &label);
+        }
+    }
+#else
+    template <typename H>
+    inline void setObjectName(const VkDevice, const VkObjectType, const H, const char*)
+    {}
+
+    inline void beginLabel(const VkCommandBuffer, const char*, const uint32_t = defaultLabelColor)
+    {}
+    inline void endLabel(const VkCommandBuffer) {}
+    inline void insertLabel(const VkCommandBuffer, const char*, const uint32_t = defaultLabelColor)
+    {}
+
+    inline void beginLabel(const VkQueue, const char*, const uint32_t = defaultLabelColor) {}
+    inline void endLabel(const VkQueue) {}
+    inline void insertLabel(const VkQueue, const char*, const uint32_t = defaultLabelColor) {}
+#endif
+} // namespace debug
+} // namespace vkw
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include "vkw/detail/Buffer.hpp"
+#include "vkw/detail/Common.hpp"
+#include "vkw/detail/DebugUtils.hpp"
+#include "vkw/detail/DescriptorSetLayout.hpp"
+#include "vkw/detail/Device.hpp"
+#include "vkw/detail/ImageView.hpp"
+#include "vkw/detail/Sampler.hpp"
+#include "vkw/detail/TopLevelAccelerationStructure.hpp"
+#include "vkw/detail/utils.hpp"
+
+#include <vector>
+
+namespace vkw
+{
+// Descriptor sets stored in a host mapped buffer (VK_EXT_descriptor_buffer). Every set is a slice
+// of the buffer: writing a descriptor copies it into the slice and binding a set only changes an
+// offset, there is no pool to allocate from.
+class DescriptorBuffer
+{
+  public:
+    DescriptorBuffer() {}
+    DescriptorBuffer(Device& device, const DescriptorSetLayout& layout, const uint32_t setCount);
+
+    DescriptorBuffer(const DescriptorBuffer&) = delete;
+    DescriptorBuffer(DescriptorBuffer&& rhs) { *this = std::move(rhs); }
+
+    DescriptorBuffer& operator=(const DescriptorBuffer&) = delete;
+    DescriptorBuffer& operator=(DescriptorBuffer&& rhs);
+
+    ~DescriptorBuffer() { this->clear(); }
+
+    // The layout must have been created with DescriptorSetLayout::setDescriptorBuffer()
+    bool init(Device& device, const DescriptorSetLayout& layout, const uint32_t setCount);
+
+    void clear();
+
+    bool initialized() const { return initialized_; }
+
+    DescriptorBuffer& bindSampler(
+        const uint32_t descriptorSetId, const uint32_t binding, const Sampler& sampler)
+    {
+        return bindSampler(descriptorSetId, binding, sampler.getHandle());
+    }
+
+    DescriptorBuffer& bindCombinedImageSampler(
+        const uint32_t descriptorSetId,
+        const uint32_t binding,
+        const Sampler& sampler,
+        const ImageView& imageView,
+        const VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL)
+    {
+        return bindCombinedImageSampler(
+            descriptorSetId, binding, sampler.getHandle(), imageView.getHandle(), layout);
+    }
+
+    DescriptorBuffer& bindSampledImage(
+        const uint32_t descriptorSetId,
+        const uint32_t binding,
+        const ImageView& imageView,
+        const VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL)
+    {
+        return bindSampledImage(descriptorSetId, binding, imageView.getHandle(), layout);
+    }
+
+    DescriptorBuffer& bindStorageImage(
+        const uint32_t descriptorSetId,
+        const uint32_t binding,
+        const ImageView& imageView,
+        const VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL)
+    {
+        return bindStorageImage(descriptorSetId, binding, imageView.getHandle(), layout);
+    }
+
+    // Buffers must be created with VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT
+    template <typename BufferType>
+    DescriptorBuffer& bindUniformBuffer(
+        const uint32_t descriptorSetId,
+        const uint32_t binding,
+        const BufferType& buffer,
+        const VkDeviceSize offset = 0,
+        const VkDeviceSize range = VK_WHOLE_SIZE)
+    {
+        using T = typename BufferType::value_type;
+        const auto count = (range == VK_WHOLE_SIZE) ? buffer.size() - offset : range;
+        return bindUniformBuffer(
+            descriptorSetId,
+            binding,
+            buffer.deviceAddress() + offset * sizeof(T),
+            count * sizeof(T));
+    }
+
+    template <typename BufferType>
+    DescriptorBuffer& bindStorageBuffer(
+        const uint32_t descriptorSetId,
+        const uint32_t binding,
+        const BufferType& buffer,
+        const VkDeviceSize offset = 0,
+        const VkDeviceSize range = VK_WHOLE_SIZE)
+    {
+        using T = typename BufferType::value_type;
+        const auto count = (range == VK_WHOLE_SIZE) ? buffer.size() - offset : range;
+        return bindStorageBuffer(
+            descriptorSetId,
+            binding,
+            buffer.deviceAddress() + offset * sizeof(T),
+            count * sizeof(T));
+    }
+
+    DescriptorBuffer& bindAccelerationStructure(
+        const uint32_t descriptorSetId,
+        const uint32_t binding,
+        const TopLevelAccelerationStructure& tlas)
+    {
+        return bindAccelerationStructure(descriptorSetId, binding, tlas.getDeviceAddress());
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    DescriptorBuffer& bindSampler(
+        const uint32_t descriptorSetId, const uint32_t binding, const VkSampler sampler);
+
+    DescriptorBuffer& bindCombinedImageSampler(
+        const uint32_t descriptorSetId,
+        const uint32_t binding,
+        const VkSampler sampler,
+        const VkImageView imageView,
+        const VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL);
+
+    DescriptorBuffer& bindSampledImage(
+        const uint32_t descriptorSetId,
+        const uint32_t binding,
+        const VkImageView imageView,
+        const VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL);
+
+    DescriptorBuffer& bindStorageImage(
+        const uint32_t descriptorSetId,
+        const uint32_t binding,
+        const VkImageView imageView,
+        const VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL);
+
+    DescriptorBuffer& bindUniformTexelBuffer(
+        const uint32_t descriptorSetId,
+        const uint32_t binding,
+        const VkDeviceAddress address,
+        const VkDeviceSize range,
+        const VkFormat format);
+
+    DescriptorBuffer& bindStorageTexelBuffer(
+        const uint32_t descriptorSetId,
+        const uint32_t binding,
+        const VkDeviceAddress address,
+        const VkDeviceSize range,
+        const VkFormat format);
+
+    DescriptorBuffer& bindUniformBuffer(
+        const uint32_t descriptorSetId,
+        const uint32_t binding,
+        const VkDeviceAddress address,
+        const VkDeviceSize range);
+
+    DescriptorBuffer& bindStorageBuffer(
+        const uint32_t descriptorSetId,
+        const uint32_t binding,
+        const VkDeviceAddress address,
+        const VkDeviceSize range);
+
+    DescriptorBuffer& bindAccelerationStructure(
+        const uint32_t descriptorSetId, const uint32_t binding, const VkDeviceAddress address);
+
+    uint32_t setCount() const { return setCount_; }
+
+    // Distance between two consecutive sets, aligned on descriptorBufferOffsetAlignment
+    VkDeviceSize setStride() const { return setStride_; }
+    VkDeviceSize setOffset(const uint32_t descriptorSetId) const
+    {
+        VKW_ASSERT(descriptorSetId < setCount_);
+        return static_cast<VkDeviceSize>(descriptorSetId) * setStride_;
+    }
+
+    VkBuffer getHandle() const { return buffer_.getHandle(); }
+
+    void setName(const char* name) const { buffer_.setName(name); }
+    VkBufferUsageFlags usage() const { return usage_; }
+    VkDeviceAddress deviceAddress() const { return buffer_.deviceAddress(); }
+
+    VkDescriptorBufferBindingInfoEXT bindingInfo() const
+    {
+        VkDescriptorBufferBindingInfoEXT ret = {};
+        ret.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT;
+        ret.pNext = nullptr;
+        ret.address = buffer_.deviceAddress();
+        ret.usage = usage_;
+        return ret;
+    }
+
+    const auto& properties() const { return properties_; }
+
+  private:
+    using StorageBuffer
+        = Buffer<uint8_t, MemoryType::HostStaging, VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT>;
+
+    Device* device_{nullptr};
+    StorageBuffer buffer_{};
+
+    VkPhysicalDeviceDescriptorBufferPropertiesEXT properties_{};
+    VkBufferUsageFlags usage_{0};
+
+    // Indexed by binding number, VK_DESCRIPTOR_TYPE_MAX_ENUM for unused bindings
+    std::vector<VkDeviceSize> bindingOffsets_{};
+    std::vector<VkDescriptorType> bindingTypes_{};
+
+    VkDeviceSize setStride_{0};
+    uint32_t setCount_{0};
+
+    bool initialized_{false};
+
+    DescriptorBuffer& writeDescriptor(
+        const uint32_t descriptorSetId, const uint32_t binding, const VkDescriptorGetInfoEXT& info);
+
+    size_t descriptorSize(const VkDescriptorType type) const;
+};
+} // namespace vkw
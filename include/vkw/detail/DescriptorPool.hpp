@@ -23,6 +23,7 @@
 #pragma once
 
 #include "vkw/detail/Common.hpp"
+#include "vkw/detail/DebugUtils.hpp"
 #include "vkw/detail/DescriptorSetLayout.hpp"
 #include "vkw/detail/Device.hpp"
 
@@ -58,6 +59,13 @@ class DescriptorPool
 
     auto getHandle() const { return descriptorPool_; }
 
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(this->initialized());
+        debug::setObjectName(
+            device_->getHandle(), VK_OBJECT_TYPE_DESCRIPTOR_POOL, descriptorPool_, name);
+    }
+
   private:
     Device* device_{nullptr};
     std::vector<VkDescriptorSet> descriptorSets_{};
@@ -25,6 +25,7 @@
 #include "vkw/detail/Buffer.hpp"
 #include "vkw/detail/BufferView.hpp"
 #include "vkw/detail/Common.hpp"
+#include "vkw/detail/DebugUtils.hpp"
 #include "vkw/detail/DescriptorPool.hpp"
 #include "vkw/detail/DescriptorSetLayout.hpp"
 #include "vkw/detail/Device.hpp"
@@ -208,12 +209,289 @@ class DescriptorSet
 
     VkDescriptorSet getHandle() const { return descriptorSet_; }
 
+    // Changes each time the set is allocated again or its descriptors are written, 0 when not
+    // initialized
+    uint64_t generation() const { return generation_; }
+
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(this->initialized());
+        debug::setObjectName(
+            device_->getHandle(), VK_OBJECT_TYPE_DESCRIPTOR_SET, descriptorSet_, name);
+    }
+
   private:
     Device* device_{nullptr};
     DescriptorPool* descriptorPool_{nullptr};
 
     VkDescriptorSet descriptorSet_{VK_NULL_HANDLE};
 
+    uint64_t generation_{0};
     bool initialized_{false};
 };
+
+// Small fixed-size list of descriptor writes, consumed by CommandBuffer::pushDescriptorSet().
+// Writes point into the list itself so it is neither copyable nor movable, build it on the stack
+// right before recording.
+class DescriptorWriteList
+{
+  public:
+    static constexpr uint32_t maxWriteCount = 16;
+
+    DescriptorWriteList() {}
+
+    DescriptorWriteList(const DescriptorWriteList&) = delete;
+    DescriptorWriteList(DescriptorWriteList&&) = delete;
+
+    DescriptorWriteList& operator=(const DescriptorWriteList&) = delete;
+    DescriptorWriteList& operator=(DescriptorWriteList&&) = delete;
+
+    DescriptorWriteList& bindSampler(const uint32_t binding, const Sampler& sampler)
+    {
+        return bindSampler(binding, sampler.getHandle());
+    }
+
+    DescriptorWriteList& bindCombinedImageSampler(
+        const uint32_t binding,
+        const Sampler& sampler,
+        const ImageView& imageView,
+        const VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL)
+    {
+        return bindCombinedImageSampler(
+            binding, sampler.getHandle(), imageView.getHandle(), layout);
+    }
+
+    DescriptorWriteList& bindSampledImage(
+        const uint32_t binding,
+        const ImageView& imageView,
+        const VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL)
+    {
+        return bindSampledImage(binding, imageView.getHandle(), layout);
+    }
+
+    DescriptorWriteList& bindStorageImage(
+        const uint32_t binding,
+        const ImageView& imageView,
+        const VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL)
+    {
+        return bindStorageImage(binding, imageView.getHandle(), layout);
+    }
+
+    DescriptorWriteList& bindUniformTexelBuffer(
+        const uint32_t binding, const BufferView& bufferView)
+    {
+        return bindUniformTexelBuffer(binding, bufferView.getHandle());
+    }
+
+    DescriptorWriteList& bindStorageTexelBuffer(
+        const uint32_t binding, const BufferView& bufferView)
+    {
+        return bindStorageTexelBuffer(binding, bufferView.getHandle());
+    }
+
+    template <typename BufferType>
+    DescriptorWriteList& bindUniformBuffer(
+        const uint32_t binding,
+        const BufferType& buffer,
+        const VkDeviceSize offset = 0,
+        const VkDeviceSize range = VK_WHOLE_SIZE)
+    {
+        using T = typename BufferType::value_type;
+        const auto bufferRange = (range == VK_WHOLE_SIZE) ? VK_WHOLE_SIZE : range * sizeof(T);
+        return bindUniformBuffer(binding, buffer.getHandle(), offset * sizeof(T), bufferRange);
+    }
+
+    template <typename BufferType>
+    DescriptorWriteList& bindStorageBuffer(
+        const uint32_t binding,
+        const BufferType& buffer,
+        const VkDeviceSize offset = 0,
+        const VkDeviceSize range = VK_WHOLE_SIZE)
+    {
+        using T = typename BufferType::value_type;
+        const auto bufferRange = (range == VK_WHOLE_SIZE) ? VK_WHOLE_SIZE : range * sizeof(T);
+        return bindStorageBuffer(binding, buffer.getHandle(), offset * sizeof(T), bufferRange);
+    }
+
+    DescriptorWriteList& bindAccelerationStructure(
+        const uint32_t binding, const TopLevelAccelerationStructure& tlas)
+    {
+        return bindAccelerationStructure(binding, tlas.getHandle());
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    DescriptorWriteList& bindSampler(const uint32_t binding, const VkSampler sampler)
+    {
+        VkDescriptorImageInfo info = {};
+        info.sampler = sampler;
+        return addImageWrite(binding, VK_DESCRIPTOR_TYPE_SAMPLER, info);
+    }
+
+    DescriptorWriteList& bindCombinedImageSampler(
+        const uint32_t binding,
+        const VkSampler sampler,
+        const VkImageView imageView,
+        const VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL)
+    {
+        VkDescriptorImageInfo info = {};
+        info.sampler = sampler;
+        info.imageView = imageView;
+        info.imageLayout = layout;
+        return addImageWrite(binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, info);
+    }
+
+    DescriptorWriteList& bindSampledImage(
+        const uint32_t binding,
+        const VkImageView imageView,
+        const VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL)
+    {
+        VkDescriptorImageInfo info = {};
+        info.imageView = imageView;
+        info.imageLayout = layout;
+        return addImageWrite(binding, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, info);
+    }
+
+    DescriptorWriteList& bindStorageImage(
+        const uint32_t binding,
+        const VkImageView imageView,
+        const VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL)
+    {
+        VkDescriptorImageInfo info = {};
+        info.imageView = imageView;
+        info.imageLayout = layout;
+        return addImageWrite(binding, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, info);
+    }
+
+    DescriptorWriteList& bindUniformTexelBuffer(
+        const uint32_t binding, const VkBufferView bufferView)
+    {
+        return addTexelBufferWrite(binding, VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, bufferView);
+    }
+
+    DescriptorWriteList& bindStorageTexelBuffer(
+        const uint32_t binding, const VkBufferView bufferView)
+    {
+        return addTexelBufferWrite(binding, VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, bufferView);
+    }
+
+    DescriptorWriteList& bindUniformBuffer(
+        const uint32_t binding,
+        const VkBuffer buffer,
+        const VkDeviceSize offset = 0,
+        const VkDeviceSize range = VK_WHOLE_SIZE)
+    {
+        return addBufferWrite(binding, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, {buffer, offset, range});
+    }
+
+    DescriptorWriteList& bindStorageBuffer(
+        const uint32_t binding,
+        const VkBuffer buffer,
+        const VkDeviceSize offset = 0,
+        const VkDeviceSize range = VK_WHOLE_SIZE)
+    {
+        return addBufferWrite(binding, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, {buffer, offset, range});
+    }
+
+    DescriptorWriteList& bindAccelerationStructure(
+        const uint32_t binding, const VkAccelerationStructureKHR accelerationStructure)
+    {
+        auto* write = addWrite(binding, VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR);
+        if(write != nullptr)
+        {
+            const uint32_t index = writeCount_ - 1;
+            infos_[index].accelerationStructure = accelerationStructure;
+
+            auto& asInfo = asInfos_[index];
+            asInfo.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR;
+            asInfo.pNext = nullptr;
+            asInfo.accelerationStructureCount = 1;
+            asInfo.pAccelerationStructures = &infos_[index].accelerationStructure;
+            write->pNext = &asInfo;
+        }
+        return *this;
+    }
+
+    void clear() { writeCount_ = 0; }
+
+    uint32_t size() const { return writeCount_; }
+    bool empty() const { return writeCount_ == 0; }
+
+    const VkWriteDescriptorSet* data() const { return writes_; }
+
+  private:
+    union WriteInfo
+    {
+        VkDescriptorBufferInfo buffer;
+        VkDescriptorImageInfo image;
+        VkBufferView texelBuffer;
+        VkAccelerationStructureKHR accelerationStructure;
+    };
+
+    VkWriteDescriptorSet writes_[maxWriteCount];
+    WriteInfo infos_[maxWriteCount];
+    VkWriteDescriptorSetAccelerationStructureKHR asInfos_[maxWriteCount];
+    uint32_t writeCount_{0};
+
+    VkWriteDescriptorSet* addWrite(const uint32_t binding, const VkDescriptorType type)
+    {
+        if(writeCount_ >= maxWriteCount)
+        {
+            utils::Log::Error(
+                "vkw", "DescriptorWriteList is full, binding %u has been ignored", binding);
+            return nullptr;
+        }
+
+        auto& write = writes_[writeCount_++];
+        write = {};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.pNext = nullptr;
+        write.dstSet = VK_NULL_HANDLE; // Ignored for push descriptors
+        write.dstBinding = binding;
+        write.dstArrayElement = 0;
+        write.descriptorCount = 1;
+        write.descriptorType = type;
+        return &write;
+    }
+
+    DescriptorWriteList& addBufferWrite(
+        const uint32_t binding, const VkDescriptorType type, const VkDescriptorBufferInfo& info)
+    {
+        auto* write = addWrite(binding, type);
+        if(write != nullptr)
+        {
+            auto& writeInfo = infos_[writeCount_ - 1];
+            writeInfo.buffer = info;
+            write->pBufferInfo = &writeInfo.buffer;
+        }
+        return *this;
+    }
+
+    DescriptorWriteList& addImageWrite(
+        const uint32_t binding, const VkDescriptorType type, const VkDescriptorImageInfo& info)
+    {
+        auto* write = addWrite(binding, type);
+        if(write != nullptr)
+        {
+            auto& writeInfo = infos_[writeCount_ - 1];
+            writeInfo.image = info;
+            write->pImageInfo = &writeInfo.image;
+        }
+        return *this;
+    }
+
+    DescriptorWriteList& addTexelBufferWrite(
+        const uint32_t binding, const VkDescriptorType type, const VkBufferView bufferView)
+    {
+        auto* write = addWrite(binding, type);
+        if(write != nullptr)
+        {
+            auto& writeInfo = infos_[writeCount_ - 1];
+            writeInfo.texelBuffer = bufferView;
+            write->pTexelBufferView = &writeInfo.texelBuffer;
+        }
+        return *this;
+    }
+
+};
 } // namespace vkw
\ No newline at end of file
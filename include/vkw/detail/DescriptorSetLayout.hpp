@@ -24,6 +24,7 @@
 
 #include "vkw/detail/Buffer.hpp"
 #include "vkw/detail/Common.hpp"
+#include "vkw/detail/DebugUtils.hpp"
 #include "vkw/detail/Device.hpp"
 #include "vkw/detail/Instance.hpp"
 #include "vkw/detail/utils.hpp"
@@ -87,6 +88,7 @@ class DescriptorSetLayout
         device_ = nullptr;
         memset(bindingCounts_, 0, descriptorTypeCount * sizeof(uint32_t));
         bindings_.clear();
+        flags_ = 0;
 
         initialized_ = false;
     }
@@ -113,6 +115,48 @@ class DescriptorSetLayout
         return *this;
     }
 
+    // Layouts created with this flag can't be allocated from a pool, their descriptors are
+    // recorded with CommandBuffer::pushDescriptorSet() (requires VK_KHR_push_descriptor).
+    DescriptorSetLayout& setPushDescriptor(const bool pushDescriptor = true)
+    {
+        VKW_ASSERT(descriptorSetLayout_ == VK_NULL_HANDLE);
+        if(pushDescriptor)
+        {
+            flags_ |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+        }
+        else
+        {
+            flags_ &= ~VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+        }
+        return *this;
+    }
+
+    bool isPushDescriptor() const
+    {
+        return (flags_ & VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR) != 0;
+    }
+
+    // Layouts created with this flag are backed by a DescriptorBuffer instead of a pool
+    // (requires VK_EXT_descriptor_buffer).
+    DescriptorSetLayout& setDescriptorBuffer(const bool descriptorBuffer = true)
+    {
+        VKW_ASSERT(descriptorSetLayout_ == VK_NULL_HANDLE);
+        if(descriptorBuffer)
+        {
+            flags_ |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+        }
+        else
+        {
+            flags_ &= ~VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+        }
+        return *this;
+    }
+
+    bool isDescriptorBuffer() const
+    {
+        return (flags_ & VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT) != 0;
+    }
+
     void create();
 
     std::vector<VkDescriptorSetLayoutBinding>& getBindings() { return bindings_; }
@@ -135,6 +179,13 @@ class DescriptorSetLayout
 
     VkDescriptorSetLayout getHandle() const { return descriptorSetLayout_; }
 
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(this->initialized());
+        debug::setObjectName(
+            device_->getHandle(), VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, descriptorSetLayout_, name);
+    }
+
     const auto& bindingList() const { return bindings_; }
 
   private:
@@ -143,6 +194,7 @@ class DescriptorSetLayout
 
     uint32_t bindingCounts_[descriptorTypeCount]{};
     std::vector<VkDescriptorSetLayoutBinding> bindings_{};
+    VkDescriptorSetLayoutCreateFlags flags_{0};
 
     bool initialized_{false};
 };
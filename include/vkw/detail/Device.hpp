@@ -29,6 +29,10 @@
 #include "vkw/detail/utils.hpp"
 
 #include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 // Forward declaration of VmaAllocator
 struct VmaAllocator_T;
@@ -36,10 +40,40 @@ typedef struct VmaAllocator_T* VmaAllocator;
 
 namespace vkw
 {
+class FencePool;
+class PipelineCache;
+class SemaphorePool;
+
+// Queues created for a set of capabilities, taken from the most specialized family supporting
+// them. Priorities only order queues of the same family, the global priority (needs
+// VK_KHR_global_priority or VK_EXT_global_priority) applies to the whole family across the system,
+// the highest one requested for a family is used.
+struct QueueRequest
+{
+    QueueUsageFlags flags{0};
+    std::vector<float> priorities{1.0f}; ///< One per queue
+    VkQueueGlobalPriorityKHR globalPriority{VK_QUEUE_GLOBAL_PRIORITY_MEDIUM_KHR};
+};
+
+// An empty plan creates every queue of every family
+struct QueuePlan
+{
+    std::vector<QueueRequest> requests{};
+
+    QueuePlan& add(
+        const QueueUsageFlags flags,
+        const std::vector<float>& priorities = {1.0f},
+        const VkQueueGlobalPriorityKHR globalPriority = VK_QUEUE_GLOBAL_PRIORITY_MEDIUM_KHR)
+    {
+        requests.push_back({flags, priorities, globalPriority});
+        return *this;
+    }
+};
+
 class Device
 {
   public:
-    Device() {}
+    Device();
 
     Device(
         Instance& instance,
@@ -47,6 +81,13 @@ class Device
         const std::vector<const char*>& extensions,
         const VkPhysicalDeviceFeatures& requiredFeatures,
         const void* pCreateNext = nullptr);
+    Device(
+        Instance& instance,
+        const VkPhysicalDevice& physicalDevice,
+        const std::vector<const char*>& extensions,
+        const VkPhysicalDeviceFeatures& requiredFeatures,
+        const QueuePlan& queuePlan,
+        const void* pCreateNext = nullptr);
 
     Device(const Device&) = delete;
     Device(Device&& cp);
@@ -62,12 +103,23 @@ class Device
         const std::vector<const char*>& extensions,
         const VkPhysicalDeviceFeatures& requiredFeatures,
         const void* pCreateNext = nullptr);
+    bool init(
+        Instance& instance,
+        const VkPhysicalDevice& physicalDevice,
+        const std::vector<const char*>& extensions,
+        const VkPhysicalDeviceFeatures& requiredFeatures,
+        const QueuePlan& queuePlan,
+        const void* pCreateNext = nullptr);
 
     void clear();
 
     bool initialized() const { return initialized_; }
 
     std::vector<Queue> getQueues(const QueueUsageFlags requiredFlags) const;
+    // Same queues as getQueues(), queues from the most specialized families first. Dedicated
+    // transfer or compute families come before the graphics one, which avoids contending with
+    // rendering work.
+    std::vector<Queue> getPreferredQueues(const QueueUsageFlags requiredFlags) const;
     std::vector<Queue> getPresentQueues(const Surface& surface) const;
 
     inline const auto& vk() const { return vkDeviceTable_; }
@@ -76,13 +128,31 @@ class Device
     auto allocator() const { return memAllocator_; }
 
     auto bufferMemoryAddressEnabled() const { return useDeviceBufferAddress_; }
+    auto synchronization2Enabled() const { return useSynchronization2_; }
 
-    VkPhysicalDeviceFeatures getFeatures() const { return deviceFeatures_; }
-    VkPhysicalDeviceProperties getProperties() const { return deviceProperties_; }
+    bool isExtensionEnabled(const char* extensionName) const;
+    const auto& getEnabledExtensions() const { return enabledExtensions_; }
+
+    const VkPhysicalDeviceFeatures& getFeatures() const { return deviceFeatures_; }
+    const VkPhysicalDeviceFeatures& getEnabledFeatures() const { return enabledFeatures_; }
+    const VkPhysicalDeviceProperties& getProperties() const { return deviceProperties_; }
     VkPhysicalDevice getPhysicalDevice() const { return physicalDevice_; }
     const auto& getMemProperties() const { return memProperties_; }
 
-    void waitIdle() const { vk().vkDeviceWaitIdle(device_); }
+    // Valid bits of the timestamps written by queues of the family, 0 if they do not support
+    // timestamps. Without a family, the smallest non zero value among all families.
+    uint32_t getTimestampValidBits(const uint32_t queueFamilyIndex) const;
+    uint32_t getTimestampValidBits() const;
+
+    // Locks every queue of the device while waiting
+    void waitIdle() const;
+
+    // Recycled synchronization objects, shared by every user of the device
+    FencePool& fencePool() { return *fencePool_; }
+    SemaphorePool& semaphorePool() { return *semaphorePool_; }
+
+    // Used by every pipeline created on the device
+    PipelineCache& pipelineCache() { return *pipelineCache_; }
 
     static std::vector<VkPhysicalDevice> listSupportedDevices(
         const Instance& instance,
@@ -162,6 +232,8 @@ class Device
     VolkDeviceTable vkDeviceTable_{};
 
     VkPhysicalDeviceFeatures deviceFeatures_{};
+    VkPhysicalDeviceFeatures enabledFeatures_{};
+    std::vector<std::string> enabledExtensions_{};
     VkPhysicalDeviceProperties deviceProperties_{};
     VkPhysicalDevice physicalDevice_{VK_NULL_HANDLE};
     VkPhysicalDeviceMemoryProperties memProperties_{};
@@ -169,18 +241,30 @@ class Device
     VmaAllocator memAllocator_{VK_NULL_HANDLE};
 
     static constexpr uint32_t maxQueueCount = 32;
-    std::vector<float> queuePriorities_;
+    std::vector<std::vector<float>> queuePriorities_{}; ///< Per family
+    std::vector<VkDeviceQueueGlobalPriorityCreateInfoKHR> queueGlobalPriorities_{};
 
     std::vector<Queue> deviceQueues_{};
+    std::vector<std::unique_ptr<std::mutex>> queueMutexes_{}; ///< One per queue, shared by copies
     VkDevice device_{VK_NULL_HANDLE};
 
+    std::unique_ptr<FencePool> fencePool_{};
+    std::unique_ptr<SemaphorePool> semaphorePool_{};
+    std::unique_ptr<PipelineCache> pipelineCache_{};
+
     VkBool32 useDeviceBufferAddress_{VK_FALSE};
+    VkBool32 useSynchronization2_{VK_FALSE};
 
     bool initialized_{false};
 
     void allocateQueues();
 
-    std::vector<VkDeviceQueueCreateInfo> getAvailableQueuesInfo();
+    std::vector<VkDeviceQueueCreateInfo> getAvailableQueuesInfo(const QueuePlan& queuePlan);
+
+    static QueueUsageFlags getQueueUsageFlags(const VkQueueFlags queueFlags);
+    // Capabilities not requested count against a family, graphics being the most expensive one
+    static uint32_t getExtraCapabilityCost(
+        const QueueUsageFlags flags, const QueueUsageFlags requiredFlags);
 
     void validateAdditionalFeatures(const VkBaseOutStructure* pCreateNext);
 
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "vkw/detail/Common.hpp"
+#include "vkw/detail/DebugUtils.hpp"
 #include "vkw/detail/Device.hpp"
 #include "vkw/detail/ImageView.hpp"
 #include "vkw/detail/RenderPass.hpp"
@@ -68,6 +69,13 @@ class Framebuffer
     ~Framebuffer() { this->clear(); }
 
     auto getHandle() const { return framebuffer_; }
+
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(this->initialized());
+        debug::setObjectName(device_->getHandle(), VK_OBJECT_TYPE_FRAMEBUFFER, framebuffer_, name);
+    }
+
     auto getExtent() const { return extent_; }
 
     bool init(
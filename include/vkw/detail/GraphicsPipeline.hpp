@@ -24,6 +24,7 @@
 
 #include "vkw/detail/Buffer.hpp"
 #include "vkw/detail/Common.hpp"
+#include "vkw/detail/DebugUtils.hpp"
 #include "vkw/detail/DescriptorPool.hpp"
 #include "vkw/detail/Device.hpp"
 #include "vkw/detail/Instance.hpp"
@@ -118,9 +119,51 @@ class GraphicsPipeline
         const VkPipelineCreateFlagBits flags = {},
         const uint32_t viewMask = 0);
 
+    // Pipeline libraries (VK_EXT_graphics_pipeline_library). A library holds some of the four parts
+    // of the pipeline state: vertex input, pre-rasterization shaders, fragment shader and fragment
+    // output, taken from the states of this object. Variants that differ by one part only relink
+    // the others instead of compiling them again. Libraries keep their link time optimization
+    // info and go through the device pipeline cache.
+    bool createLibrary(
+        const VkGraphicsPipelineLibraryFlagsEXT parts,
+        RenderPass& renderPass,
+        PipelineLayout& pipelineLayout,
+        const VkPipelineCreateFlags flags = 0,
+        const uint32_t subPass = 0);
+
+    bool createLibrary(
+        const VkGraphicsPipelineLibraryFlagsEXT parts,
+        PipelineLayout& pipelineLayout,
+        const std::vector<VkFormat>& colorFormats,
+        const VkFormat depthFormat = VK_FORMAT_UNDEFINED,
+        const VkFormat stencilFormat = VK_FORMAT_UNDEFINED,
+        const VkPipelineCreateFlags flags = 0,
+        const uint32_t viewMask = 0);
+
+    // Links libraries covering the four parts into an executable pipeline. Fast linking is cheap
+    // and the pipeline usable right away, an optimized link of the same libraries can be created
+    // later, on another thread, to replace it.
+    bool linkLibraries(
+        PipelineLayout& pipelineLayout,
+        const std::vector<const GraphicsPipeline*>& libraries,
+        const bool optimize = false,
+        const VkPipelineCreateFlags flags = 0);
+
+    bool isLibrary() const { return libraryParts_ != 0; }
+    VkGraphicsPipelineLibraryFlagsEXT libraryParts() const { return libraryParts_; }
+
     VkPipeline& getHandle() { return pipeline_; }
     const VkPipeline& getHandle() const { return pipeline_; }
 
+    // Changes each time the pipeline or library is created, 0 before
+    uint64_t generation() const { return generation_; }
+
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(this->initialized());
+        debug::setObjectName(device_->getHandle(), VK_OBJECT_TYPE_PIPELINE, pipeline_, name);
+    }
+
     auto& viewports() { return viewports_; }
     const auto& viewports() const { return viewports_; }
 
@@ -153,9 +196,16 @@ class GraphicsPipeline
 
   private:
     static constexpr size_t maxStageCount = 7;
+    static constexpr VkGraphicsPipelineLibraryFlagsEXT allLibraryParts
+        = VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT
+          | VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT
+          | VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT
+          | VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
 
     Device* device_{nullptr};
     VkPipeline pipeline_{VK_NULL_HANDLE};
+    uint64_t generation_{0};
+    VkGraphicsPipelineLibraryFlagsEXT libraryParts_{0};
     std::vector<VkVertexInputBindingDescription> bindingDescriptions_{};
     std::vector<VkVertexInputAttributeDescription> attributeDescriptions_{};
 
@@ -231,6 +281,16 @@ class GraphicsPipeline
 
     bool validatePipeline();
 
-    void finalizePipelineStages();
+    // Only stages in stageMask get a shader module, the pipeline is validated if all are set
+    void finalizePipelineStages(const VkShaderStageFlags stageMask = VK_SHADER_STAGE_ALL);
+    void releasePipelineStages();
+
+    bool createLibrary(
+        const VkGraphicsPipelineLibraryFlagsEXT parts,
+        PipelineLayout& pipelineLayout,
+        const VkRenderPass renderPass,
+        const uint32_t subPass,
+        void* pNext,
+        const VkPipelineCreateFlags flags);
 };
 } // namespace vkw
\ No newline at end of file
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "vkw/detail/Common.hpp"
+#include "vkw/detail/DebugUtils.hpp"
 #include "vkw/detail/Device.hpp"
 #include "vkw/detail/MemoryCommon.hpp"
 #include "vkw/detail/utils.hpp"
@@ -88,6 +89,7 @@ class Image
         std::swap(memAllocation_, rhs.memAllocation_);
 
         std::swap(device_, rhs.device_);
+        std::swap(generation_, rhs.generation_);
         std::swap(initialized_, rhs.initialized_);
 
         return *this;
@@ -156,6 +158,7 @@ class Image
             utils::Log::Debug("vkw", "  hostCoherent: %s", hostCoherent() ? "True" : "False");
             utils::Log::Debug("vkw", "  hostCached:   %s", hostCached() ? "True" : "False");
 
+            generation_ = utils::nextGeneration();
             initialized_ = true;
         }
         return true;
@@ -196,6 +199,7 @@ class Image
             utils::Log::Debug("vkw", "  hostCoherent: %s", hostCoherent() ? "True" : "False");
             utils::Log::Debug("vkw", "  hostCached:   %s", hostCached() ? "True" : "False");
 
+            generation_ = utils::nextGeneration();
             initialized_ = true;
         }
 
@@ -218,6 +222,7 @@ class Image
         allocInfo_ = {};
 
         device_ = nullptr;
+        generation_ = 0;
         initialized_ = false;
     }
 
@@ -227,12 +232,22 @@ class Image
 
     VkImage getHandle() const { return image_; }
 
+    // Changes each time the image is created again, 0 when not initialized
+    uint64_t generation() const { return generation_; }
+
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(initialized_);
+        debug::setObjectName(device_->getHandle(), VK_OBJECT_TYPE_IMAGE, image_, name);
+    }
+
     // Memory properties
     bool deviceLocal() const
     {
         return device_->getMemProperties().memoryTypes[allocInfo_.memoryType].propertyFlags
                & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
     }
+
     bool hostVisible() const
     {
         return device_->getMemProperties().memoryTypes[allocInfo_.memoryType].propertyFlags
@@ -260,6 +275,7 @@ class Image
     VmaAllocationInfo allocInfo_{};
     VmaAllocation memAllocation_{VK_NULL_HANDLE};
 
+    uint64_t generation_{0};
     bool initialized_{false};
 };
 
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "vkw/detail/Common.hpp"
+#include "vkw/detail/DebugUtils.hpp"
 #include "vkw/detail/Device.hpp"
 #include "vkw/detail/Image.hpp"
 #include "vkw/detail/Instance.hpp"
@@ -65,6 +66,7 @@ class ImageView
         this->clear();
         std::swap(device_, rhs.device_);
         std::swap(imageView_, rhs.imageView_);
+        std::swap(generation_, rhs.generation_);
         std::swap(initialized_, rhs.initialized_);
         return *this;
     }
@@ -99,6 +101,7 @@ class ImageView
             VKW_INIT_CHECK_VK(device_->vk().vkCreateImageView(
                 device_->getHandle(), &createInfo, nullptr, &imageView_));
 
+            generation_ = utils::nextGeneration();
             initialized_ = true;
         }
 
@@ -114,6 +117,7 @@ class ImageView
             VKW_INIT_CHECK_VK(device_->vk().vkCreateImageView(
                 device_->getHandle(), &createInfo, nullptr, &imageView_));
 
+            generation_ = utils::nextGeneration();
             initialized_ = true;
         }
 
@@ -124,6 +128,7 @@ class ImageView
     {
         VKW_DELETE_VK(ImageView, imageView_);
         device_ = nullptr;
+        generation_ = 0;
         initialized_ = false;
     }
 
@@ -131,10 +136,20 @@ class ImageView
 
     VkImageView getHandle() const { return imageView_; }
 
+    // Changes each time the view is created again, 0 when not initialized
+    uint64_t generation() const { return generation_; }
+
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(this->initialized());
+        debug::setObjectName(device_->getHandle(), VK_OBJECT_TYPE_IMAGE_VIEW, imageView_, name);
+    }
+
   private:
     Device* device_{nullptr};
     VkImageView imageView_{VK_NULL_HANDLE};
 
+    uint64_t generation_{0};
     bool initialized_{false};
 };
 } // namespace vkw
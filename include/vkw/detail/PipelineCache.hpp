@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "vkw/detail/Common.hpp"
+#include "vkw/detail/DebugUtils.hpp"
+#include "vkw/detail/Device.hpp"
+#include "vkw/detail/utils.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vkw
+{
+// Pipeline cache persisted on disk. Files start with a header holding the vendor, device, driver
+// version and pipelineCacheUUID of the device that wrote them plus a checksum of the data, files
+// written for another device or driver, or damaged, are ignored. Saves go through a temporary
+// file renamed over the destination, so readers never see a partial file. The previous file is
+// kept when the rename fails.
+class PipelineCache
+{
+  public:
+    PipelineCache() {}
+    explicit PipelineCache(Device& device);
+
+    PipelineCache(const PipelineCache&) = delete;
+    PipelineCache(PipelineCache&& cp) { *this = std::move(cp); }
+
+    PipelineCache& operator=(const PipelineCache&) = delete;
+    PipelineCache& operator=(PipelineCache&& cp);
+
+    ~PipelineCache() { this->clear(); }
+
+    bool init(Device& device);
+
+    void clear();
+
+    bool initialized() const { return initialized_; }
+
+    // Merges the entries saved in filename into the cache. Returns false if the file is missing
+    // or does not match the device, the cache is left untouched then.
+    bool load(const std::string& filename);
+
+    // Entries saved by other processes since the file was loaded are merged in first when
+    // mergeExisting is set
+    bool save(const std::string& filename, const bool mergeExisting = true);
+
+    // Host access to the cache must be synchronized with pipeline creation while merging
+    bool merge(const PipelineCache& other);
+
+    std::vector<uint8_t> getData() const;
+
+    VkPipelineCache& getHandle() { return pipelineCache_; }
+    const VkPipelineCache& getHandle() const { return pipelineCache_; }
+
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(this->initialized());
+        debug::setObjectName(
+            device_->getHandle(), VK_OBJECT_TYPE_PIPELINE_CACHE, pipelineCache_, name);
+    }
+
+  private:
+    Device* device_{nullptr};
+    VkPipelineCache pipelineCache_{VK_NULL_HANDLE};
+
+    bool initialized_{false};
+
+    // Returns the cache data stored in filename if it was written for this device
+    bool readFile(const std::string& filename, std::vector<uint8_t>& data) const;
+    bool mergeData(const std::vector<uint8_t>& data);
+};
+} // namespace vkw
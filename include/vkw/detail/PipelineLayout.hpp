@@ -24,6 +24,7 @@
 
 #include "vkw/detail/Buffer.hpp"
 #include "vkw/detail/Common.hpp"
+#include "vkw/detail/DebugUtils.hpp"
 #include "vkw/detail/DescriptorSetLayout.hpp"
 #include "vkw/detail/Device.hpp"
 #include "vkw/detail/Instance.hpp"
@@ -109,6 +110,13 @@ class PipelineLayout
 
     VkPipelineLayout getHandle() const { return pipelineLayout_; }
 
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(this->initialized());
+        debug::setObjectName(
+            device_->getHandle(), VK_OBJECT_TYPE_PIPELINE_LAYOUT, pipelineLayout_, name);
+    }
+
     template <typename T>
     PipelineLayout& reservePushConstants(const ShaderStage stage)
     {
@@ -136,6 +144,8 @@ class PipelineLayout
 
   private:
     friend class CommandBuffer;
+    friend class CommandStream;
+    friend class ShaderObject;
 
     Device* device_{nullptr};
 
@@ -183,5 +193,6 @@ class PipelineLayout
                 return VK_SHADER_STAGE_FLAG_BITS_MAX_ENUM;
         }
     }
+
 };
 } // namespace vkw
\ No newline at end of file
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "vkw/detail/Common.hpp"
+#include "vkw/detail/DebugUtils.hpp"
+#include "vkw/detail/Device.hpp"
+#include "vkw/detail/utils.hpp"
+
+#include <vector>
+
+namespace vkw
+{
+struct PipelineStatistics
+{
+    uint64_t inputAssemblyVertices{0};
+    uint64_t inputAssemblyPrimitives{0};
+    uint64_t vertexShaderInvocations{0};
+    uint64_t geometryShaderInvocations{0};
+    uint64_t geometryShaderPrimitives{0};
+    uint64_t clippingInvocations{0};
+    uint64_t clippingPrimitives{0};
+    uint64_t fragmentShaderInvocations{0};
+    uint64_t tessellationControlShaderPatches{0};
+    uint64_t tessellationEvaluationShaderInvocations{0};
+    uint64_t computeShaderInvocations{0};
+    uint64_t taskShaderInvocations{0};
+    uint64_t meshShaderInvocations{0};
+
+    PipelineStatistics& operator+=(const PipelineStatistics& rhs);
+
+    // Values are written by the driver in increasing order of their statistic bit
+    static PipelineStatistics fromQueryResults(
+        const VkQueryPipelineStatisticFlags flags, const uint64_t* values);
+};
+
+class QueryPool
+{
+  public:
+    QueryPool() {}
+    QueryPool(
+        Device& device,
+        const VkQueryType queryType,
+        const uint32_t queryCount,
+        const VkQueryPipelineStatisticFlags pipelineStatistics = 0);
+
+    QueryPool(const QueryPool&) = delete;
+    QueryPool(QueryPool&& cp) { *this = std::move(cp); }
+
+    QueryPool& operator=(const QueryPool&) = delete;
+    QueryPool& operator=(QueryPool&& cp);
+
+    ~QueryPool() { this->clear(); }
+
+    bool init(
+        Device& device,
+        const VkQueryType queryType,
+        const uint32_t queryCount,
+        const VkQueryPipelineStatisticFlags pipelineStatistics = 0);
+
+    void clear();
+
+    bool initialized() const { return initialized_; }
+
+    // Host side reset, requires the hostQueryReset feature
+    void reset(const uint32_t firstQuery, const uint32_t queryCount);
+    void reset() { reset(0, queryCount_); }
+
+    // Number of values written for each query, availability excluded
+    uint32_t valuesPerQuery() const;
+
+    // Returns VK_NOT_READY if some of the results are not available yet and
+    // VK_QUERY_RESULT_PARTIAL_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT were not set.
+    VkResult getResults(
+        const uint32_t firstQuery,
+        const uint32_t queryCount,
+        void* data,
+        const size_t dataSize,
+        const VkDeviceSize stride,
+        const VkQueryResultFlags flags) const;
+
+    VkResult getResults(
+        const uint32_t firstQuery,
+        const uint32_t queryCount,
+        std::vector<uint64_t>& results,
+        const VkQueryResultFlags flags = 0) const;
+
+    VkQueryType type() const { return queryType_; }
+    uint32_t size() const { return queryCount_; }
+    VkQueryPipelineStatisticFlags pipelineStatistics() const { return pipelineStatistics_; }
+
+    VkQueryPool getHandle() const { return queryPool_; }
+
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(this->initialized());
+        debug::setObjectName(device_->getHandle(), VK_OBJECT_TYPE_QUERY_POOL, queryPool_, name);
+    }
+
+  private:
+    Device* device_{nullptr};
+    VkQueryPool queryPool_{VK_NULL_HANDLE};
+
+    VkQueryType queryType_{VK_QUERY_TYPE_TIMESTAMP};
+    VkQueryPipelineStatisticFlags pipelineStatistics_{0};
+    uint32_t queryCount_{0};
+
+    bool initialized_{false};
+};
+} // namespace vkw
@@ -23,8 +23,13 @@
 #pragma once
 
 #include "vkw/detail/Common.hpp"
+#include "vkw/detail/DebugUtils.hpp"
 #include "vkw/detail/utils.hpp"
 
+#include <initializer_list>
+#include <mutex>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace vkw
@@ -41,12 +46,302 @@ enum QueueUsageBits
 };
 typedef uint32_t QueueUsageFlags;
 
+// Accumulates several submissions, each made of command buffers and binary or timeline semaphore
+// waits and signals with their own stage masks, and flushes them to a queue in a single
+// vkQueueSubmit2 call. Storage is kept between flushes, a batch reused every frame does not
+// allocate once warmed up.
+class SubmitBatch
+{
+  public:
+    SubmitBatch() {}
+
+    SubmitBatch(const SubmitBatch&) = delete;
+    SubmitBatch(SubmitBatch&&) = default;
+
+    SubmitBatch& operator=(const SubmitBatch&) = delete;
+    SubmitBatch& operator=(SubmitBatch&&) = default;
+
+    ~SubmitBatch() {}
+
+    SubmitBatch& addCommandBuffer(const VkCommandBuffer cmdBuffer)
+    {
+        auto& submit = currentSubmit();
+
+        VkCommandBufferSubmitInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+        info.pNext = nullptr;
+        info.commandBuffer = cmdBuffer;
+        info.deviceMask = 0;
+        cmdBuffers_.push_back(info);
+        submit.cmdBufferCount++;
+
+        return *this;
+    }
+
+    template <typename CommandBuffer>
+    SubmitBatch& addCommandBuffer(const CommandBuffer& cmdBuffer)
+    {
+        return addCommandBuffer(cmdBuffer.getHandle());
+    }
+
+    // The value is only used by timeline semaphores
+    SubmitBatch& addWait(
+        const VkSemaphore semaphore,
+        const VkPipelineStageFlags2 stageMask,
+        const uint64_t value = 0)
+    {
+        auto& submit = currentSubmit();
+        waits_.push_back(semaphoreInfo(semaphore, stageMask, value));
+        submit.waitCount++;
+        return *this;
+    }
+
+    template <typename Semaphore>
+    SubmitBatch& addWait(
+        const Semaphore& semaphore,
+        const VkPipelineStageFlags2 stageMask,
+        const uint64_t value = 0)
+    {
+        return addWait(semaphore.getHandle(), stageMask, value);
+    }
+
+    SubmitBatch& addSignal(
+        const VkSemaphore semaphore,
+        const VkPipelineStageFlags2 stageMask,
+        const uint64_t value = 0)
+    {
+        auto& submit = currentSubmit();
+        signals_.push_back(semaphoreInfo(semaphore, stageMask, value));
+        submit.signalCount++;
+        return *this;
+    }
+
+    template <typename Semaphore>
+    SubmitBatch& addSignal(
+        const Semaphore& semaphore,
+        const VkPipelineStageFlags2 stageMask,
+        const uint64_t value = 0)
+    {
+        return addSignal(semaphore.getHandle(), stageMask, value);
+    }
+
+    // Starts a new submission, commands of the next one only wait on its own semaphores
+    SubmitBatch& nextSubmit()
+    {
+        if(!submits_.empty())
+        {
+            submits_.push_back(
+                {static_cast<uint32_t>(waits_.size()),
+                 0,
+                 static_cast<uint32_t>(cmdBuffers_.size()),
+                 0,
+                 static_cast<uint32_t>(signals_.size()),
+                 0});
+        }
+        return *this;
+    }
+
+    size_t submitCount() const { return submits_.size(); }
+    size_t commandBufferCount() const { return cmdBuffers_.size(); }
+    bool empty() const { return submits_.empty(); }
+
+    void clear()
+    {
+        submits_.clear();
+        waits_.clear();
+        signals_.clear();
+        cmdBuffers_.clear();
+    }
+
+  private:
+    friend class Queue;
+
+    struct SubmitRange
+    {
+        uint32_t firstWait;
+        uint32_t waitCount;
+        uint32_t firstCmdBuffer;
+        uint32_t cmdBufferCount;
+        uint32_t firstSignal;
+        uint32_t signalCount;
+    };
+
+    std::vector<SubmitRange> submits_{};
+    std::vector<VkSemaphoreSubmitInfo> waits_{};
+    std::vector<VkSemaphoreSubmitInfo> signals_{};
+    std::vector<VkCommandBufferSubmitInfo> cmdBuffers_{};
+
+    // Scratch storage filled when flushing
+    std::vector<VkSubmitInfo2> submitInfos_{};
+    std::vector<VkSubmitInfo> legacySubmitInfos_{};
+    std::vector<VkTimelineSemaphoreSubmitInfo> legacyTimelineInfos_{};
+    std::vector<VkSemaphore> legacySemaphores_{};
+    std::vector<uint64_t> legacyValues_{};
+    std::vector<VkPipelineStageFlags> legacyStages_{};
+    std::vector<VkCommandBuffer> legacyCmdBuffers_{};
+
+    SubmitRange& currentSubmit()
+    {
+        if(submits_.empty())
+        {
+            submits_.push_back({0, 0, 0, 0, 0, 0});
+        }
+        return submits_.back();
+    }
+
+    static VkSemaphoreSubmitInfo semaphoreInfo(
+        const VkSemaphore semaphore, const VkPipelineStageFlags2 stageMask, const uint64_t value)
+    {
+        VkSemaphoreSubmitInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+        info.pNext = nullptr;
+        info.semaphore = semaphore;
+        info.value = value;
+        info.stageMask = stageMask;
+        info.deviceIndex = 0;
+        return info;
+    }
+
+    VkResult flush(
+        const VolkDeviceTable& vk,
+        const VkQueue queue,
+        const VkFence fence,
+        const bool useSynchronization2)
+    {
+        const VkResult res = useSynchronization2 ? flushSubmit2(vk, queue, fence)
+                                                 : flushLegacy(vk, queue, fence);
+        this->clear();
+        return res;
+    }
+
+    VkResult flushSubmit2(const VolkDeviceTable& vk, const VkQueue queue, const VkFence fence)
+    {
+        submitInfos_.clear();
+        for(const auto& range : submits_)
+        {
+            VkSubmitInfo2 info = {};
+            info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+            info.pNext = nullptr;
+            info.flags = 0;
+            info.waitSemaphoreInfoCount = range.waitCount;
+            info.pWaitSemaphoreInfos = waits_.data() + range.firstWait;
+            info.commandBufferInfoCount = range.cmdBufferCount;
+            info.pCommandBufferInfos = cmdBuffers_.data() + range.firstCmdBuffer;
+            info.signalSemaphoreInfoCount = range.signalCount;
+            info.pSignalSemaphoreInfos = signals_.data() + range.firstSignal;
+            submitInfos_.push_back(info);
+        }
+
+        const auto submitFn
+            = (vk.vkQueueSubmit2 != nullptr) ? vk.vkQueueSubmit2 : vk.vkQueueSubmit2KHR;
+        return submitFn(
+            queue, static_cast<uint32_t>(submitInfos_.size()), submitInfos_.data(), fence);
+    }
+
+    // Used when synchronization2 is not enabled on the device, stage masks are converted to
+    // their legacy equivalent.
+    VkResult flushLegacy(const VolkDeviceTable& vk, const VkQueue queue, const VkFence fence)
+    {
+        // Waits first then signals, so that the offsets of the ranges can be reused
+        const size_t signalOffset = waits_.size();
+
+        legacySemaphores_.clear();
+        legacyValues_.clear();
+        legacyStages_.clear();
+        for(const auto* infos : {&waits_, &signals_})
+        {
+            for(const auto& info : *infos)
+            {
+                legacySemaphores_.push_back(info.semaphore);
+                legacyValues_.push_back(info.value);
+                legacyStages_.push_back(legacyStageMask(info.stageMask));
+            }
+        }
+
+        legacyCmdBuffers_.clear();
+        for(const auto& info : cmdBuffers_)
+        {
+            legacyCmdBuffers_.push_back(info.commandBuffer);
+        }
+
+        legacySubmitInfos_.resize(submits_.size());
+        legacyTimelineInfos_.resize(submits_.size());
+        for(size_t i = 0; i < submits_.size(); ++i)
+        {
+            const auto& range = submits_[i];
+            const size_t firstSignal = signalOffset + range.firstSignal;
+
+            auto& timelineInfo = legacyTimelineInfos_[i];
+            timelineInfo = {};
+            timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+            timelineInfo.pNext = nullptr;
+            timelineInfo.waitSemaphoreValueCount = range.waitCount;
+            timelineInfo.pWaitSemaphoreValues = legacyValues_.data() + range.firstWait;
+            timelineInfo.signalSemaphoreValueCount = range.signalCount;
+            timelineInfo.pSignalSemaphoreValues = legacyValues_.data() + firstSignal;
+
+            auto& info = legacySubmitInfos_[i];
+            info = {};
+            info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            info.pNext = hasTimelineValues(range) ? &timelineInfo : nullptr;
+            info.waitSemaphoreCount = range.waitCount;
+            info.pWaitSemaphores = legacySemaphores_.data() + range.firstWait;
+            info.pWaitDstStageMask = legacyStages_.data() + range.firstWait;
+            info.commandBufferCount = range.cmdBufferCount;
+            info.pCommandBuffers = legacyCmdBuffers_.data() + range.firstCmdBuffer;
+            info.signalSemaphoreCount = range.signalCount;
+            info.pSignalSemaphores = legacySemaphores_.data() + firstSignal;
+        }
+
+        return vk.vkQueueSubmit(
+            queue,
+            static_cast<uint32_t>(legacySubmitInfos_.size()),
+            legacySubmitInfos_.data(),
+            fence);
+    }
+
+    bool hasTimelineValues(const SubmitRange& range) const
+    {
+        for(uint32_t i = 0; i < range.waitCount; ++i)
+        {
+            if(waits_[range.firstWait + i].value != 0)
+            {
+                return true;
+            }
+        }
+        for(uint32_t i = 0; i < range.signalCount; ++i)
+        {
+            if(signals_[range.firstSignal + i].value != 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static VkPipelineStageFlags legacyStageMask(const VkPipelineStageFlags2 stageMask)
+    {
+        // Stages only defined by synchronization2 do not fit in 32 bits
+        const auto legacyMask = static_cast<VkPipelineStageFlags>(stageMask & 0xffffffffull);
+        if(legacyMask == 0 || (stageMask >> 32) != 0)
+        {
+            return VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        }
+        return legacyMask;
+    }
+};
+
 class Queue
 {
     ///@note : because Device is not visible from this class, methods must use templates to
     /// designate other vkw objects here.
     ///@note : we could create "base" class objects with the name and a valid getHandle() method, if
     /// compilation is too long.
+
+    // Braced lists of raw handles go to the overloads taking VkSemaphore spans
+    template <typename Semaphore>
+    using IfWrapper = std::enable_if_t<!std::is_same<Semaphore*, VkSemaphore>::value>;
+
   public:
     Queue() = default;
     Queue(const VolkDeviceTable& vkFuncs) : vk{&vkFuncs} {}
@@ -77,6 +372,15 @@ class Queue
 
     VkQueue getHandle() const { return queue_; }
 
+    // Vulkan requires external synchronization of queues. All the copies of a queue obtained from
+    // the same device share one mutex, locked by every method submitting to the queue. Callers
+    // using getHandle() directly must hold this lock.
+    std::unique_lock<std::mutex> lock() const
+    {
+        return (mutex_ != nullptr) ? std::unique_lock<std::mutex>(*mutex_)
+                                   : std::unique_lock<std::mutex>();
+    }
+
     // ---------------------------------------------------------------------------------------------
 
     template <typename CommandBuffer, typename Fence>
@@ -85,43 +389,67 @@ class Queue
         const auto handle = cmdBuffer.getHandle();
         VkSubmitInfo submitInfo = {
             VK_STRUCTURE_TYPE_SUBMIT_INFO, nullptr, 0, nullptr, nullptr, 1, &(handle), 0, nullptr};
+        const auto queueLock = this->lock();
         return vk->vkQueueSubmit(queue_, 1, &submitInfo, fence.getHandle());
     }
 
-    template <typename CommandBuffer, typename Semaphore>
+    // Semaphore wrappers are given as braced lists, which do not allocate, or as vectors. The
+    // semaphores handles are gathered on the stack in both cases.
+    template <typename CommandBuffer, typename Semaphore, typename = IfWrapper<Semaphore>>
+    VkResult submit(
+        CommandBuffer& cmdBuffer,
+        const std::initializer_list<Semaphore*> waitSemaphores,
+        const utils::Span<const VkPipelineStageFlags> waitFlags,
+        const std::initializer_list<Semaphore*> signalSemaphores)
+    {
+        return submitWrappers(
+            cmdBuffer,
+            toSpan(waitSemaphores),
+            waitFlags,
+            toSpan(signalSemaphores),
+            VK_NULL_HANDLE);
+    }
+
+    template <typename CommandBuffer, typename Semaphore, typename = IfWrapper<Semaphore>>
     VkResult submit(
         CommandBuffer& cmdBuffer,
         const std::vector<Semaphore*>& waitSemaphores,
-        const std::vector<VkPipelineStageFlags>& waitFlags,
+        const utils::Span<const VkPipelineStageFlags> waitFlags,
         const std::vector<Semaphore*>& signalSemaphores)
     {
-        const auto handle = cmdBuffer.getHandle();
+        return submitWrappers(
+            cmdBuffer,
+            utils::Span<Semaphore* const>(waitSemaphores),
+            waitFlags,
+            utils::Span<Semaphore* const>(signalSemaphores),
+            VK_NULL_HANDLE);
+    }
 
-        std::vector<VkSemaphore> waitSemaphoreValues;
-        waitSemaphoreValues.reserve(waitSemaphores.size());
-        for(size_t i = 0; i < waitSemaphores.size(); ++i)
-        {
-            waitSemaphoreValues.emplace_back(waitSemaphores[i]->getHandle());
-        }
+    // Variant taking raw handles, lets callers build the semaphore lists on the stack
+    template <typename CommandBuffer>
+    VkResult submit(
+        CommandBuffer& cmdBuffer,
+        const utils::Span<const VkSemaphore> waitSemaphores,
+        const utils::Span<const VkPipelineStageFlags> waitFlags,
+        const utils::Span<const VkSemaphore> signalSemaphores,
+        const VkFence fence = VK_NULL_HANDLE)
+    {
+        VKW_ASSERT(waitFlags.size() == waitSemaphores.size());
 
-        std::vector<VkSemaphore> signalSemaphoreValues;
-        signalSemaphoreValues.reserve(signalSemaphores.size());
-        for(size_t i = 0; i < signalSemaphores.size(); ++i)
-        {
-            signalSemaphoreValues.emplace_back(signalSemaphores[i]->getHandle());
-        }
+        const auto handle = cmdBuffer.getHandle();
 
         VkSubmitInfo submitInfo
             = {VK_STRUCTURE_TYPE_SUBMIT_INFO,
                nullptr,
                static_cast<uint32_t>(waitSemaphores.size()),
-               waitSemaphoreValues.data(),
+               waitSemaphores.data(),
                waitFlags.data(),
                1,
                &(handle),
                static_cast<uint32_t>(signalSemaphores.size()),
-               signalSemaphoreValues.data()};
-        return vk->vkQueueSubmit(queue_, 1, &submitInfo, VK_NULL_HANDLE);
+               signalSemaphores.data()};
+        const auto queueLock = this->lock();
+        return vk->vkQueueSubmit(queue_, 1, &submitInfo, fence);
     }
 
     template <typename CommandBuffer, typename TimelineSemaphore>
@@ -153,96 +481,112 @@ class Queue
         submitInfo.pSignalSemaphores = &(semHandle);
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers = &(handle);
+        const auto queueLock = this->lock();
         return vk->vkQueueSubmit(queue_, 1, &submitInfo, VK_NULL_HANDLE);
     }
 
-    template <typename CommandBuffer, typename TimelineSemaphore>
+    template <
+        typename CommandBuffer,
+        typename TimelineSemaphore,
+        typename = IfWrapper<TimelineSemaphore>>
+    VkResult submit(
+        CommandBuffer& cmdBuffer,
+        const std::initializer_list<TimelineSemaphore*> waitSemaphores,
+        const utils::Span<const VkPipelineStageFlags> waitFlags,
+        const utils::Span<const uint64_t> waitValues,
+        const std::initializer_list<TimelineSemaphore*> signalSemaphores,
+        const utils::Span<const uint64_t> signalValues)
+    {
+        return submitTimelineWrappers(
+            cmdBuffer,
+            toSpan(waitSemaphores),
+            waitFlags,
+            waitValues,
+            toSpan(signalSemaphores),
+            signalValues);
+    }
+
+    template <
+        typename CommandBuffer,
+        typename TimelineSemaphore,
+        typename = IfWrapper<TimelineSemaphore>>
     VkResult submit(
         CommandBuffer& cmdBuffer,
         const std::vector<TimelineSemaphore*>& waitSemaphores,
-        const std::vector<VkPipelineStageFlags>& waitFlags,
-        const std::vector<uint64_t>& waitValues,
+        const utils::Span<const VkPipelineStageFlags> waitFlags,
+        const utils::Span<const uint64_t> waitValues,
         const std::vector<TimelineSemaphore*>& signalSemaphores,
-        const std::vector<uint64_t>& signalValues)
+        const utils::Span<const uint64_t> signalValues)
     {
-        const auto handle = cmdBuffer.getHandle();
-
-        VkTimelineSemaphoreSubmitInfo semaphoreSubmitInfo = {};
-        semaphoreSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
-        semaphoreSubmitInfo.pNext = nullptr;
-        semaphoreSubmitInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitSemaphores.size());
-        semaphoreSubmitInfo.pWaitSemaphoreValues = waitValues.data();
-        semaphoreSubmitInfo.signalSemaphoreValueCount
-            = static_cast<uint32_t>(signalSemaphores.size());
-        semaphoreSubmitInfo.pSignalSemaphoreValues = signalValues.data();
-
-        std::vector<VkSemaphore> waitSemaphoreValues;
-        waitSemaphoreValues.reserve(waitSemaphores.size());
-        for(size_t i = 0; i < waitSemaphores.size(); ++i)
-        {
-            waitSemaphoreValues.emplace_back(waitSemaphores[i]->getHandle());
-        }
-
-        std::vector<VkSemaphore> signalSemaphoreValues;
-        signalSemaphoreValues.reserve(signalSemaphores.size());
-        for(size_t i = 0; i < signalSemaphores.size(); ++i)
-        {
-            signalSemaphoreValues.emplace_back(signalSemaphores[i]->getHandle());
-        }
+        return submitTimelineWrappers(
+            cmdBuffer,
+            utils::Span<TimelineSemaphore* const>(waitSemaphores),
+            waitFlags,
+            waitValues,
+            utils::Span<TimelineSemaphore* const>(signalSemaphores),
+            signalValues);
+    }
 
-        VkSubmitInfo submitInfo = {};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.pNext = &semaphoreSubmitInfo;
-        submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
-        submitInfo.pWaitDstStageMask = waitFlags.data();
-        submitInfo.pWaitSemaphores = waitSemaphoreValues.data();
-        submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
-        submitInfo.pSignalSemaphores = signalSemaphoreValues.data();
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &(handle);
-        return vk->vkQueueSubmit(queue_, 1, &submitInfo, VK_NULL_HANDLE);
+    template <
+        typename CommandBuffer,
+        typename Semaphore,
+        typename Fence,
+        typename = IfWrapper<Semaphore>>
+    VkResult submit(
+        CommandBuffer& cmdBuffer,
+        const std::initializer_list<Semaphore*> waitSemaphores,
+        const utils::Span<const VkPipelineStageFlags> waitFlags,
+        const std::initializer_list<Semaphore*> signalSemaphores,
+        Fence& fence)
+    {
+        return submitWrappers(
+            cmdBuffer,
+            toSpan(waitSemaphores),
+            waitFlags,
+            toSpan(signalSemaphores),
+            fence.getHandle());
     }
 
-    template <typename CommandBuffer, typename Semaphore, typename Fence>
+    template <
+        typename CommandBuffer,
+        typename Semaphore,
+        typename Fence,
+        typename = IfWrapper<Semaphore>>
     VkResult submit(
         CommandBuffer& cmdBuffer,
         const std::vector<Semaphore*>& waitSemaphores,
-        const std::vector<VkPipelineStageFlags>& waitFlags,
+        const utils::Span<const VkPipelineStageFlags> waitFlags,
         const std::vector<Semaphore*>& signalSemaphores,
         Fence& fence)
     {
-        const auto handle = cmdBuffer.getHandle();
-
-        std::vector<VkSemaphore> waitSemaphoreValues;
-        waitSemaphoreValues.reserve(waitSemaphores.size());
-        for(size_t i = 0; i < waitSemaphores.size(); ++i)
-        {
-            waitSemaphoreValues.emplace_back(waitSemaphores[i]->getHandle());
-        }
+        return submitWrappers(
+            cmdBuffer,
+            utils::Span<Semaphore* const>(waitSemaphores),
+            waitFlags,
+            utils::Span<Semaphore* const>(signalSemaphores),
+            fence.getHandle());
+    }
 
-        std::vector<VkSemaphore> signalSemaphoreValues;
-        signalSemaphoreValues.reserve(signalSemaphores.size());
-        for(size_t i = 0; i < signalSemaphores.size(); ++i)
-        {
-            signalSemaphoreValues.emplace_back(signalSemaphores[i]->getHandle());
-        }
+    // Flushes every submission of the batch in one call, the batch is cleared afterwards
+    VkResult submit(SubmitBatch& batch, const VkFence fence = VK_NULL_HANDLE)
+    {
+        const auto queueLock = this->lock();
+        return batch.flush(*vk, queue_, fence, useSynchronization2_);
+    }
 
-        VkSubmitInfo submitInfo
-            = {VK_STRUCTURE_TYPE_SUBMIT_INFO,
-               nullptr,
-               static_cast<uint32_t>(waitSemaphores.size()),
-               waitSemaphoreValues.data(),
-               waitFlags.data(),
-               1,
-               &(handle),
-               static_cast<uint32_t>(signalSemaphores.size()),
-               signalSemaphoreValues.data()};
-        return vk->vkQueueSubmit(queue_, 1, &submitInfo, fence.getHandle());
+    template <typename Fence>
+    VkResult submit(SubmitBatch& batch, const Fence& fence)
+    {
+        return submit(batch, fence.getHandle());
     }
 
     // ---------------------------------------------------------------------------------------------
 
-    template <typename Swapchain, typename Semaphore>
+    // Only takes semaphore wrappers, containers of handles go to the span overload
+    template <
+        typename Swapchain,
+        typename Semaphore,
+        typename = decltype(std::declval<const Semaphore&>().getHandle())>
     VkResult present(
         Swapchain& swapchain, const Semaphore& waitSemaphore, const uint32_t imageIndex)
     {
@@ -255,40 +599,183 @@ class Queue
         presentInfo.pImageIndices = &imageIndex;
         presentInfo.pResults = nullptr;
 
+        const auto queueLock = this->lock();
         return vk->vkQueuePresentKHR(queue_, &presentInfo);
     }
 
-    template <typename Swapchain, typename Semaphore>
+    template <typename Swapchain, typename Semaphore, typename = IfWrapper<Semaphore>>
+    VkResult present(
+        Swapchain& swapchain,
+        const std::initializer_list<Semaphore*> waitSemaphores,
+        const uint32_t imageIndex)
+    {
+        return presentWrappers(swapchain, toSpan(waitSemaphores), imageIndex);
+    }
+
+    template <typename Swapchain, typename Semaphore, typename = IfWrapper<Semaphore>>
     VkResult present(
         Swapchain& swapchain,
         const std::vector<Semaphore*>& waitSemaphores,
         const uint32_t imageIndex)
     {
-        std::vector<VkSemaphore> waitSemaphoreValues;
-        waitSemaphoreValues.reserve(waitSemaphores.size());
-        for(size_t i = 0; i < waitSemaphores.size(); ++i)
-        {
-            waitSemaphoreValues.emplace_back(waitSemaphores[i]->getHandle());
-        }
+        return presentWrappers(
+            swapchain, utils::Span<Semaphore* const>(waitSemaphores), imageIndex);
+    }
 
+    template <typename Swapchain>
+    VkResult present(
+        Swapchain& swapchain,
+        const utils::Span<const VkSemaphore> waitSemaphores,
+        const uint32_t imageIndex)
+    {
         VkPresentInfoKHR presentInfo{};
         presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-        presentInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphoreValues.size());
-        presentInfo.pWaitSemaphores = waitSemaphoreValues.data();
+        presentInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+        presentInfo.pWaitSemaphores = waitSemaphores.data();
         presentInfo.swapchainCount = 1;
         presentInfo.pSwapchains = &swapchain.getHandle();
         presentInfo.pImageIndices = &imageIndex;
         presentInfo.pResults = nullptr;
 
+        const auto queueLock = this->lock();
         return vk->vkQueuePresentKHR(queue_, &presentInfo);
     }
 
-    VkResult waitIdle() { return vk->vkQueueWaitIdle(queue_); }
+    VkResult waitIdle()
+    {
+        const auto queueLock = this->lock();
+        return vk->vkQueueWaitIdle(queue_);
+    }
+
+    // Debug labels, only visible in tools when VKW_DEBUG_UTILS is enabled
+    void beginLabel(const char* name, const uint32_t color = debug::defaultLabelColor)
+    {
+        const auto queueLock = this->lock();
+        debug::beginLabel(queue_, name, color);
+    }
+    void endLabel()
+    {
+        const auto queueLock = this->lock();
+        debug::endLabel(queue_);
+    }
+    void insertLabel(const char* name, const uint32_t color = debug::defaultLabelColor)
+    {
+        const auto queueLock = this->lock();
+        debug::insertLabel(queue_, name, color);
+    }
 
   private:
     friend class Device;
     const VolkDeviceTable* vk;
 
+    // Semaphore lists up to this size are converted to handles without heap allocation
+    static constexpr size_t maxInlineSemaphoreCount = 8;
+
+    template <typename T>
+    static utils::Span<T* const> toSpan(const std::initializer_list<T*> list)
+    {
+        return utils::Span<T* const>(list.begin(), list.size());
+    }
+
+    template <typename CommandBuffer, typename Semaphore>
+    VkResult submitWrappers(
+        CommandBuffer& cmdBuffer,
+        const utils::Span<Semaphore* const> waitSemaphores,
+        const utils::Span<const VkPipelineStageFlags> waitFlags,
+        const utils::Span<Semaphore* const> signalSemaphores,
+        const VkFence fence)
+    {
+        VKW_ASSERT(waitFlags.size() == waitSemaphores.size());
+
+        utils::SmallVector<VkSemaphore, maxInlineSemaphoreCount> waitSemaphoreValues;
+        for(const auto* semaphore : waitSemaphores)
+        {
+            waitSemaphoreValues.push_back(semaphore->getHandle());
+        }
+
+        utils::SmallVector<VkSemaphore, maxInlineSemaphoreCount> signalSemaphoreValues;
+        for(const auto* semaphore : signalSemaphores)
+        {
+            signalSemaphoreValues.push_back(semaphore->getHandle());
+        }
+
+        return submit(
+            cmdBuffer,
+            utils::Span<const VkSemaphore>(waitSemaphoreValues.data(), waitSemaphoreValues.size()),
+            waitFlags,
+            utils::Span<const VkSemaphore>(
+                signalSemaphoreValues.data(), signalSemaphoreValues.size()),
+            fence);
+    }
+
+    template <typename CommandBuffer, typename TimelineSemaphore>
+    VkResult submitTimelineWrappers(
+        CommandBuffer& cmdBuffer,
+        const utils::Span<TimelineSemaphore* const> waitSemaphores,
+        const utils::Span<const VkPipelineStageFlags> waitFlags,
+        const utils::Span<const uint64_t> waitValues,
+        const utils::Span<TimelineSemaphore* const> signalSemaphores,
+        const utils::Span<const uint64_t> signalValues)
+    {
+        VKW_ASSERT(waitFlags.size() == waitSemaphores.size());
+        VKW_ASSERT(waitValues.size() == waitSemaphores.size());
+        VKW_ASSERT(signalValues.size() == signalSemaphores.size());
+
+        const auto handle = cmdBuffer.getHandle();
+
+        VkTimelineSemaphoreSubmitInfo semaphoreSubmitInfo = {};
+        semaphoreSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        semaphoreSubmitInfo.pNext = nullptr;
+        semaphoreSubmitInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitSemaphores.size());
+        semaphoreSubmitInfo.pWaitSemaphoreValues = waitValues.data();
+        semaphoreSubmitInfo.signalSemaphoreValueCount
+            = static_cast<uint32_t>(signalSemaphores.size());
+        semaphoreSubmitInfo.pSignalSemaphoreValues = signalValues.data();
+
+        utils::SmallVector<VkSemaphore, maxInlineSemaphoreCount> waitSemaphoreValues;
+        for(const auto* semaphore : waitSemaphores)
+        {
+            waitSemaphoreValues.push_back(semaphore->getHandle());
+        }
+
+        utils::SmallVector<VkSemaphore, maxInlineSemaphoreCount> signalSemaphoreValues;
+        for(const auto* semaphore : signalSemaphores)
+        {
+            signalSemaphoreValues.push_back(semaphore->getHandle());
+        }
+
+        VkSubmitInfo submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.pNext = &semaphoreSubmitInfo;
+        submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+        submitInfo.pWaitDstStageMask = waitFlags.data();
+        submitInfo.pWaitSemaphores = waitSemaphoreValues.data();
+        submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
+        submitInfo.pSignalSemaphores = signalSemaphoreValues.data();
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &(handle);
+        const auto queueLock = this->lock();
+        return vk->vkQueueSubmit(queue_, 1, &submitInfo, VK_NULL_HANDLE);
+    }
+
+    template <typename Swapchain, typename Semaphore>
+    VkResult presentWrappers(
+        Swapchain& swapchain,
+        const utils::Span<Semaphore* const> waitSemaphores,
+        const uint32_t imageIndex)
+    {
+        utils::SmallVector<VkSemaphore, maxInlineSemaphoreCount> waitSemaphoreValues;
+        for(const auto* semaphore : waitSemaphores)
+        {
+            waitSemaphoreValues.push_back(semaphore->getHandle());
+        }
+
+        return present(
+            swapchain,
+            utils::Span<const VkSemaphore>{waitSemaphoreValues.data(), waitSemaphoreValues.size()},
+            imageIndex);
+    }
+
     QueueUsageFlags flags_{0};
 
     uint32_t queueFamilyIndex_{0};
@@ -296,5 +783,9 @@ class Queue
 
     VkPhysicalDevice physicalDevice_{VK_NULL_HANDLE};
     VkQueue queue_{VK_NULL_HANDLE};
+
+    bool useSynchronization2_{false};
+
+    std::mutex* mutex_{nullptr}; ///< Owned by the device
 };
 } // namespace vkw
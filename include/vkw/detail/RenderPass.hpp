@@ -23,6 +23,7 @@
 #pragma once
 
 #include "vkw/detail/Common.hpp"
+#include "vkw/detail/DebugUtils.hpp"
 #include "vkw/detail/Device.hpp"
 
 #include <stdexcept>
@@ -53,6 +54,12 @@ class RenderPass
     VkRenderPass& getHandle() { return renderPass_; }
     const VkRenderPass& getHandle() const { return renderPass_; }
 
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(this->initialized());
+        debug::setObjectName(device_->getHandle(), VK_OBJECT_TYPE_RENDER_PASS, renderPass_, name);
+    }
+
     bool useDepth() const { return depthStencilAttachments_.size() > 0; }
 
     RenderPass& addColorAttachment(
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "vkw/detail/Common.hpp"
+#include "vkw/detail/DebugUtils.hpp"
 #include "vkw/detail/Device.hpp"
 #include "vkw/detail/utils.hpp"
 
@@ -59,6 +60,12 @@ class Sampler final
 
     VkSampler getHandle() const { return sampler_; }
 
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(this->initialized());
+        debug::setObjectName(device_->getHandle(), VK_OBJECT_TYPE_SAMPLER, sampler_, name);
+    }
+
     bool init(Device& device, const VkSamplerCreateInfo& createInfo)
     {
         if(!initialized_)
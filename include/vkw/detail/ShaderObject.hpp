@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "vkw/detail/Common.hpp"
+#include "vkw/detail/DebugUtils.hpp"
+#include "vkw/detail/Device.hpp"
+#include "vkw/detail/PipelineLayout.hpp"
+#include "vkw/detail/utils.hpp"
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace vkw
+{
+// Shaders created with VK_EXT_shader_object. No state is baked in: everything a pipeline would
+// hold is set with the dynamic state commands of CommandBuffer before drawing, so one shader
+// object serves every state combination of a material.
+// Stages are added like on GraphicsPipeline and created together, linked by default so that
+// the driver can optimize across stages. A compute shader object holds its compute stage only.
+class ShaderObject
+{
+  public:
+    ShaderObject() {}
+    explicit ShaderObject(Device& device);
+
+    ShaderObject(const ShaderObject&) = delete;
+    ShaderObject(ShaderObject&& cp);
+
+    ShaderObject& operator=(const ShaderObject&) = delete;
+    ShaderObject& operator=(ShaderObject&& cp);
+
+    ~ShaderObject();
+
+    bool init(Device& device);
+
+    void clear();
+
+    bool initialized() const { return initialized_; }
+
+    ShaderObject& addShaderStage(
+        const VkShaderStageFlagBits stage, const std::string& shaderSource);
+    ShaderObject& addShaderStage(
+        const VkShaderStageFlagBits stage, const char* srcData, const size_t byteCount);
+
+    template <typename T>
+    ShaderObject& addSpec(const VkShaderStageFlagBits stage, const T value)
+    {
+        static constexpr size_t size = sizeof(T);
+        const char* data = (char*) &value;
+
+        const int id = getStageIndex(stage);
+        if(id >= 0)
+        {
+            auto& info = stageInfo_[id];
+            for(size_t i = 0; i < size; i++)
+            {
+                info.specData.push_back(data[i]);
+            }
+            info.specSizes.push_back(size);
+        }
+
+        return *this;
+    }
+    template <typename T, typename... Args>
+    ShaderObject& addSpec(const VkShaderStageFlagBits stage, const T value, Args&&... args)
+    {
+        addSpec<T>(stage, value);
+        return addSpec(stage, std::forward<Args>(args)...);
+    }
+
+    // Shaders use the descriptor set layouts and push constant ranges of pipelineLayout, which is
+    // then used to bind descriptors and push constants.
+    bool createShaders(const PipelineLayout& pipelineLayout, const bool linked = true);
+
+    bool isCompute() const { return stageInfo_[computeStageIndex].used; }
+
+    // Every graphics stage, with null handles for the unused ones, so that binding them replaces
+    // all the shaders previously bound. Only the compute stage for compute shader objects.
+    uint32_t stageCount() const
+    {
+        return isCompute() ? 1 : static_cast<uint32_t>(computeStageIndex);
+    }
+    const VkShaderStageFlagBits* stages() const
+    {
+        return isCompute() ? &stageList[computeStageIndex] : stageList.data();
+    }
+    const VkShaderEXT* shaders() const
+    {
+        return isCompute() ? &shaders_[computeStageIndex] : shaders_.data();
+    }
+
+    VkShaderEXT getHandle(const VkShaderStageFlagBits stage) const
+    {
+        const int id = getStageIndex(stage);
+        return (id >= 0) ? shaders_[id] : VK_NULL_HANDLE;
+    }
+
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(this->initialized());
+        for(const auto shader : shaders_)
+        {
+            if(shader != VK_NULL_HANDLE)
+            {
+                debug::setObjectName(device_->getHandle(), VK_OBJECT_TYPE_SHADER_EXT, shader, name);
+            }
+        }
+    }
+
+  private:
+    static constexpr size_t maxStageCount = 8;
+    static constexpr size_t computeStageIndex = 7;
+
+    // In pipeline order, the order in which stages are linked
+    static constexpr std::array<VkShaderStageFlagBits, maxStageCount> stageList
+        = {VK_SHADER_STAGE_VERTEX_BIT,
+           VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT,
+           VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT,
+           VK_SHADER_STAGE_GEOMETRY_BIT,
+           VK_SHADER_STAGE_TASK_BIT_EXT,
+           VK_SHADER_STAGE_MESH_BIT_EXT,
+           VK_SHADER_STAGE_FRAGMENT_BIT,
+           VK_SHADER_STAGE_COMPUTE_BIT};
+
+    Device* device_{nullptr};
+
+    struct StageInfo
+    {
+        bool used{false};
+        std::vector<char> shaderSource{};
+        std::vector<char> specData{};
+        std::vector<size_t> specSizes{};
+    };
+    std::array<StageInfo, maxStageCount> stageInfo_{};
+    std::array<VkShaderEXT, maxStageCount> shaders_{};
+
+    bool initialized_{false};
+
+    static inline int32_t getStageIndex(const VkShaderStageFlagBits stage)
+    {
+        for(size_t i = 0; i < maxStageCount; ++i)
+        {
+            if(stageList[i] == stage)
+            {
+                return static_cast<int32_t>(i);
+            }
+        }
+        return -1;
+    }
+
+    bool validateStages() const;
+};
+} // namespace vkw
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "vkw/detail/Common.hpp"
+#include "vkw/detail/DebugUtils.hpp"
 #include "vkw/detail/Device.hpp"
 #include "vkw/detail/Image.hpp"
 #include "vkw/detail/ImageView.hpp"
@@ -110,6 +111,12 @@ class Swapchain
     VkSwapchainKHR& getHandle() { return swapchain_; }
     const VkSwapchainKHR& getHandle() const { return swapchain_; }
 
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(this->initialized());
+        debug::setObjectName(device_->getHandle(), VK_OBJECT_TYPE_SWAPCHAIN_KHR, swapchain_, name);
+    }
+
     VkExtent2D getExtent() const { return extent_; }
 
     VkFramebuffer& getFramebuffer(const size_t i) { return framebuffers_.at(i); }
@@ -23,10 +23,13 @@
 #pragma once
 
 #include "vkw/detail/Common.hpp"
+#include "vkw/detail/DebugUtils.hpp"
 #include "vkw/detail/Device.hpp"
 #include "vkw/detail/utils.hpp"
 
 #include <limits>
+#include <mutex>
+#include <vector>
 
 namespace vkw
 {
@@ -53,6 +56,12 @@ class Semaphore
     VkSemaphore& getHandle() { return semaphore_; }
     const VkSemaphore& getHandle() const { return semaphore_; }
 
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(this->initialized());
+        debug::setObjectName(device_->getHandle(), VK_OBJECT_TYPE_SEMAPHORE, semaphore_, name);
+    }
+
   private:
     Device* device_{nullptr};
     VkSemaphore semaphore_{VK_NULL_HANDLE};
@@ -86,6 +95,12 @@ class TimelineSemaphore
     VkSemaphore& getHandle() { return semaphore_; }
     const VkSemaphore& getHandle() const { return semaphore_; }
 
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(this->initialized());
+        debug::setObjectName(device_->getHandle(), VK_OBJECT_TYPE_SEMAPHORE, semaphore_, name);
+    }
+
     bool wait(const uint64_t waitValue, const uint64_t timeout = ~uint64_t(0))
     {
         VkSemaphoreWaitInfo waitInfo = {};
@@ -114,6 +129,13 @@ class TimelineSemaphore
         return true;
     }
 
+    uint64_t getValue() const
+    {
+        uint64_t value = 0;
+        device_->vk().vkGetSemaphoreCounterValue(device_->getHandle(), semaphore_, &value);
+        return value;
+    }
+
   private:
     Device* device_{nullptr};
     VkSemaphore semaphore_{VK_NULL_HANDLE};
@@ -190,6 +212,12 @@ class Fence
     VkFence& getHandle() { return fence_; }
     const VkFence& getHandle() const { return fence_; }
 
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(this->initialized());
+        debug::setObjectName(device_->getHandle(), VK_OBJECT_TYPE_FENCE, fence_, name);
+    }
+
   private:
     Device* device_{nullptr};
     VkFence fence_{VK_NULL_HANDLE};
@@ -219,9 +247,113 @@ class Event
     VkEvent& getHandle() { return event_; }
     const VkEvent& getHandle() const { return event_; }
 
+    void setName(const char* name) const
+    {
+        VKW_ASSERT(this->initialized());
+        debug::setObjectName(device_->getHandle(), VK_OBJECT_TYPE_EVENT, event_, name);
+    }
+
   private:
     Device* device_{nullptr};
     VkEvent event_{VK_NULL_HANDLE};
     bool initialized_{false};
 };
+
+// Recycles fences instead of creating one per submission. Fences are handed out unsignaled and
+// are reset and reused once signaled, released fences that are still pending are kept aside until
+// then. Thread safe. clear() waits for the pending fences, it is meant to be called once the
+// device is idle.
+class FencePool
+{
+  public:
+    FencePool() {}
+    FencePool(Device& device) { VKW_CHECK_BOOL_FAIL(this->init(device), "Creating fence pool"); }
+
+    FencePool(const FencePool&) = delete;
+    FencePool(FencePool&&) = delete;
+
+    FencePool& operator=(const FencePool&) = delete;
+    FencePool& operator=(FencePool&&) = delete;
+
+    ~FencePool() { this->clear(); }
+
+    bool init(Device& device);
+
+    void clear();
+
+    bool initialized() const { return initialized_; }
+
+    Fence acquire();
+    // Fences that were never submitted, for instance after a failed submission, are unsignaled
+    // and returned to the free list directly, submitted must be false then
+    void release(Fence&& fence, const bool submitted = true);
+
+  private:
+    Device* device_{nullptr};
+
+    std::mutex mutex_{};
+    std::vector<Fence> freeFences_{};
+    std::vector<Fence> pendingFences_{};
+
+    bool initialized_{false};
+
+    void collectPending();
+};
+
+// Recycles binary semaphores. A semaphore can only be reused once the wait consuming it has
+// completed, either known by the caller or tracked through a fence or a timeline value. Thread
+// safe. clear() waits for the pending releases, it is meant to be called once the device is idle
+// and before the fences and timeline semaphores they refer to are destroyed.
+class SemaphorePool
+{
+  public:
+    SemaphorePool() {}
+    SemaphorePool(Device& device)
+    {
+        VKW_CHECK_BOOL_FAIL(this->init(device), "Creating semaphore pool");
+    }
+
+    SemaphorePool(const SemaphorePool&) = delete;
+    SemaphorePool(SemaphorePool&&) = delete;
+
+    SemaphorePool& operator=(const SemaphorePool&) = delete;
+    SemaphorePool& operator=(SemaphorePool&&) = delete;
+
+    ~SemaphorePool() { this->clear(); }
+
+    bool init(Device& device);
+
+    void clear();
+
+    bool initialized() const { return initialized_; }
+
+    Semaphore acquire();
+
+    // The wait consuming the semaphore must have completed
+    void release(Semaphore&& semaphore);
+    // Recycled once the fence of the submission waiting on the semaphore is signaled, the fence
+    // must outlive the pending release
+    void release(Semaphore&& semaphore, const Fence& fence);
+    // Recycled once timeline reaches value, the timeline semaphore must outlive the pending release
+    void release(Semaphore&& semaphore, const TimelineSemaphore& timeline, const uint64_t value);
+
+  private:
+    struct PendingSemaphore
+    {
+        Semaphore semaphore;
+        VkFence fence;
+        VkSemaphore timeline;
+        uint64_t value;
+    };
+
+    Device* device_{nullptr};
+
+    std::mutex mutex_{};
+    std::vector<Semaphore> freeSemaphores_{};
+    std::vector<PendingSemaphore> pendingSemaphores_{};
+
+    bool initialized_{false};
+
+    void collectPending();
+};
 } // namespace vkw
\ No newline at end of file
@@ -22,8 +22,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <initializer_list>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <volk.h>
 
@@ -378,6 +383,167 @@ namespace utils
 
     inline uint32_t divUp(const uint32_t n, const uint32_t val) { return (n + val - 1) / val; }
 
+    // Identifies one instance of a Vulkan object. Values are unique in the process and never
+    // reused, unlike handle values which the driver may hand out again after a destruction.
+    inline uint64_t nextGeneration()
+    {
+        static std::atomic<uint64_t> generation{0};
+        return generation.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    // Non owning view over contiguous elements, stand-in for C++20 std::span. Implicitly built
+    // from C arrays, initializer lists and any container exposing data() and size().
+    template <typename T>
+    class Span
+    {
+      public:
+        using value_type = std::remove_cv_t<T>;
+
+        constexpr Span() noexcept {}
+        constexpr Span(T* data, const size_t size) noexcept : data_{data}, size_{size} {}
+
+        template <size_t N>
+        constexpr Span(T (&array)[N]) noexcept : data_{array}, size_{N} {}
+
+        template <typename U = T, typename = std::enable_if_t<std::is_const<U>::value>>
+        constexpr Span(std::initializer_list<value_type> list) noexcept
+            : data_{list.begin()}, size_{list.size()}
+        {}
+
+        template <
+            typename Container,
+            typename = std::enable_if_t<
+                std::is_convertible<decltype(std::declval<Container&>().data()), T*>::value>>
+        constexpr Span(Container&& container) noexcept
+            : data_{container.data()}, size_{static_cast<size_t>(container.size())}
+        {}
+
+        constexpr T* data() const noexcept { return data_; }
+        constexpr size_t size() const noexcept { return size_; }
+        constexpr bool empty() const noexcept { return size_ == 0; }
+
+        constexpr T& operator[](const size_t i) const noexcept { return data_[i]; }
+
+        constexpr T* begin() const noexcept { return data_; }
+        constexpr T* end() const noexcept { return data_ + size_; }
+
+      private:
+        T* data_{nullptr};
+        size_t size_{0};
+    };
+
+    // Vector keeping its first N elements inline, used to build temporary arrays of Vulkan
+    // structures while recording without touching the heap. Spills to a std::vector beyond N.
+    template <typename T, size_t N>
+    class SmallVector
+    {
+      public:
+        static_assert(std::is_trivially_copyable<T>::value, "SmallVector only holds POD types");
+
+        SmallVector() {}
+
+        SmallVector(const SmallVector&) = delete;
+        SmallVector& operator=(const SmallVector&) = delete;
+
+        void push_back(const T& value)
+        {
+            if(size_ < N)
+            {
+                inline_[size_++] = value;
+                return;
+            }
+            if(heap_.empty())
+            {
+                heap_.reserve(2 * N);
+                heap_.assign(inline_, inline_ + N);
+            }
+            heap_.push_back(value);
+            size_++;
+        }
+
+        T& emplace_back()
+        {
+            push_back(T{});
+            return back();
+        }
+
+        T* data() noexcept { return heap_.empty() ? inline_ : heap_.data(); }
+        const T* data() const noexcept { return heap_.empty() ? inline_ : heap_.data(); }
+
+        size_t size() const noexcept { return size_; }
+        bool empty() const noexcept { return size_ == 0; }
+
+        T& operator[](const size_t i) noexcept { return data()[i]; }
+        const T& operator[](const size_t i) const noexcept { return data()[i]; }
+
+        T& back() noexcept { return data()[size_ - 1]; }
+
+      private:
+        T inline_[N];
+        std::vector<T> heap_{};
+        size_t size_{0};
+    };
+
+    // Unbounded multi-producer single-consumer queue. Producers never lock or wait on each other,
+    // a push costs one node allocation and one atomic exchange. Only a single thread may pop.
+    template <typename T>
+    class MpscQueue
+    {
+      public:
+        MpscQueue()
+        {
+            auto* stub = new Node{};
+            head_.store(stub, std::memory_order_relaxed);
+            tail_ = stub;
+        }
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        ~MpscQueue()
+        {
+            T value{};
+            while(pop(value)) {}
+            delete tail_;
+        }
+
+        void push(T&& value)
+        {
+            auto* node = new Node{};
+            node->value = std::move(value);
+            auto* prev = head_.exchange(node, std::memory_order_acq_rel);
+            prev->next.store(node, std::memory_order_release);
+        }
+
+        // Consumer only. May miss an element whose push has not completed yet.
+        bool pop(T& value)
+        {
+            auto* tail = tail_;
+            auto* next = tail->next.load(std::memory_order_acquire);
+            if(next == nullptr)
+            {
+                return false;
+            }
+            value = std::move(next->value);
+            tail_ = next;
+            delete tail;
+            return true;
+        }
+
+        // Consumer only
+        bool empty() const { return tail_->next.load(std::memory_order_acquire) == nullptr; }
+
+      private:
+        struct Node
+        {
+            std::atomic<Node*> next{nullptr};
+            T value{};
+        };
+
+        std::atomic<Node*> head_{nullptr};
+        Node* tail_{nullptr};
+    };
+
     VkShaderModule createShaderModule(
         const VolkDeviceTable& vk, const VkDevice device, const std::vector<char>& src);
 
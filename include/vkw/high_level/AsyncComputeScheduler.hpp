@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "vkw/high_level/GpuFuture.hpp"
+#include "vkw/vkw.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace vkw
+{
+// Runs compute passes on their own queue, ideally from a compute-only family obtained with
+// Device::getPreferredQueues(), so that they overlap with graphics work. Every pass signals the
+// next value of a timeline semaphore owned by the scheduler. Graphics submissions consume the
+// results by waiting on that value, and a pass may itself wait on a value of another timeline.
+// Command buffers are recycled once the pass using them has completed, so at most
+// maxPassesInFlight passes are pending at any time.
+// The device must enable timeline semaphores. Exclusive resources shared with graphics must be
+// transferred with the ownership helpers of CommandBuffer when the queue families differ.
+class AsyncComputeScheduler
+{
+  public:
+    static constexpr uint32_t defaultMaxPassesInFlight = 4;
+
+    AsyncComputeScheduler() {}
+    AsyncComputeScheduler(
+        Device& device,
+        const Queue& computeQueue,
+        const uint32_t maxPassesInFlight = defaultMaxPassesInFlight)
+    {
+        VKW_CHECK_BOOL_FAIL(
+            this->init(device, computeQueue, maxPassesInFlight),
+            "Initializing async compute scheduler");
+    }
+
+    AsyncComputeScheduler(const AsyncComputeScheduler&) = delete;
+    AsyncComputeScheduler(AsyncComputeScheduler&& cp) { *this = std::move(cp); }
+
+    AsyncComputeScheduler& operator=(const AsyncComputeScheduler&) = delete;
+    AsyncComputeScheduler& operator=(AsyncComputeScheduler&& cp)
+    {
+        this->clear();
+        std::swap(device_, cp.device_);
+        std::swap(queue_, cp.queue_);
+        std::swap(cmdPool_, cp.cmdPool_);
+        std::swap(cmdBuffers_, cp.cmdBuffers_);
+        std::swap(slotValues_, cp.slotValues_);
+        std::swap(timeline_, cp.timeline_);
+        std::swap(batch_, cp.batch_);
+        std::swap(lastValue_, cp.lastValue_);
+        std::swap(initialized_, cp.initialized_);
+        return *this;
+    }
+
+    ~AsyncComputeScheduler() { this->clear(); }
+
+    bool init(
+        Device& device,
+        const Queue& computeQueue,
+        const uint32_t maxPassesInFlight = defaultMaxPassesInFlight)
+    {
+        VKW_ASSERT(this->initialized() == false);
+        VKW_ASSERT(maxPassesInFlight > 0);
+        VKW_ASSERT(computeQueue.flags() & QueueUsageBits::Compute);
+
+        device_ = &device;
+        queue_ = computeQueue;
+
+        VKW_INIT_CHECK_BOOL(cmdPool_.init(*device_, queue_));
+        cmdBuffers_ = cmdPool_.createCommandBuffers(maxPassesInFlight);
+        VKW_INIT_CHECK_BOOL(cmdBuffers_.size() == maxPassesInFlight);
+        slotValues_.assign(maxPassesInFlight, 0);
+
+        VKW_INIT_CHECK_BOOL(timeline_.init(*device_, 0));
+        lastValue_ = 0;
+
+        initialized_ = true;
+
+        return true;
+    }
+
+    void clear()
+    {
+        if(initialized_)
+        {
+            this->waitIdle();
+        }
+
+        batch_.clear();
+        timeline_.clear();
+        slotValues_.clear();
+        cmdBuffers_.clear();
+        cmdPool_.clear();
+
+        queue_ = {};
+        lastValue_ = 0;
+
+        device_ = nullptr;
+        initialized_ = false;
+    }
+
+    bool initialized() const { return initialized_; }
+
+    // Records a pass with recordFn(CommandBuffer&) and submits it. When waitSemaphore is set the
+    // pass waits for waitValue on it, which must then be a timeline semaphore. Returns the value
+    // signaled once the pass completes, 0 on failure.
+    template <typename Fn>
+    uint64_t submit(
+        Fn&& recordFn,
+        const VkSemaphore waitSemaphore = VK_NULL_HANDLE,
+        const uint64_t waitValue = 0,
+        const VkPipelineStageFlags2 waitStages = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT)
+    {
+        VKW_ASSERT(this->initialized());
+
+        const uint64_t value = lastValue_ + 1;
+        const size_t slot = static_cast<size_t>(value % cmdBuffers_.size());
+
+        // Command buffer can only be recorded again once the previous pass using it has completed
+        if(!timeline_.wait(slotValues_[slot]))
+        {
+            return 0;
+        }
+
+        auto& cmdBuffer = cmdBuffers_[slot];
+        if(!cmdBuffer.reset() || !cmdBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT))
+        {
+            return 0;
+        }
+        recordFn(cmdBuffer);
+        if(!cmdBuffer.end())
+        {
+            return 0;
+        }
+
+        batch_.addCommandBuffer(cmdBuffer);
+        batch_.addSignal(timeline_, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, value);
+        if(waitSemaphore != VK_NULL_HANDLE)
+        {
+            batch_.addWait(waitSemaphore, waitStages, waitValue);
+        }
+        if(queue_.submit(batch_) != VK_SUCCESS)
+        {
+            utils::Log::Error("vkw", "Error submitting async compute pass");
+            return 0;
+        }
+
+        slotValues_[slot] = value;
+        lastValue_ = value;
+
+        return value;
+    }
+
+    // Makes the current submission of a graphics batch wait for a pass
+    void waitForPass(
+        SubmitBatch& batch, const uint64_t passValue, const VkPipelineStageFlags2 stages) const
+    {
+        VKW_ASSERT(this->initialized());
+        batch.addWait(timeline_, stages, passValue);
+    }
+
+    // Future completed with the pass, continuations run on the given pool
+    GpuFuture<> getFuture(const uint64_t passValue, CompletionPool& pool) const
+    {
+        VKW_ASSERT(this->initialized());
+        return GpuFuture<>(pool, timeline_.getHandle(), passValue);
+    }
+
+    bool isComplete(const uint64_t passValue) const { return timeline_.getValue() >= passValue; }
+
+    bool wait(const uint64_t passValue, const uint64_t timeout = ~uint64_t(0))
+    {
+        VKW_ASSERT(this->initialized());
+        return timeline_.wait(passValue, timeout);
+    }
+
+    bool waitIdle() { return wait(lastValue_); }
+
+    uint64_t lastSubmittedValue() const { return lastValue_; }
+
+    const TimelineSemaphore& semaphore() const { return timeline_; }
+    const Queue& queue() const { return queue_; }
+
+  private:
+    Device* device_{nullptr};
+
+    Queue queue_{};
+    CommandPool cmdPool_{};
+    std::vector<CommandBuffer> cmdBuffers_{};
+    std::vector<uint64_t> slotValues_{}; ///< Value signaled by the last pass using each buffer
+
+    TimelineSemaphore timeline_{};
+    SubmitBatch batch_{};
+    uint64_t lastValue_{0};
+
+    bool initialized_{false};
+};
+} // namespace vkw
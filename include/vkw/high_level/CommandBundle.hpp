@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "vkw/vkw.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+namespace vkw
+{
+// Location of a parameter inside the parameter buffer of a CommandBundle
+template <typename T>
+struct BundleSlot
+{
+    VkDeviceSize offset{0};
+    uint32_t count{0};
+
+    VkDeviceSize sizeBytes() const { return count * sizeof(T); }
+};
+
+// Command buffer recorded once and executed many times. Values that change from one execution
+// to the next live in slots of a host visible parameter buffer, to be read by shaders as uniform
+// or storage buffers, or used as indirect arguments. Updating a slot does not require recording
+// again. The bundle is recorded again on prepare() when it has been invalidated, either
+// explicitly or because one of the resources passed to prepare() has been created again.
+// Resources are identified by their generation and not by their handle value, which the driver
+// may reuse, and the bundle keeps no reference to them.
+// Slots are written directly, so a bundle must not be updated while it is pending execution:
+// use one bundle per frame in flight.
+// Secondary bundles are executed with CommandBuffer::executeCommands() outside of a render pass,
+// primary bundles are submitted as is. The command pool must allow resetting command buffers.
+class CommandBundle
+{
+  public:
+    using RecordFunction = std::function<void(CommandBuffer&)>;
+
+    CommandBundle() {}
+    CommandBundle(
+        Device& device,
+        CommandPool& commandPool,
+        const VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_SECONDARY)
+    {
+        VKW_CHECK_BOOL_FAIL(this->init(device, commandPool, level), "Initializing command bundle");
+    }
+
+    CommandBundle(const CommandBundle&) = delete;
+    CommandBundle(CommandBundle&& cp) { *this = std::move(cp); }
+
+    CommandBundle& operator=(const CommandBundle&) = delete;
+    CommandBundle& operator=(CommandBundle&& cp)
+    {
+        this->clear();
+        std::swap(device_, cp.device_);
+        std::swap(cmdBuffer_, cp.cmdBuffer_);
+        std::swap(level_, cp.level_);
+        std::swap(parameters_, cp.parameters_);
+        std::swap(parameterSize_, cp.parameterSize_);
+        std::swap(slotAlignment_, cp.slotAlignment_);
+        std::swap(recordFunction_, cp.recordFunction_);
+        std::swap(generations_, cp.generations_);
+        std::swap(recordCount_, cp.recordCount_);
+        std::swap(dirty_, cp.dirty_);
+        std::swap(initialized_, cp.initialized_);
+        return *this;
+    }
+
+    ~CommandBundle() { this->clear(); }
+
+    bool init(
+        Device& device,
+        CommandPool& commandPool,
+        const VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_SECONDARY)
+    {
+        VKW_ASSERT(this->initialized() == false);
+
+        device_ = &device;
+        level_ = level;
+
+        cmdBuffer_ = commandPool.createCommandBuffer(level_);
+        VKW_INIT_CHECK_BOOL(cmdBuffer_.initialized());
+
+        // Slots may be bound as uniform or storage buffers, or used as indirect arguments
+        const auto& limits = device_->getProperties().limits;
+        slotAlignment_ = std::max(
+            {limits.minUniformBufferOffsetAlignment,
+             limits.minStorageBufferOffsetAlignment,
+             VkDeviceSize(16)});
+        parameterSize_ = 0;
+
+        recordCount_ = 0;
+        dirty_ = true;
+        initialized_ = true;
+
+        return true;
+    }
+
+    void clear()
+    {
+        cmdBuffer_.clear();
+        parameters_.clear();
+
+        parameterSize_ = 0;
+        slotAlignment_ = 0;
+        recordFunction_ = {};
+        generations_.clear();
+        recordCount_ = 0;
+        dirty_ = true;
+
+        device_ = nullptr;
+        initialized_ = false;
+    }
+
+    bool initialized() const { return initialized_; }
+
+    // Slots must all be reserved before the parameter buffer is created
+    template <typename T>
+    BundleSlot<T> addSlot(const uint32_t count = 1)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Bundle parameters must be POD");
+        VKW_ASSERT(this->initialized());
+        VKW_ASSERT(!parameters_.initialized());
+
+        BundleSlot<T> slot{};
+        slot.offset = utils::alignedSize(parameterSize_, slotAlignment_);
+        slot.count = count;
+        parameterSize_ = slot.offset + slot.sizeBytes();
+        return slot;
+    }
+
+    // Called by the first record() if needed, call it sooner to create descriptor sets
+    // referencing the slots
+    bool createParameterBuffer()
+    {
+        VKW_ASSERT(this->initialized());
+        if(parameters_.initialized() || parameterSize_ == 0)
+        {
+            return true;
+        }
+
+        VKW_CHECK_BOOL_RETURN_FALSE(parameters_.init(*device_, 0, parameterSize_));
+        std::memset(parameters_.data(), 0, parameterSize_);
+        return true;
+    }
+
+    template <typename T>
+    void setSlot(const BundleSlot<T>& slot, const T& value, const uint32_t index = 0)
+    {
+        VKW_ASSERT(parameters_.initialized());
+        VKW_ASSERT(index < slot.count);
+        std::memcpy(parameters_.data() + slot.offset + index * sizeof(T), &value, sizeof(T));
+    }
+
+    template <typename T>
+    void setSlot(const BundleSlot<T>& slot, const T* values, const uint32_t count)
+    {
+        VKW_ASSERT(parameters_.initialized());
+        VKW_ASSERT(count <= slot.count);
+        std::memcpy(parameters_.data() + slot.offset, values, count * sizeof(T));
+    }
+
+    // Records the bundle, the function is kept to record it again after an invalidation. The
+    // resources are the ones given to prepare() afterwards.
+    template <typename... Resources>
+    bool record(RecordFunction&& recordFunction, const Resources&... resources)
+    {
+        VKW_ASSERT(this->initialized());
+
+        recordFunction_ = std::move(recordFunction);
+        dirty_ = true;
+        return prepare(resources...);
+    }
+
+    void invalidate() { dirty_ = true; }
+
+    // Records the bundle again if it has been invalidated or if one of the resources used by the
+    // recorded commands has been created again since the last recording. Resources must expose
+    // generation() and be given in the same order on each call. Must be called while the bundle
+    // is not pending execution.
+    template <typename... Resources>
+    bool prepare(const Resources&... resources)
+    {
+        VKW_ASSERT(this->initialized());
+        VKW_ASSERT(recordFunction_);
+
+        // Leading 0 to support an empty list
+        const uint64_t generations[] = {0, resources.generation()...};
+        const size_t count = sizeof...(Resources);
+        if(!dirty_ && generations_.size() == count
+           && std::equal(generations + 1, generations + 1 + count, generations_.begin()))
+        {
+            return true;
+        }
+
+        VKW_CHECK_BOOL_RETURN_FALSE(createParameterBuffer());
+
+        if(level_ == VK_COMMAND_BUFFER_LEVEL_SECONDARY)
+        {
+            VkCommandBufferInheritanceInfo inheritanceInfo = {};
+            inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+            inheritanceInfo.pNext = nullptr;
+            inheritanceInfo.renderPass = VK_NULL_HANDLE;
+            inheritanceInfo.subpass = 0;
+            inheritanceInfo.framebuffer = VK_NULL_HANDLE;
+            VKW_CHECK_BOOL_RETURN_FALSE(cmdBuffer_.begin(0, inheritanceInfo));
+        }
+        else
+        {
+            VKW_CHECK_BOOL_RETURN_FALSE(cmdBuffer_.begin(0));
+        }
+        recordFunction_(cmdBuffer_);
+        VKW_CHECK_BOOL_RETURN_FALSE(cmdBuffer_.end());
+
+        generations_.assign(generations + 1, generations + 1 + count);
+        recordCount_++;
+        dirty_ = false;
+
+        return true;
+    }
+
+    // Number of times the bundle has been recorded
+    uint32_t recordCount() const { return recordCount_; }
+
+    CommandBuffer& commandBuffer() { return cmdBuffer_; }
+    const CommandBuffer& commandBuffer() const { return cmdBuffer_; }
+
+    const auto& parameterBuffer() const { return parameters_; }
+
+  private:
+    Device* device_{nullptr};
+
+    CommandBuffer cmdBuffer_{};
+    VkCommandBufferLevel level_{VK_COMMAND_BUFFER_LEVEL_SECONDARY};
+
+    Buffer<
+        uint8_t,
+        MemoryType::HostStaging,
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+            | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT>
+        parameters_{};
+    VkDeviceSize parameterSize_{0};
+    VkDeviceSize slotAlignment_{0};
+
+    RecordFunction recordFunction_{};
+    std::vector<uint64_t> generations_{};
+
+    uint32_t recordCount_{0};
+    bool dirty_{true};
+
+    bool initialized_{false};
+};
+} // namespace vkw
@@ -36,33 +36,53 @@ class ComputeProgram
     using constant_type = PushConstants;
 
     ComputeProgram() = delete;
+
+    // With usePushDescriptors, descriptors are pushed straight into the command buffer with
+    // bindComputeProgram(program, writes) and no pool or descriptor set is allocated. This
+    // requires VK_KHR_push_descriptor to be enabled on the device.
     ComputeProgram(
-        const Device& device,
+        Device& device,
         const std::string& shaderSource,
-        const uint32_t descriptorSetCount = 1)
-        : device_{device}, descriptorSetCount_{descriptorSetCount}
+        const uint32_t descriptorSetCount = 1,
+        const bool usePushDescriptors = false)
+        : device_{device}
+        , descriptorSetCount_{descriptorSetCount}
+        , usePushDescriptors_{usePushDescriptors}
     {
+        VKW_CHECK_BOOL_FAIL(
+            !usePushDescriptors_
+                || device_.isExtensionEnabled(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME),
+            "Push descriptors require VK_KHR_push_descriptor");
+
         descriptorSetLayout_.init(device_);
-        addDescriptors(descriptorTypes, 0);
-        descriptorSetLayout_.create();
+        if constexpr(sizeof...(descriptorTypes) > 0)
+        {
+            addDescriptors<descriptorTypes...>(0);
+        }
+        descriptorSetLayout_.setPushDescriptor(usePushDescriptors_).create();
 
         pipelineLayout_.init(device_, descriptorSetLayout_);
         pipelineLayout_.reservePushConstants<PushConstants>(ShaderStage::Compute).create();
 
-        computePipeline_.init(device, shaderSource);
+        computePipeline_.init(device_, shaderSource);
     }
 
     template <typename... Args>
-    ComputeProgram& spec(Args...&& args)
+    ComputeProgram& spec(Args&&... args)
     {
         computePipeline_.addSpec(std::forward<Args>(args)...);
         return *this;
     }
 
-    ComputeProgram& build()
+    bool build()
     {
         VKW_CHECK_BOOL_RETURN_FALSE(computePipeline_.createPipeline(pipelineLayout_));
 
+        if(usePushDescriptors_)
+        {
+            return true;
+        }
+
         std::vector<VkDescriptorPoolSize> poolSizes = {};
         for(uint32_t i = 0; i < vkw::descriptorTypeCount; ++i)
         {
@@ -76,24 +96,32 @@ class ComputeProgram
             }
         }
         VKW_CHECK_BOOL_RETURN_FALSE(descriptorPool_.init(device_, descriptorSetCount_, poolSizes));
-        descriptorSets_
-            = descriptorPool_.allocateDescriptorSets(descriptorSetLayout_, descriptorSetCount_);
 
-        return *this;
+        descriptorSets_.resize(descriptorSetCount_);
+        for(auto& descriptorSet : descriptorSets_)
+        {
+            VKW_CHECK_BOOL_RETURN_FALSE(
+                descriptorSet.init(device_, descriptorSetLayout_, descriptorPool_));
+        }
+
+        return true;
     }
 
+    bool usePushDescriptors() const { return usePushDescriptors_; }
+
     auto& descriptorSet(const size_t i) { return descriptorSets_.at(i); }
     const auto& descriptorSet(const size_t i) const { return descriptorSets_.at(i); }
 
     const auto& device() const { return device_; }
-    const auto& pipeline() const { return computePipeline_ };
-    const auto& pipelineLayout pipelineLayout() const { return pipelineLayout_; }
+    const auto& pipeline() const { return computePipeline_; }
+    const auto& pipelineLayout() const { return pipelineLayout_; }
 
   private:
     friend class CommandBuffer;
 
     Device& device_;
     const uint32_t descriptorSetCount_;
+    const bool usePushDescriptors_;
 
     ComputePipeline computePipeline_{};
 
@@ -106,18 +134,16 @@ class ComputeProgram
     uint32_t descriptorCounts_[vkw::descriptorTypeCount]{};
 
     // Initialize descriptor set layout
-    template <DescriptorType>
-    void addDescriptor(const uint32_t binding, const DescriptorType descriptorType)
+    template <DescriptorType descriptorType, DescriptorType... others>
+    void addDescriptors(const uint32_t binding)
     {
         descriptorSetLayout_.addBinding<descriptorType>(VK_SHADER_STAGE_COMPUTE_BIT, binding);
         descriptorCounts_[static_cast<uint32_t>(descriptorType)]++;
-    }
-    template <DescriptorType... descriptorTypes>
-    void addDescriptors(
-        const uint32_t binding, DescriptorType descriptorType, DescriptorTypes...&& descriptorTypes)
-    {
-        addDescriptor(binding, descriptorType);
-        addDescriptors(binding + 1, std::forward<DescriptorTypes>(descriptorTypes)...);
+
+        if constexpr(sizeof...(others) > 0)
+        {
+            addDescriptors<others...>(binding + 1);
+        }
     }
 };
-} // namespace vkw
\ No newline at end of file
+} // namespace vkw
@@ -0,0 +1,420 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include "vkw/vkw.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+namespace vkw
+{
+struct CopyBatchStats
+{
+    uint32_t requestedCopies{0};
+    uint32_t recordedRegions{0};
+    uint32_t copyCalls{0};
+    uint32_t updateCalls{0};
+    uint32_t barriers{0};
+};
+
+// Collects many small transfers and records them with as few commands as possible. Buffer copies
+// are sorted by (source, destination) and contiguous regions are merged, copies to images are
+// grouped by (source, destination, layout). Updates are recorded inline with vkCmdUpdateBuffer,
+// in chunks of at most CommandBuffer::maxUpdateBufferSize, and need no staging buffer.
+// Transfers of a batch are not ordered with each other, their destinations must not overlap.
+// Updates are recorded first, then buffer copies and buffer to image copies, with a transfer
+// barrier between phases so that a copy can read what a previous phase wrote.
+class CopyBatcher
+{
+  public:
+    CopyBatcher() {}
+
+    CopyBatcher& copyBuffer(
+        const VkBuffer src,
+        const VkBuffer dst,
+        const VkDeviceSize srcOffset,
+        const VkDeviceSize dstOffset,
+        const VkDeviceSize size)
+    {
+        if(size == 0)
+        {
+            return *this;
+        }
+
+        BufferCopy copy{};
+        copy.src = src;
+        copy.dst = dst;
+        copy.region.srcOffset = srcOffset;
+        copy.region.dstOffset = dstOffset;
+        copy.region.size = size;
+        bufferCopies_.push_back(copy);
+        return *this;
+    }
+
+    // Offsets and count in elements
+    template <typename SrcBufferType, typename DstBufferType>
+    CopyBatcher& copyBuffer(
+        const SrcBufferType& src,
+        const DstBufferType& dst,
+        const size_t srcOffset,
+        const size_t dstOffset,
+        const size_t count)
+    {
+        using T = typename SrcBufferType::value_type;
+        static_assert(
+            std::is_same<T, typename DstBufferType::value_type>::value,
+            "Buffer types mismatch");
+        VKW_ASSERT(srcOffset + count <= src.size());
+        VKW_ASSERT(dstOffset + count <= dst.size());
+
+        return copyBuffer(
+            src.getHandle(),
+            dst.getHandle(),
+            srcOffset * sizeof(T),
+            dstOffset * sizeof(T),
+            count * sizeof(T));
+    }
+
+    CopyBatcher& copyBufferToImage(
+        const VkBuffer src,
+        const VkImage dst,
+        const VkImageLayout dstLayout,
+        const VkBufferImageCopy& region)
+    {
+        ImageCopy copy{};
+        copy.src = src;
+        copy.dst = dst;
+        copy.layout = dstLayout;
+        copy.region = region;
+        imageCopies_.push_back(copy);
+        return *this;
+    }
+
+    template <typename SrcBufferType, typename DstImageType>
+    CopyBatcher& copyBufferToImage(
+        const SrcBufferType& src,
+        const DstImageType& dst,
+        const VkImageLayout dstLayout,
+        const VkBufferImageCopy& region)
+    {
+        return copyBufferToImage(src.getHandle(), dst.getHandle(), dstLayout, region);
+    }
+
+    // Data is copied into the batch. Offset and size in bytes, both multiples of 4, returns false
+    // otherwise. Updates larger than CommandBuffer::maxUpdateBufferSize are split, prefer a staging
+    // copy for large transfers since the data is stored in the command buffer.
+    bool updateBuffer(
+        const VkBuffer dst, const VkDeviceSize offset, const void* data, const VkDeviceSize size)
+    {
+        if((size % 4) != 0 || (offset % 4) != 0)
+        {
+            utils::Log::Error(
+                "vkw",
+                "CopyBatcher: misaligned buffer update (offset %llu, size %llu)",
+                static_cast<unsigned long long>(offset),
+                static_cast<unsigned long long>(size));
+            return false;
+        }
+
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for(VkDeviceSize chunkOffset = 0; chunkOffset < size;
+            chunkOffset += CommandBuffer::maxUpdateBufferSize)
+        {
+            BufferUpdate update{};
+            update.dst = dst;
+            update.offset = offset + chunkOffset;
+            update.size = std::min(size - chunkOffset, CommandBuffer::maxUpdateBufferSize);
+            update.dataOffset = updateData_.size();
+            updates_.push_back(update);
+
+            updateData_.resize(updateData_.size() + static_cast<size_t>(update.size));
+            memcpy(
+                updateData_.data() + update.dataOffset,
+                bytes + chunkOffset,
+                static_cast<size_t>(update.size));
+        }
+        return true;
+    }
+
+    // Offset and count in elements
+    template <typename BufferType>
+    bool updateBuffer(
+        const BufferType& dst,
+        const typename BufferType::value_type* data,
+        const size_t count,
+        const size_t offset = 0)
+    {
+        using T = typename BufferType::value_type;
+        VKW_ASSERT(offset + count <= dst.size());
+
+        return updateBuffer(dst.getHandle(), offset * sizeof(T), data, count * sizeof(T));
+    }
+
+    bool empty() const
+    {
+        return bufferCopies_.empty() && imageCopies_.empty() && updates_.empty();
+    }
+
+    // Drops pending transfers, allocated storage is kept for the next batch
+    void clear()
+    {
+        bufferCopies_.clear();
+        imageCopies_.clear();
+        updates_.clear();
+        updateData_.clear();
+    }
+
+    // Records every pending transfer in cmdBuffer and empties the batch
+    CopyBatchStats flush(CommandBuffer& cmdBuffer)
+    {
+        VKW_ASSERT(cmdBuffer.recording_);
+
+        CopyBatchStats stats{};
+        stats.requestedCopies = static_cast<uint32_t>(
+            bufferCopies_.size() + imageCopies_.size() + updates_.size());
+
+        const auto& vk = cmdBuffer.device_->vk();
+        const auto cmd = cmdBuffer.commandBuffer_;
+
+        bool pendingWrites = false;
+        if(!updates_.empty())
+        {
+            recordUpdates(vk, cmd, stats);
+            pendingWrites = true;
+        }
+        if(!bufferCopies_.empty())
+        {
+            if(pendingWrites)
+            {
+                recordTransferBarrier(vk, cmd, stats);
+            }
+            recordBufferCopies(vk, cmd, stats);
+            pendingWrites = true;
+        }
+        if(!imageCopies_.empty())
+        {
+            if(pendingWrites)
+            {
+                recordTransferBarrier(vk, cmd, stats);
+            }
+            recordImageCopies(vk, cmd, stats);
+        }
+
+        this->clear();
+        return stats;
+    }
+
+  private:
+    struct BufferCopy
+    {
+        VkBuffer src;
+        VkBuffer dst;
+        VkBufferCopy region;
+    };
+
+    struct ImageCopy
+    {
+        VkBuffer src;
+        VkImage dst;
+        VkImageLayout layout;
+        VkBufferImageCopy region;
+    };
+
+    struct BufferUpdate
+    {
+        VkBuffer dst;
+        VkDeviceSize offset;
+        VkDeviceSize size;
+        size_t dataOffset;
+    };
+
+    std::vector<BufferCopy> bufferCopies_{};
+    std::vector<ImageCopy> imageCopies_{};
+    std::vector<BufferUpdate> updates_{};
+    std::vector<uint8_t> updateData_{};
+
+    // Scratch storage reused from one flush to the next
+    std::vector<VkBufferCopy> bufferRegions_{};
+    std::vector<VkBufferImageCopy> imageRegions_{};
+
+    void recordUpdates(const VolkDeviceTable& vk, const VkCommandBuffer cmd, CopyBatchStats& stats)
+    {
+        // Consecutive updates of adjacent ranges are already contiguous in updateData_
+        size_t i = 0;
+        while(i < updates_.size())
+        {
+            BufferUpdate update = updates_[i++];
+            while(i < updates_.size())
+            {
+                const auto& next = updates_[i];
+                if(next.dst != update.dst || next.offset != update.offset + update.size
+                   || update.size + next.size > CommandBuffer::maxUpdateBufferSize)
+                {
+                    break;
+                }
+                update.size += next.size;
+                ++i;
+            }
+
+            vk.vkCmdUpdateBuffer(
+                cmd,
+                update.dst,
+                update.offset,
+                update.size,
+                updateData_.data() + update.dataOffset);
+            stats.updateCalls++;
+            stats.recordedRegions++;
+        }
+    }
+
+    void recordBufferCopies(
+        const VolkDeviceTable& vk, const VkCommandBuffer cmd, CopyBatchStats& stats)
+    {
+        std::sort(
+            bufferCopies_.begin(),
+            bufferCopies_.end(),
+            [](const BufferCopy& a, const BufferCopy& b) {
+                if(a.src != b.src)
+                {
+                    return std::less<VkBuffer>{}(a.src, b.src);
+                }
+                if(a.dst != b.dst)
+                {
+                    return std::less<VkBuffer>{}(a.dst, b.dst);
+                }
+                return a.region.srcOffset < b.region.srcOffset;
+            });
+
+        size_t i = 0;
+        while(i < bufferCopies_.size())
+        {
+            const auto src = bufferCopies_[i].src;
+            const auto dst = bufferCopies_[i].dst;
+
+            bufferRegions_.clear();
+            for(; i < bufferCopies_.size(); ++i)
+            {
+                const auto& copy = bufferCopies_[i];
+                if(copy.src != src || copy.dst != dst)
+                {
+                    break;
+                }
+
+                if(!bufferRegions_.empty())
+                {
+                    auto& last = bufferRegions_.back();
+                    if(last.srcOffset + last.size == copy.region.srcOffset
+                       && last.dstOffset + last.size == copy.region.dstOffset)
+                    {
+                        last.size += copy.region.size;
+                        continue;
+                    }
+                }
+                bufferRegions_.push_back(copy.region);
+            }
+
+            vk.vkCmdCopyBuffer(
+                cmd,
+                src,
+                dst,
+                static_cast<uint32_t>(bufferRegions_.size()),
+                bufferRegions_.data());
+            stats.copyCalls++;
+            stats.recordedRegions += static_cast<uint32_t>(bufferRegions_.size());
+        }
+    }
+
+    void recordImageCopies(
+        const VolkDeviceTable& vk, const VkCommandBuffer cmd, CopyBatchStats& stats)
+    {
+        std::stable_sort(
+            imageCopies_.begin(),
+            imageCopies_.end(),
+            [](const ImageCopy& a, const ImageCopy& b) {
+                if(a.src != b.src)
+                {
+                    return std::less<VkBuffer>{}(a.src, b.src);
+                }
+                if(a.dst != b.dst)
+                {
+                    return std::less<VkImage>{}(a.dst, b.dst);
+                }
+                return a.layout < b.layout;
+            });
+
+        size_t i = 0;
+        while(i < imageCopies_.size())
+        {
+            const auto src = imageCopies_[i].src;
+            const auto dst = imageCopies_[i].dst;
+            const auto layout = imageCopies_[i].layout;
+
+            imageRegions_.clear();
+            for(; i < imageCopies_.size(); ++i)
+            {
+                const auto& copy = imageCopies_[i];
+                if(copy.src != src || copy.dst != dst || copy.layout != layout)
+                {
+                    break;
+                }
+                imageRegions_.push_back(copy.region);
+            }
+
+            vk.vkCmdCopyBufferToImage(
+                cmd,
+                src,
+                dst,
+                layout,
+                static_cast<uint32_t>(imageRegions_.size()),
+                imageRegions_.data());
+            stats.copyCalls++;
+            stats.recordedRegions += static_cast<uint32_t>(imageRegions_.size());
+        }
+    }
+
+    static void recordTransferBarrier(
+        const VolkDeviceTable& vk, const VkCommandBuffer cmd, CopyBatchStats& stats)
+    {
+        VkMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.pNext = nullptr;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        vk.vkCmdPipelineBarrier(
+            cmd,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0,
+            1,
+            &barrier,
+            0,
+            nullptr,
+            0,
+            nullptr);
+        stats.barriers++;
+    }
+};
+} // namespace vkw
@@ -0,0 +1,520 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "vkw/vkw.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace vkw
+{
+// Paces a render loop over a fixed number of frames in flight. Each frame slot owns a command
+// pool reset when the slot is reused, a fence, a swapchain acquire semaphore, two timestamp
+// queries and a list of deferred deletions. One present semaphore is kept per swapchain image so
+// that it is never reused while a presentation may still wait on it. A frame goes through:
+//
+//   beginFrame()  waits for the slot, runs its deferred deletions and acquires an image
+//   batch()       submission of the frame, its first submit waits for the image and signals
+//                 the presentation, commands writing the image belong there
+//   endFrame()    submits the batch with the frame fence and presents
+//
+// Every successful beginFrame() must be followed by endFrame(). The latency target bounds how
+// many frames the CPU can queue ahead of the GPU, lower values trade CPU / GPU overlap for
+// latency.
+class FrameScheduler
+{
+  public:
+    struct FrameTimings
+    {
+        double cpuFrameTimeMs{0.0}; ///< From the end of the waits in beginFrame() to endFrame()
+        double gpuFrameTimeMs{0.0}; ///< From the image acquisition to the last command
+        // From the end of beginFrame() to the beginFrame() or waitIdle() finding the frame
+        // complete. Includes the CPU pacing, this is an upper bound of the time the GPU took to
+        // finish the frame, not the presentation latency.
+        double observedCompletionMs{0.0};
+    };
+
+    static constexpr uint32_t defaultFramesInFlight = 2;
+
+    FrameScheduler() {}
+    FrameScheduler(
+        Device& device,
+        Swapchain& swapchain,
+        const Queue& graphicsQueue,
+        const Queue& presentQueue,
+        const uint32_t framesInFlight = defaultFramesInFlight)
+    {
+        VKW_CHECK_BOOL_FAIL(
+            this->init(device, swapchain, graphicsQueue, presentQueue, framesInFlight),
+            "Initializing frame scheduler");
+    }
+
+    FrameScheduler(const FrameScheduler&) = delete;
+    FrameScheduler(FrameScheduler&& cp) { *this = std::move(cp); }
+
+    FrameScheduler& operator=(const FrameScheduler&) = delete;
+    FrameScheduler& operator=(FrameScheduler&& cp)
+    {
+        this->clear();
+        std::swap(device_, cp.device_);
+        std::swap(swapchain_, cp.swapchain_);
+        std::swap(graphicsQueue_, cp.graphicsQueue_);
+        std::swap(presentQueue_, cp.presentQueue_);
+        std::swap(frames_, cp.frames_);
+        std::swap(presentSemaphores_, cp.presentSemaphores_);
+        std::swap(batch_, cp.batch_);
+        std::swap(timings_, cp.timings_);
+        std::swap(queryResults_, cp.queryResults_);
+        std::swap(frameNumber_, cp.frameNumber_);
+        std::swap(frameIndex_, cp.frameIndex_);
+        std::swap(imageIndex_, cp.imageIndex_);
+        std::swap(latencyTarget_, cp.latencyTarget_);
+        std::swap(timestampPeriod_, cp.timestampPeriod_);
+        std::swap(timestampMask_, cp.timestampMask_);
+        std::swap(gpuTimingEnabled_, cp.gpuTimingEnabled_);
+        std::swap(inFrame_, cp.inFrame_);
+        std::swap(initialized_, cp.initialized_);
+        return *this;
+    }
+
+    ~FrameScheduler() { this->clear(); }
+
+    bool init(
+        Device& device,
+        Swapchain& swapchain,
+        const Queue& graphicsQueue,
+        const Queue& presentQueue,
+        const uint32_t framesInFlight = defaultFramesInFlight)
+    {
+        VKW_ASSERT(this->initialized() == false);
+        VKW_ASSERT(framesInFlight > 0);
+
+        device_ = &device;
+        swapchain_ = &swapchain;
+        graphicsQueue_ = graphicsQueue;
+        presentQueue_ = presentQueue;
+        latencyTarget_ = framesInFlight;
+
+        const auto& properties = device_->getProperties();
+        timestampPeriod_ = properties.limits.timestampPeriod;
+        const uint32_t validBits
+            = device_->getTimestampValidBits(graphicsQueue_.queueFamilyIndex());
+        timestampMask_ = (validBits >= 64) ? ~uint64_t(0) : ((uint64_t(1) << validBits) - 1);
+        gpuTimingEnabled_ = validBits > 0;
+
+        frames_.resize(framesInFlight);
+        for(auto& frame : frames_)
+        {
+            VKW_INIT_CHECK_BOOL(frame.cmdPool.init(*device_, graphicsQueue_));
+            VKW_INIT_CHECK_BOOL(frame.fence.init(*device_, true));
+            VKW_INIT_CHECK_BOOL(frame.acquireSemaphore.init(*device_));
+            if(gpuTimingEnabled_)
+            {
+                VKW_INIT_CHECK_BOOL(frame.timingSemaphore.init(*device_));
+                VKW_INIT_CHECK_BOOL(frame.timestamps.init(*device_, VK_QUERY_TYPE_TIMESTAMP, 2));
+                frame.beginCmdBuffer = frame.cmdPool.createCommandBuffer();
+                frame.endCmdBuffer = frame.cmdPool.createCommandBuffer();
+                VKW_INIT_CHECK_BOOL(frame.beginCmdBuffer.initialized());
+                VKW_INIT_CHECK_BOOL(frame.endCmdBuffer.initialized());
+            }
+        }
+        VKW_INIT_CHECK_BOOL(updatePresentSemaphores());
+
+        initialized_ = true;
+
+        return true;
+    }
+
+    // Waits for the frames in flight and runs every deferred callback
+    void clear()
+    {
+        if(initialized_)
+        {
+            this->waitIdle();
+        }
+        for(auto& frame : frames_)
+        {
+            runDeferred(frame);
+        }
+
+        frames_.clear();
+        presentSemaphores_.clear();
+        batch_.clear();
+        timings_ = {};
+        queryResults_.clear();
+
+        frameNumber_ = 0;
+        frameIndex_ = 0;
+        imageIndex_ = 0;
+        latencyTarget_ = 0;
+        timestampPeriod_ = 1.0f;
+        timestampMask_ = ~uint64_t(0);
+        gpuTimingEnabled_ = false;
+        inFrame_ = false;
+
+        graphicsQueue_ = {};
+        presentQueue_ = {};
+        swapchain_ = nullptr;
+        device_ = nullptr;
+        initialized_ = false;
+    }
+
+    bool initialized() const { return initialized_; }
+
+    uint32_t framesInFlight() const { return static_cast<uint32_t>(frames_.size()); }
+
+    // Maximum number of frames queued ahead of the GPU, between 1 and framesInFlight()
+    void setLatencyTarget(const uint32_t frameCount)
+    {
+        latencyTarget_ = std::clamp(frameCount, uint32_t(1), framesInFlight());
+    }
+    uint32_t latencyTarget() const { return latencyTarget_; }
+
+    // Returns VK_SUCCESS or VK_SUBOPTIMAL_KHR when the frame can be recorded, the frame is not
+    // started otherwise, VK_ERROR_OUT_OF_DATE_KHR meaning the swapchain must be recreated.
+    VkResult beginFrame(const uint64_t timeout = std::numeric_limits<uint64_t>::max())
+    {
+        VKW_ASSERT(this->initialized());
+        VKW_ASSERT(!inFrame_);
+
+        const uint32_t frameCount = framesInFlight();
+        frameIndex_ = static_cast<uint32_t>(frameNumber_ % frameCount);
+        auto& frame = frames_[frameIndex_];
+
+        // Fences of slots that are not pending are either signaled or were never submitted
+        if(frameNumber_ >= latencyTarget_)
+        {
+            auto& oldestFrame = frames_[(frameNumber_ - latencyTarget_) % frameCount];
+            if(oldestFrame.pending)
+            {
+                const VkResult res = waitFence(oldestFrame.fence, timeout);
+                if(res != VK_SUCCESS)
+                {
+                    return res;
+                }
+            }
+        }
+        if(frame.pending)
+        {
+            const VkResult res = waitFence(frame.fence, timeout);
+            if(res != VK_SUCCESS)
+            {
+                return res;
+            }
+        }
+        collectTimings();
+
+        runDeferred(frame);
+        if(!frame.cmdPool.reset())
+        {
+            return VK_ERROR_UNKNOWN;
+        }
+
+        uint32_t imageIndex = 0;
+        const VkResult res = swapchain_->getNextImage(imageIndex, frame.acquireSemaphore, timeout);
+        if(res != VK_SUCCESS && res != VK_SUBOPTIMAL_KHR)
+        {
+            return res;
+        }
+        if(!updatePresentSemaphores())
+        {
+            return VK_ERROR_UNKNOWN;
+        }
+        imageIndex_ = imageIndex;
+
+        batch_.clear();
+        if(gpuTimingEnabled_)
+        {
+            // The begin timestamp goes in its own submission waiting for the image, which then
+            // signals the frame submission, so the GPU time does not include swapchain stalls and
+            // the frame commands still only wait for the image at color output
+            frame.beginCmdBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+            frame.beginCmdBuffer.resetQueryPool(frame.timestamps)
+                .writeTimestamp(frame.timestamps, 0, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+            frame.beginCmdBuffer.end();
+            batch_.addWait(frame.acquireSemaphore, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT)
+                .addCommandBuffer(frame.beginCmdBuffer)
+                .addSignal(frame.timingSemaphore, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT)
+                .nextSubmit();
+        }
+        const auto& imageSemaphore
+            = gpuTimingEnabled_ ? frame.timingSemaphore : frame.acquireSemaphore;
+        batch_.addWait(imageSemaphore, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT)
+            .addSignal(presentSemaphores_[imageIndex_], VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+
+        frame.beginTime = Clock::now();
+        inFrame_ = true;
+
+        return res;
+    }
+
+    // Returns the presentation result, VK_ERROR_OUT_OF_DATE_KHR or VK_SUBOPTIMAL_KHR meaning the
+    // swapchain should be recreated.
+    VkResult endFrame()
+    {
+        VKW_ASSERT(this->initialized());
+        VKW_ASSERT(inFrame_);
+
+        auto& frame = frames_[frameIndex_];
+        inFrame_ = false;
+
+        if(gpuTimingEnabled_)
+        {
+            frame.endCmdBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+            frame.endCmdBuffer.writeTimestamp(
+                frame.timestamps, 1, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+            frame.endCmdBuffer.end();
+            batch_.addCommandBuffer(frame.endCmdBuffer);
+        }
+
+        // Reset last, a frame that fails before being submitted leaves its fence signaled
+        if(!frame.fence.reset())
+        {
+            return VK_ERROR_UNKNOWN;
+        }
+        VkResult res = graphicsQueue_.submit(batch_, frame.fence);
+        if(res != VK_SUCCESS)
+        {
+            // The slot is not pending, its fence will not be waited on. The acquire semaphore
+            // stays signaled with nothing to wait on it and must be replaced.
+            utils::Log::Error("vkw", "Frame scheduler: error submitting frame");
+            frame.acquireSemaphore.clear();
+            if(!frame.acquireSemaphore.init(*device_))
+            {
+                utils::Log::Error("vkw", "Frame scheduler: error creating acquire semaphore");
+            }
+            return res;
+        }
+        frame.pending = true;
+        frameNumber_++;
+
+        res = presentQueue_.present(*swapchain_, presentSemaphores_[imageIndex_], imageIndex_);
+
+        accumulate(timings_.cpuFrameTimeMs, elapsedMs(frame.beginTime, Clock::now()));
+
+        return res;
+    }
+
+    // Slot of the current frame, valid from beginFrame() until the next one
+    uint32_t frameIndex() const { return frameIndex_; }
+    uint32_t imageIndex() const { return imageIndex_; }
+    // Number of frames submitted so far
+    uint64_t frameNumber() const { return frameNumber_; }
+
+    // Reset every time the slot is reused, command buffers allocated from it are recorded again
+    // every frame
+    CommandPool& commandPool() { return frames_[frameIndex_].cmdPool; }
+    CommandPool& commandPool(const uint32_t frameIndex) { return frames_.at(frameIndex).cmdPool; }
+
+    SubmitBatch& batch()
+    {
+        VKW_ASSERT(inFrame_);
+        return batch_;
+    }
+
+    // Runs callback once the GPU is done with the current frame, when its slot is reused
+    void defer(std::function<void()>&& callback)
+    {
+        VKW_ASSERT(this->initialized());
+        frames_[frameIndex_].deferred.emplace_back(std::move(callback));
+    }
+
+    // Keeps object alive until the GPU is done with the current frame
+    template <typename T>
+    void deferRelease(T&& object)
+    {
+        auto holder = std::make_shared<std::decay_t<T>>(std::forward<T>(object));
+        defer([holder]() mutable { holder.reset(); });
+    }
+
+    // Waits for every submitted frame and runs their deferred callbacks
+    bool waitIdle()
+    {
+        VKW_ASSERT(this->initialized());
+        VKW_CHECK_BOOL_RETURN_FALSE(waitSubmitted());
+
+        for(uint32_t i = 0; i < framesInFlight(); ++i)
+        {
+            if(!inFrame_ || i != frameIndex_)
+            {
+                runDeferred(frames_[i]);
+            }
+        }
+        return true;
+    }
+
+    // Waits for every submitted frame and drops the deferred callbacks without running them, the
+    // objects they capture are destroyed. For owners that can no longer run them, typically from
+    // a base class destructor when the callbacks call into the derived class.
+    bool discardDeferred()
+    {
+        VKW_ASSERT(this->initialized());
+        VKW_CHECK_BOOL_RETURN_FALSE(waitSubmitted());
+
+        for(auto& frame : frames_)
+        {
+            frame.deferred.clear();
+        }
+        return true;
+    }
+
+    // Averaged over the last frames
+    const FrameTimings& getTimings() const { return timings_; }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr double timingSmoothing = 0.1;
+
+    struct FrameData
+    {
+        CommandPool cmdPool{};
+        CommandBuffer beginCmdBuffer{};
+        CommandBuffer endCmdBuffer{};
+        QueryPool timestamps{};
+        Fence fence{};
+        Semaphore acquireSemaphore{};
+        Semaphore timingSemaphore{}; ///< Signaled after the begin timestamp
+        std::vector<std::function<void()>> deferred{};
+        std::vector<std::function<void()>> running{}; ///< Keeps its capacity between frames
+        Clock::time_point beginTime{};
+        bool pending{false}; ///< Submitted, timings not collected yet
+    };
+
+    Device* device_{nullptr};
+    Swapchain* swapchain_{nullptr};
+    Queue graphicsQueue_{};
+    Queue presentQueue_{};
+
+    std::vector<FrameData> frames_{};
+    std::vector<Semaphore> presentSemaphores_{}; ///< One per swapchain image
+    SubmitBatch batch_{};
+
+    FrameTimings timings_{};
+    std::vector<uint64_t> queryResults_{};
+
+    uint64_t frameNumber_{0};
+    uint32_t frameIndex_{0};
+    uint32_t imageIndex_{0};
+    uint32_t latencyTarget_{0};
+
+    float timestampPeriod_{1.0f};
+    uint64_t timestampMask_{~uint64_t(0)};
+    bool gpuTimingEnabled_{false};
+
+    bool inFrame_{false};
+    bool initialized_{false};
+
+    bool waitSubmitted()
+    {
+        for(auto& frame : frames_)
+        {
+            if(frame.pending
+               && waitFence(frame.fence, std::numeric_limits<uint64_t>::max()) != VK_SUCCESS)
+            {
+                return false;
+            }
+        }
+        collectTimings();
+        return true;
+    }
+
+    VkResult waitFence(Fence& fence, const uint64_t timeout)
+    {
+        return device_->vk().vkWaitForFences(
+            device_->getHandle(), 1, &fence.getHandle(), VK_TRUE, timeout);
+    }
+
+    // The swapchain may come back with more images once recreated
+    bool updatePresentSemaphores()
+    {
+        while(presentSemaphores_.size() < swapchain_->imageCount())
+        {
+            Semaphore semaphore{};
+            VKW_CHECK_BOOL_RETURN_FALSE(semaphore.init(*device_));
+            presentSemaphores_.emplace_back(std::move(semaphore));
+        }
+        return true;
+    }
+
+    void collectTimings()
+    {
+        const auto now = Clock::now();
+        for(auto& frame : frames_)
+        {
+            if(!frame.pending || frame.fence.getStatus() != VK_SUCCESS)
+            {
+                continue;
+            }
+            frame.pending = false;
+            accumulate(timings_.observedCompletionMs, elapsedMs(frame.beginTime, now));
+
+            if(!gpuTimingEnabled_)
+            {
+                continue;
+            }
+
+            // Each query is followed by its availability value
+            const auto res = frame.timestamps.getResults(
+                0, 2, queryResults_, VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+            if(res != VK_SUCCESS || queryResults_[1] == 0 || queryResults_[3] == 0)
+            {
+                continue;
+            }
+            const uint64_t ticks = (queryResults_[2] - queryResults_[0]) & timestampMask_;
+            accumulate(
+                timings_.gpuFrameTimeMs,
+                static_cast<double>(ticks) * static_cast<double>(timestampPeriod_) * 1.0e-6);
+        }
+    }
+
+    // Callbacks may defer more work, the two lists are swapped so that neither allocates once
+    // warmed up
+    static void runDeferred(FrameData& frame)
+    {
+        std::swap(frame.running, frame.deferred);
+        for(auto& callback : frame.running)
+        {
+            callback();
+        }
+        frame.running.clear();
+    }
+
+    static double elapsedMs(const Clock::time_point start, const Clock::time_point end)
+    {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    static void accumulate(double& average, const double value)
+    {
+        average = (average == 0.0) ? value : average + timingSmoothing * (value - average);
+    }
+};
+} // namespace vkw
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Coroutine support, only available when compiling with C++20 or later. The C++17 API is not
+// affected, this header is empty otherwise.
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#    if __has_include(<coroutine>)
+#        define VKW_HAS_COROUTINES 1
+#    endif
+#endif
+
+#ifdef VKW_HAS_COROUTINES
+
+#    include "vkw/high_level/GpuFuture.hpp"
+#    include "vkw/vkw.hpp"
+
+#    include <coroutine>
+#    include <cstdint>
+#    include <utility>
+
+namespace vkw
+{
+// Suspends the calling coroutine until a timeline semaphore reaches a value. The coroutine is
+// resumed on a thread of the completion pool.
+class TimelineAwaitable
+{
+  public:
+    TimelineAwaitable(CompletionPool& pool, const VkSemaphore semaphore, const uint64_t value)
+        : pool_{&pool}
+        , semaphore_{semaphore}
+        , value_{value}
+    {}
+
+    bool await_ready() const
+    {
+        uint64_t currentValue = 0;
+        pool_->device().vk().vkGetSemaphoreCounterValue(
+            pool_->device().getHandle(), semaphore_, &currentValue);
+        return currentValue >= value_;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) const
+    {
+        pool_->enqueue(semaphore_, value_, [handle]() { handle.resume(); });
+    }
+
+    void await_resume() const {}
+
+  private:
+    CompletionPool* pool_{nullptr};
+    VkSemaphore semaphore_{VK_NULL_HANDLE};
+    uint64_t value_{0};
+};
+
+// Suspends the calling coroutine until a fence is signaled. Fences are polled by the completion
+// pool, prefer timeline semaphores when possible.
+class FenceAwaitable
+{
+  public:
+    FenceAwaitable(CompletionPool& pool, const VkFence fence) : pool_{&pool}, fence_{fence} {}
+
+    bool await_ready() const
+    {
+        return pool_->device().vk().vkGetFenceStatus(pool_->device().getHandle(), fence_)
+               == VK_SUCCESS;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) const
+    {
+        pool_->enqueueFence(fence_, [handle]() { handle.resume(); });
+    }
+
+    void await_resume() const {}
+
+  private:
+    CompletionPool* pool_{nullptr};
+    VkFence fence_{VK_NULL_HANDLE};
+};
+
+// Moves the calling coroutine to a thread of the completion pool
+class ScheduleAwaitable
+{
+  public:
+    explicit ScheduleAwaitable(CompletionPool& pool) : pool_{&pool} {}
+
+    bool await_ready() const { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle) const
+    {
+        pool_->post([handle]() { handle.resume(); });
+    }
+
+    void await_resume() const {}
+
+  private:
+    CompletionPool* pool_{nullptr};
+};
+
+// Awaits a GpuFuture, the result is returned by co_await
+template <typename T>
+class GpuFutureAwaitable
+{
+  public:
+    explicit GpuFutureAwaitable(GpuFuture<T> future) : future_{std::move(future)} {}
+
+    bool await_ready() const { return future_.ready(); }
+
+    void await_suspend(std::coroutine_handle<> handle) const
+    {
+        future_.onComplete([handle]() { handle.resume(); });
+    }
+
+    decltype(auto) await_resume() const { return future_.get(); }
+
+  private:
+    GpuFuture<T> future_{};
+};
+
+template <typename T>
+inline GpuFutureAwaitable<T> operator co_await(const GpuFuture<T>& future)
+{
+    return GpuFutureAwaitable<T>{future};
+}
+
+// Resumes coroutines once their GPU work completes, on the threads of a completion pool:
+//
+//   co_await reactor.wait(timelineSemaphore, value);
+//   co_await reactor.wait(fence);
+//   co_await reactor.schedule();
+//
+// Nothing is allocated per suspended coroutine apart from the pool callback.
+class GpuReactor
+{
+  public:
+    explicit GpuReactor(CompletionPool& pool) : pool_{&pool} {}
+
+    GpuReactor(const GpuReactor&) = default;
+    GpuReactor(GpuReactor&&) = default;
+
+    GpuReactor& operator=(const GpuReactor&) = default;
+    GpuReactor& operator=(GpuReactor&&) = default;
+
+    ~GpuReactor() {}
+
+    CompletionPool& pool() const { return *pool_; }
+
+    TimelineAwaitable wait(const TimelineSemaphore& semaphore, const uint64_t value) const
+    {
+        return TimelineAwaitable{*pool_, semaphore.getHandle(), value};
+    }
+    TimelineAwaitable wait(const VkSemaphore semaphore, const uint64_t value) const
+    {
+        return TimelineAwaitable{*pool_, semaphore, value};
+    }
+
+    FenceAwaitable wait(const Fence& fence) const
+    {
+        return FenceAwaitable{*pool_, fence.getHandle()};
+    }
+
+    ScheduleAwaitable schedule() const { return ScheduleAwaitable{*pool_}; }
+
+  private:
+    CompletionPool* pool_{nullptr};
+};
+} // namespace vkw
+
+#endif // VKW_HAS_COROUTINES
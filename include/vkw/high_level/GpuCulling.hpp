@@ -0,0 +1,542 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "vkw/high_level/Types.hpp"
+#include "vkw/vkw.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace vkw
+{
+// Bounding sphere of one instance, matches the std430 layout used by gpu_culling.comp
+struct CullingInstance
+{
+    float center[3];
+    float radius;
+    uint32_t meshId;
+    uint32_t pad[3];
+};
+
+// Compute pass turning a list of instances into a compacted stream of indexed draws consumed by
+// drawIndexedIndirectCount(). Each instance refers to one of the mesh draw templates given at
+// initialization; every visible instance emits a copy of its template with instanceCount = 1 and
+// firstInstance set to the instance index so that per-instance data can be fetched with
+// gl_InstanceIndex. The CPU cost of a frame does not depend on the number of instances.
+// The SPIR-V of samples/shaders/gpu_culling.comp and hiz_downsample.comp is loaded from the paths
+// given to init() and enableHiZ().
+// Expected usage for a frame:
+//   - cull() outside of a render pass, with a column-major view-projection matrix
+//   - draw() inside the render pass
+//   - buildHiZ() once the depth buffer is complete, when Hi-Z culling is enabled. The pyramid is
+//     then used by the cull() of the next frame.
+class GpuCulling
+{
+  public:
+    GpuCulling() {}
+    GpuCulling(
+        Device& device,
+        const uint32_t maxInstanceCount,
+        const std::vector<VkDrawIndexedIndirectCommand>& meshDraws,
+        const std::string& shaderPath)
+    {
+        VKW_CHECK_BOOL_FAIL(
+            this->init(device, maxInstanceCount, meshDraws, shaderPath),
+            "Initializing GPU culling");
+    }
+
+    GpuCulling(const GpuCulling&) = delete;
+    GpuCulling(GpuCulling&& cp) { *this = std::move(cp); }
+
+    GpuCulling& operator=(const GpuCulling&) = delete;
+    GpuCulling& operator=(GpuCulling&& cp)
+    {
+        this->clear();
+        std::swap(device_, cp.device_);
+        std::swap(instances_, cp.instances_);
+        std::swap(meshDraws_, cp.meshDraws_);
+        std::swap(draws_, cp.draws_);
+        std::swap(drawCount_, cp.drawCount_);
+        std::swap(cullDescriptorSetLayout_, cp.cullDescriptorSetLayout_);
+        std::swap(cullPipelineLayout_, cp.cullPipelineLayout_);
+        std::swap(cullPipeline_, cp.cullPipeline_);
+        std::swap(cullDescriptorPool_, cp.cullDescriptorPool_);
+        std::swap(cullDescriptorSet_, cp.cullDescriptorSet_);
+        std::swap(hiZImage_, cp.hiZImage_);
+        std::swap(hiZViews_, cp.hiZViews_);
+        std::swap(hiZFullView_, cp.hiZFullView_);
+        std::swap(hiZSampler_, cp.hiZSampler_);
+        std::swap(hiZDescriptorSetLayout_, cp.hiZDescriptorSetLayout_);
+        std::swap(hiZPipelineLayout_, cp.hiZPipelineLayout_);
+        std::swap(hiZPipeline_, cp.hiZPipeline_);
+        std::swap(hiZDescriptorPool_, cp.hiZDescriptorPool_);
+        std::swap(hiZDescriptorSets_, cp.hiZDescriptorSets_);
+        std::swap(depthExtent_, cp.depthExtent_);
+        std::swap(hiZExtent_, cp.hiZExtent_);
+        std::swap(hiZMipCount_, cp.hiZMipCount_);
+        std::swap(maxInstanceCount_, cp.maxInstanceCount_);
+        std::swap(instanceCount_, cp.instanceCount_);
+        std::swap(hiZEnabled_, cp.hiZEnabled_);
+        std::swap(hiZNeedsTransition_, cp.hiZNeedsTransition_);
+        std::swap(hiZBuilt_, cp.hiZBuilt_);
+        std::swap(initialized_, cp.initialized_);
+        return *this;
+    }
+
+    ~GpuCulling() { this->clear(); }
+
+    bool init(
+        Device& device,
+        const uint32_t maxInstanceCount,
+        const std::vector<VkDrawIndexedIndirectCommand>& meshDraws,
+        const std::string& shaderPath)
+    {
+        VKW_ASSERT(this->initialized() == false);
+        VKW_ASSERT(maxInstanceCount > 0);
+        VKW_ASSERT(!meshDraws.empty());
+
+        device_ = &device;
+        maxInstanceCount_ = maxInstanceCount;
+        instanceCount_ = 0;
+
+        VKW_INIT_CHECK_BOOL(instances_.init(*device_, 0, maxInstanceCount_));
+        VKW_INIT_CHECK_BOOL(meshDraws_.init(*device_, 0, meshDraws.size()));
+        VKW_INIT_CHECK_BOOL(meshDraws_.copyFromHost(meshDraws.data(), meshDraws.size()));
+        VKW_INIT_CHECK_BOOL(draws_.init(*device_, 0, maxInstanceCount_));
+        VKW_INIT_CHECK_BOOL(drawCount_.init(*device_, 0, 1));
+
+        VKW_INIT_CHECK_BOOL(cullDescriptorSetLayout_.init(*device_));
+        cullDescriptorSetLayout_
+            .addBinding<DescriptorType::StorageBuffer>(VK_SHADER_STAGE_COMPUTE_BIT, 0)
+            .addBinding<DescriptorType::StorageBuffer>(VK_SHADER_STAGE_COMPUTE_BIT, 1)
+            .addBinding<DescriptorType::StorageBuffer>(VK_SHADER_STAGE_COMPUTE_BIT, 2)
+            .addBinding<DescriptorType::StorageBuffer>(VK_SHADER_STAGE_COMPUTE_BIT, 3)
+            .addBinding<DescriptorType::CombinedImageSampler>(VK_SHADER_STAGE_COMPUTE_BIT, 4)
+            .create();
+
+        VKW_INIT_CHECK_BOOL(cullPipelineLayout_.init(*device_, cullDescriptorSetLayout_));
+        cullPipelineLayout_.reservePushConstants<CullPushConstants>(ShaderStage::Compute);
+        cullPipelineLayout_.create();
+
+        VKW_INIT_CHECK_BOOL(cullPipeline_.init(*device_, shaderPath));
+        VKW_INIT_CHECK_BOOL(cullPipeline_.createPipeline(cullPipelineLayout_));
+
+        // Placeholder pyramid so that the culling descriptor set is always complete
+        VKW_INIT_CHECK_BOOL(createHiZPyramid(VkExtent2D{1, 1}));
+
+        VKW_INIT_CHECK_BOOL(cullDescriptorPool_.init(
+            *device_,
+            1,
+            {{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4},
+             {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1}}));
+        VKW_INIT_CHECK_BOOL(
+            cullDescriptorSet_.init(*device_, cullDescriptorSetLayout_, cullDescriptorPool_));
+        cullDescriptorSet_.bindStorageBuffer(0, instances_)
+            .bindStorageBuffer(1, meshDraws_)
+            .bindStorageBuffer(2, draws_)
+            .bindStorageBuffer(3, drawCount_)
+            .bindCombinedImageSampler(4, hiZSampler_, hiZFullView_);
+
+        hiZEnabled_ = false;
+        initialized_ = true;
+
+        return true;
+    }
+
+    void clear()
+    {
+        hiZDescriptorSets_.clear();
+        hiZDescriptorPool_.clear();
+        hiZPipeline_.clear();
+        hiZPipelineLayout_.clear();
+        hiZDescriptorSetLayout_.clear();
+        hiZSampler_.clear();
+        hiZFullView_.clear();
+        hiZViews_.clear();
+        hiZImage_.clear();
+
+        cullDescriptorSet_.clear();
+        cullDescriptorPool_.clear();
+        cullPipeline_.clear();
+        cullPipelineLayout_.clear();
+        cullDescriptorSetLayout_.clear();
+
+        instances_.clear();
+        meshDraws_.clear();
+        draws_.clear();
+        drawCount_.clear();
+
+        depthExtent_ = {};
+        hiZExtent_ = {};
+        hiZMipCount_ = 0;
+        maxInstanceCount_ = 0;
+        instanceCount_ = 0;
+        hiZEnabled_ = false;
+        hiZNeedsTransition_ = false;
+        hiZBuilt_ = false;
+
+        device_ = nullptr;
+        initialized_ = false;
+    }
+
+    bool initialized() const { return initialized_; }
+
+    // Builds a depth pyramid from depthView on each buildHiZ() call and uses it to reject
+    // instances hidden behind the depth of the previous frame. depthView must be sampleable in
+    // depthLayout when buildHiZ() is recorded. A standard depth range is assumed, nearer objects
+    // having smaller depth values. Must not be called while a frame using this object is pending.
+    bool enableHiZ(
+        const ImageView& depthView,
+        const VkExtent2D depthExtent,
+        const std::string& shaderPath,
+        const VkImageLayout depthLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+    {
+        VKW_ASSERT(this->initialized());
+        VKW_ASSERT(hiZEnabled_ == false);
+
+        depthExtent_ = depthExtent;
+        const VkExtent2D hiZExtent
+            = {std::max(depthExtent.width / 2, 1u), std::max(depthExtent.height / 2, 1u)};
+        VKW_CHECK_BOOL_RETURN_FALSE(createHiZPyramid(hiZExtent));
+
+        VKW_CHECK_BOOL_RETURN_FALSE(hiZDescriptorSetLayout_.init(*device_));
+        hiZDescriptorSetLayout_
+            .addBinding<DescriptorType::CombinedImageSampler>(VK_SHADER_STAGE_COMPUTE_BIT, 0)
+            .addBinding<DescriptorType::StorageImage>(VK_SHADER_STAGE_COMPUTE_BIT, 1)
+            .create();
+
+        VKW_CHECK_BOOL_RETURN_FALSE(hiZPipelineLayout_.init(*device_, hiZDescriptorSetLayout_));
+        hiZPipelineLayout_.reservePushConstants<HiZPushConstants>(ShaderStage::Compute);
+        hiZPipelineLayout_.create();
+
+        VKW_CHECK_BOOL_RETURN_FALSE(hiZPipeline_.init(*device_, shaderPath));
+        VKW_CHECK_BOOL_RETURN_FALSE(hiZPipeline_.createPipeline(hiZPipelineLayout_));
+
+        VKW_CHECK_BOOL_RETURN_FALSE(hiZDescriptorPool_.init(
+            *device_,
+            hiZMipCount_,
+            {{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, hiZMipCount_},
+             {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, hiZMipCount_}}));
+        for(uint32_t i = 0; i < hiZMipCount_; ++i)
+        {
+            DescriptorSet descriptorSet{};
+            VKW_CHECK_BOOL_RETURN_FALSE(
+                descriptorSet.init(*device_, hiZDescriptorSetLayout_, hiZDescriptorPool_));
+            if(i == 0)
+            {
+                descriptorSet.bindCombinedImageSampler(0, hiZSampler_, depthView, depthLayout);
+            }
+            else
+            {
+                descriptorSet.bindCombinedImageSampler(0, hiZSampler_, hiZViews_[i - 1]);
+            }
+            descriptorSet.bindStorageImage(1, hiZViews_[i]);
+            hiZDescriptorSets_.emplace_back(std::move(descriptorSet));
+        }
+
+        cullDescriptorSet_.bindCombinedImageSampler(4, hiZSampler_, hiZFullView_);
+
+        hiZEnabled_ = true;
+        return true;
+    }
+
+    bool hiZEnabled() const { return hiZEnabled_; }
+
+    uint32_t maxInstanceCount() const { return maxInstanceCount_; }
+    uint32_t instanceCount() const { return instanceCount_; }
+
+    // Instances are written directly into device visible memory, they must not be updated while
+    // a frame using them is pending
+    bool setInstances(const CullingInstance* instances, const uint32_t count)
+    {
+        VKW_ASSERT(this->initialized());
+        VKW_ASSERT(count <= maxInstanceCount_);
+
+        instanceCount_ = count;
+        if(count > 0)
+        {
+            VKW_CHECK_BOOL_RETURN_FALSE(instances_.copyFromHost(instances, count));
+        }
+        return true;
+    }
+    bool setInstances(const std::vector<CullingInstance>& instances)
+    {
+        return setInstances(instances.data(), static_cast<uint32_t>(instances.size()));
+    }
+
+    // Must be recorded outside of a render pass. viewProj is a column-major matrix mapping world
+    // space to Vulkan clip space.
+    void cull(CommandBuffer& cmdBuffer, const float viewProj[16])
+    {
+        VKW_ASSERT(this->initialized());
+
+        transitionHiZ(cmdBuffer);
+
+        // Previous frame draws must be done with the buffers before overwriting them
+        cmdBuffer.memoryBarrier(
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            createMemoryBarrier(
+                VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+                VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT));
+        cmdBuffer.fillBuffer(drawCount_, uint32_t(0), 0, drawCount_.sizeBytes());
+        cmdBuffer.bufferMemoryBarrier(
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            createBufferMemoryBarrier(
+                drawCount_,
+                VK_ACCESS_TRANSFER_WRITE_BIT,
+                VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT));
+
+        if(instanceCount_ > 0)
+        {
+            CullPushConstants constants{};
+            std::copy(viewProj, viewProj + 16, constants.viewProj);
+            constants.instanceCount = instanceCount_;
+            constants.useHiZ = (hiZEnabled_ && hiZBuilt_) ? 1 : 0;
+            constants.hiZWidth = static_cast<float>(hiZExtent_.width);
+            constants.hiZHeight = static_cast<float>(hiZExtent_.height);
+
+            cmdBuffer.bindComputePipeline(cullPipeline_);
+            cmdBuffer.bindComputeDescriptorSet(cullPipelineLayout_, 0, cullDescriptorSet_);
+            cmdBuffer.pushConstants(cullPipelineLayout_, constants, ShaderStage::Compute);
+            cmdBuffer.dispatch(utils::divUp(instanceCount_, cullGroupSize));
+        }
+
+        cmdBuffer.bufferMemoryBarriers(
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+            createBufferMemoryBarrier(
+                draws_, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT),
+            createBufferMemoryBarrier(
+                drawCount_, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT));
+    }
+
+    // Draws the surviving instances, the index and vertex buffers of the meshes must be bound
+    void draw(CommandBuffer& cmdBuffer)
+    {
+        VKW_ASSERT(this->initialized());
+        cmdBuffer.drawIndexedIndirectCount(draws_, 0, drawCount_, 0, maxInstanceCount_);
+    }
+
+    // Must be recorded outside of a render pass, once depth writes are complete
+    void buildHiZ(CommandBuffer& cmdBuffer)
+    {
+        VKW_ASSERT(this->initialized());
+        if(!hiZEnabled_)
+        {
+            return;
+        }
+
+        transitionHiZ(cmdBuffer);
+
+        // The pyramid may still be read by the culling pass of this frame
+        cmdBuffer.memoryBarrier(
+            VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT
+                | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            createMemoryBarrier(
+                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT,
+                VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT));
+
+        cmdBuffer.bindComputePipeline(hiZPipeline_);
+        VkExtent2D srcExtent = depthExtent_;
+        for(uint32_t i = 0; i < hiZMipCount_; ++i)
+        {
+            const VkExtent2D dstExtent
+                = {std::max(hiZExtent_.width >> i, 1u), std::max(hiZExtent_.height >> i, 1u)};
+
+            HiZPushConstants constants{};
+            constants.srcSize[0] = srcExtent.width;
+            constants.srcSize[1] = srcExtent.height;
+            constants.dstSize[0] = dstExtent.width;
+            constants.dstSize[1] = dstExtent.height;
+
+            cmdBuffer.bindComputeDescriptorSet(hiZPipelineLayout_, 0, hiZDescriptorSets_[i]);
+            cmdBuffer.pushConstants(hiZPipelineLayout_, constants, ShaderStage::Compute);
+            cmdBuffer.dispatch(
+                utils::divUp(dstExtent.width, hiZGroupSize),
+                utils::divUp(dstExtent.height, hiZGroupSize));
+            cmdBuffer.imageMemoryBarrier(
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                createImageMemoryBarrier(
+                    hiZImage_,
+                    VK_ACCESS_SHADER_WRITE_BIT,
+                    VK_ACCESS_SHADER_READ_BIT,
+                    VK_IMAGE_LAYOUT_GENERAL,
+                    VK_IMAGE_LAYOUT_GENERAL,
+                    VK_IMAGE_ASPECT_COLOR_BIT,
+                    i,
+                    1));
+
+            srcExtent = dstExtent;
+        }
+        hiZBuilt_ = true;
+    }
+
+    const auto& drawBuffer() const { return draws_; }
+    const auto& drawCountBuffer() const { return drawCount_; }
+    const auto& instanceBuffer() const { return instances_; }
+
+  private:
+    static constexpr uint32_t cullGroupSize = 64;
+    static constexpr uint32_t hiZGroupSize = 8;
+
+    struct CullPushConstants
+    {
+        float viewProj[16];
+        uint32_t instanceCount;
+        uint32_t useHiZ;
+        float hiZWidth;
+        float hiZHeight;
+    };
+
+    struct HiZPushConstants
+    {
+        uint32_t srcSize[2];
+        uint32_t dstSize[2];
+    };
+
+    Device* device_{nullptr};
+
+    HostToDeviceBuffer<CullingInstance, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT> instances_{};
+    HostToDeviceBuffer<VkDrawIndexedIndirectCommand, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT>
+        meshDraws_{};
+    DrawIndexedIndirectBuffer draws_{};
+    IndirectCountBuffer drawCount_{};
+
+    DescriptorSetLayout cullDescriptorSetLayout_{};
+    PipelineLayout cullPipelineLayout_{};
+    ComputePipeline cullPipeline_{};
+    DescriptorPool cullDescriptorPool_{};
+    DescriptorSet cullDescriptorSet_{};
+
+    DeviceImage<> hiZImage_{};
+    std::vector<ImageView> hiZViews_{};
+    ImageView hiZFullView_{};
+    Sampler hiZSampler_{};
+    DescriptorSetLayout hiZDescriptorSetLayout_{};
+    PipelineLayout hiZPipelineLayout_{};
+    ComputePipeline hiZPipeline_{};
+    DescriptorPool hiZDescriptorPool_{};
+    std::vector<DescriptorSet> hiZDescriptorSets_{};
+
+    VkExtent2D depthExtent_{};
+    VkExtent2D hiZExtent_{};
+    uint32_t hiZMipCount_{0};
+
+    uint32_t maxInstanceCount_{0};
+    uint32_t instanceCount_{0};
+    bool hiZEnabled_{false};
+    bool hiZNeedsTransition_{false};
+    bool hiZBuilt_{false};
+
+    bool initialized_{false};
+
+    bool createHiZPyramid(const VkExtent2D extent)
+    {
+        hiZViews_.clear();
+        hiZFullView_.clear();
+        hiZImage_.clear();
+
+        hiZExtent_ = extent;
+        hiZMipCount_
+            = static_cast<uint32_t>(std::floor(std::log2(std::max(extent.width, extent.height))))
+              + 1;
+
+        VKW_CHECK_BOOL_RETURN_FALSE(hiZImage_.init(
+            *device_,
+            VK_IMAGE_TYPE_2D,
+            VK_FORMAT_R32_SFLOAT,
+            VkExtent3D{extent.width, extent.height, 1},
+            VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+            1,
+            VK_IMAGE_TILING_OPTIMAL,
+            hiZMipCount_));
+
+        hiZViews_.resize(hiZMipCount_);
+        for(uint32_t i = 0; i < hiZMipCount_; ++i)
+        {
+            VKW_CHECK_BOOL_RETURN_FALSE(hiZViews_[i].init(
+                *device_,
+                hiZImage_,
+                VK_IMAGE_VIEW_TYPE_2D,
+                VK_FORMAT_R32_SFLOAT,
+                {VK_IMAGE_ASPECT_COLOR_BIT, i, 1, 0, 1}));
+        }
+        VKW_CHECK_BOOL_RETURN_FALSE(hiZFullView_.init(
+            *device_,
+            hiZImage_,
+            VK_IMAGE_VIEW_TYPE_2D,
+            VK_FORMAT_R32_SFLOAT,
+            {VK_IMAGE_ASPECT_COLOR_BIT, 0, hiZMipCount_, 0, 1}));
+
+        if(!hiZSampler_.initialized())
+        {
+            VkSamplerCreateInfo samplerInfo = {};
+            samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+            samplerInfo.magFilter = VK_FILTER_NEAREST;
+            samplerInfo.minFilter = VK_FILTER_NEAREST;
+            samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+            samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+            samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+            samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+            samplerInfo.minLod = 0.0f;
+            samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+            VKW_CHECK_BOOL_RETURN_FALSE(hiZSampler_.init(*device_, samplerInfo));
+        }
+
+        hiZNeedsTransition_ = true;
+        hiZBuilt_ = false;
+        return true;
+    }
+
+    void transitionHiZ(CommandBuffer& cmdBuffer)
+    {
+        if(!hiZNeedsTransition_)
+        {
+            return;
+        }
+
+        // Pyramid content stays undefined until the first buildHiZ(), the culling pass ignores it
+        // until then
+        cmdBuffer.imageMemoryBarrier(
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            createImageMemoryBarrier(
+                hiZImage_,
+                0,
+                VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                VK_IMAGE_LAYOUT_UNDEFINED,
+                VK_IMAGE_LAYOUT_GENERAL,
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                0,
+                hiZMipCount_));
+        hiZNeedsTransition_ = false;
+    }
+};
+} // namespace vkw
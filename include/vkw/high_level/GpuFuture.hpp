@@ -0,0 +1,694 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "vkw/vkw.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace vkw
+{
+// Small pool of threads running host callbacks once timeline semaphores reach given values. One
+// thread waits on every registered semaphore at once with vkWaitSemaphores in "any" mode, and
+// hands the callbacks over to the worker threads. Registering a wait signals an internal
+// semaphore that wakes the waiting thread up. Fences can not be part of that wait, they are
+// polled instead while any is pending. Semaphores and fences must outlive their pending waits.
+// The device must enable timeline semaphores.
+class CompletionPool
+{
+  public:
+    using Callback = std::function<void()>;
+
+    static constexpr uint32_t defaultThreadCount = 2;
+
+    CompletionPool() {}
+    CompletionPool(Device& device, const uint32_t threadCount = defaultThreadCount)
+    {
+        VKW_CHECK_BOOL_FAIL(this->init(device, threadCount), "Initializing completion pool");
+    }
+
+    // Threads refer to this object, it can not be moved
+    CompletionPool(const CompletionPool&) = delete;
+    CompletionPool(CompletionPool&&) = delete;
+
+    CompletionPool& operator=(const CompletionPool&) = delete;
+    CompletionPool& operator=(CompletionPool&&) = delete;
+
+    ~CompletionPool() { this->clear(); }
+
+    bool init(Device& device, const uint32_t threadCount = defaultThreadCount)
+    {
+        VKW_ASSERT(this->initialized() == false);
+        VKW_ASSERT(threadCount > 0);
+
+        device_ = &device;
+
+        VKW_INIT_CHECK_BOOL(wakeSemaphore_.init(*device_, 0));
+        wakeValue_ = 0;
+        stop_ = false;
+
+        waitThread_ = std::thread([this] { this->waitLoop(); });
+        for(uint32_t i = 0; i < threadCount; ++i)
+        {
+            workerThreads_.emplace_back([this] { this->workerLoop(); });
+        }
+
+        initialized_ = true;
+
+        return true;
+    }
+
+    // Callbacks already ready are run, the ones still waiting on the GPU are dropped
+    void clear()
+    {
+        if(waitThread_.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+                wakeSemaphore_.signal(++wakeValue_);
+            }
+            readyCondition_.notify_all();
+
+            waitThread_.join();
+            for(auto& thread : workerThreads_)
+            {
+                thread.join();
+            }
+        }
+        workerThreads_.clear();
+
+        if(!waits_.empty() || !fenceWaits_.empty())
+        {
+            utils::Log::Warning(
+                "vkw",
+                "Completion pool: dropping %zu pending callbacks",
+                waits_.size() + fenceWaits_.size());
+        }
+        waits_.clear();
+        fenceWaits_.clear();
+        ready_.clear();
+
+        wakeSemaphore_.clear();
+        wakeValue_ = 0;
+
+        device_ = nullptr;
+        initialized_ = false;
+    }
+
+    bool initialized() const { return initialized_; }
+
+    Device& device() const { return *device_; }
+
+    // Runs callback on a pool thread once semaphore reaches value
+    void enqueue(const VkSemaphore semaphore, const uint64_t value, Callback&& callback)
+    {
+        VKW_ASSERT(this->initialized());
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        waits_.push_back({semaphore, value, std::move(callback)});
+        wakeSemaphore_.signal(++wakeValue_);
+    }
+
+    // Runs callback on a pool thread once fence is signaled
+    void enqueueFence(const VkFence fence, Callback&& callback)
+    {
+        VKW_ASSERT(this->initialized());
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        fenceWaits_.push_back({fence, std::move(callback)});
+        wakeSemaphore_.signal(++wakeValue_);
+    }
+
+    // Runs callback on a pool thread as soon as one is available
+    void post(Callback&& callback)
+    {
+        VKW_ASSERT(this->initialized());
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ready_.push_back(std::move(callback));
+        }
+        readyCondition_.notify_one();
+    }
+
+  private:
+    // Registrations wake the waiting thread up, this is only a safety net
+    static constexpr uint64_t waitTimeout = 100000000;     // 100 ms
+    static constexpr uint64_t fencePollInterval = 1000000; // 1 ms
+
+    struct Wait
+    {
+        VkSemaphore semaphore;
+        uint64_t value;
+        Callback callback;
+    };
+
+    struct FenceWait
+    {
+        VkFence fence;
+        Callback callback;
+    };
+
+    Device* device_{nullptr};
+
+    TimelineSemaphore wakeSemaphore_{};
+    uint64_t wakeValue_{0};
+
+    std::mutex mutex_{};
+    std::condition_variable readyCondition_{};
+    std::vector<Wait> waits_{};
+    std::vector<FenceWait> fenceWaits_{};
+    std::deque<Callback> ready_{};
+    bool stop_{false};
+
+    std::thread waitThread_{};
+    std::vector<std::thread> workerThreads_{};
+
+    bool initialized_{false};
+
+    void waitLoop()
+    {
+        std::vector<VkSemaphore> semaphores{};
+        std::vector<uint64_t> values{};
+        while(true)
+        {
+            uint64_t timeout = waitTimeout;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if(stop_)
+                {
+                    return;
+                }
+
+                semaphores.clear();
+                values.clear();
+                semaphores.push_back(wakeSemaphore_.getHandle());
+                values.push_back(wakeValue_ + 1);
+                for(const auto& wait : waits_)
+                {
+                    semaphores.push_back(wait.semaphore);
+                    values.push_back(wait.value);
+                }
+                if(!fenceWaits_.empty())
+                {
+                    timeout = fencePollInterval;
+                }
+            }
+
+            VkSemaphoreWaitInfo waitInfo = {};
+            waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+            waitInfo.pNext = nullptr;
+            waitInfo.flags = VK_SEMAPHORE_WAIT_ANY_BIT;
+            waitInfo.semaphoreCount = static_cast<uint32_t>(semaphores.size());
+            waitInfo.pSemaphores = semaphores.data();
+            waitInfo.pValues = values.data();
+            const VkResult res
+                = device_->vk().vkWaitSemaphores(device_->getHandle(), &waitInfo, timeout);
+            if(res != VK_SUCCESS && res != VK_TIMEOUT)
+            {
+                utils::Log::Error("vkw", "Completion pool: error waiting for semaphores");
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+
+            bool hasReady = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                hasReady |= moveReady(waits_, [this](const Wait& wait) {
+                    uint64_t value = 0;
+                    device_->vk().vkGetSemaphoreCounterValue(
+                        device_->getHandle(), wait.semaphore, &value);
+                    return value >= wait.value;
+                });
+                hasReady |= moveReady(fenceWaits_, [this](const FenceWait& wait) {
+                    return device_->vk().vkGetFenceStatus(device_->getHandle(), wait.fence)
+                           == VK_SUCCESS;
+                });
+            }
+            if(hasReady)
+            {
+                readyCondition_.notify_all();
+            }
+        }
+    }
+
+    // Moves the callbacks of completed waits to the ready list, mutex_ must be held
+    template <typename WaitType, typename Fn>
+    bool moveReady(std::vector<WaitType>& waits, Fn&& isComplete)
+    {
+        bool ret = false;
+        for(size_t i = 0; i < waits.size();)
+        {
+            if(!isComplete(waits[i]))
+            {
+                ++i;
+                continue;
+            }
+
+            ready_.push_back(std::move(waits[i].callback));
+            if(i + 1 < waits.size())
+            {
+                waits[i] = std::move(waits.back());
+            }
+            waits.pop_back();
+            ret = true;
+        }
+        return ret;
+    }
+
+    void workerLoop()
+    {
+        while(true)
+        {
+            Callback callback{};
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                readyCondition_.wait(lock, [this] { return stop_ || !ready_.empty(); });
+                if(ready_.empty())
+                {
+                    return;
+                }
+                callback = std::move(ready_.front());
+                ready_.pop_front();
+            }
+            callback();
+        }
+    }
+};
+
+// -------------------------------------------------------------------------------------------------
+
+// State shared by a GpuFuture and its copies. Completed either when a timeline semaphore reaches a
+// value, the resolver then producing the result on the host, or from the host by a GpuPromise.
+template <typename T>
+struct GpuFutureState : public std::enable_shared_from_this<GpuFutureState<T>>
+{
+    using Result = std::conditional_t<std::is_void<T>::value, bool, T>;
+
+    CompletionPool* pool{nullptr};
+    VkSemaphore semaphore{VK_NULL_HANDLE};
+    uint64_t value{0};
+    std::function<T()> resolver{};
+
+    std::mutex mutex{};
+    std::condition_variable condition{};
+    std::vector<CompletionPool::Callback> continuations{};
+    Result result{};
+    bool registered{false};
+    bool producing{false};
+    bool completed{false};
+    std::thread::id producer{};
+
+    // Only the first call has an effect, continuations are then posted to the pool. produce() runs
+    // without the mutex held, other callers wait for its result to be published. Returns false
+    // when called from produce() itself, the result is not available yet then.
+    template <typename Fn>
+    bool complete(Fn&& produce)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if(producing)
+            {
+                if(producer == std::this_thread::get_id())
+                {
+                    return false;
+                }
+                condition.wait(lock, [this] { return completed; });
+            }
+            if(completed)
+            {
+                return true;
+            }
+            producing = true;
+            producer = std::this_thread::get_id();
+        }
+
+        Result value{};
+        if constexpr(std::is_void<T>::value)
+        {
+            produce();
+            value = true;
+        }
+        else
+        {
+            value = produce();
+        }
+
+        std::vector<CompletionPool::Callback> callbacks{};
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            result = std::move(value);
+            producing = false;
+            completed = true;
+            callbacks.swap(continuations);
+        }
+        condition.notify_all();
+
+        for(auto& callback : callbacks)
+        {
+            pool->post(std::move(callback));
+        }
+        return true;
+    }
+
+    bool completeFromGpu()
+    {
+        if constexpr(std::is_void<T>::value)
+        {
+            return complete([this] {
+                if(resolver)
+                {
+                    resolver();
+                }
+            });
+        }
+        else
+        {
+            return complete([this] { return resolver ? resolver() : T{}; });
+        }
+    }
+
+    bool isCompleted()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return completed;
+    }
+
+    bool gpuValueReached() const
+    {
+        const auto& device = pool->device();
+
+        uint64_t currentValue = 0;
+        device.vk().vkGetSemaphoreCounterValue(device.getHandle(), semaphore, &currentValue);
+        return currentValue >= value;
+    }
+
+    VkResult waitGpu(const uint64_t timeout) const
+    {
+        const auto& device = pool->device();
+
+        VkSemaphoreWaitInfo waitInfo = {};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.pNext = nullptr;
+        waitInfo.flags = 0;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &semaphore;
+        waitInfo.pValues = &value;
+        return device.vk().vkWaitSemaphores(device.getHandle(), &waitInfo, timeout);
+    }
+
+    void addContinuation(CompletionPool::Callback&& callback)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(!completed)
+            {
+                continuations.push_back(std::move(callback));
+
+                // GPU backed states only involve the pool once a continuation needs it
+                if(semaphore != VK_NULL_HANDLE && !registered)
+                {
+                    registered = true;
+                    auto self = this->shared_from_this();
+                    pool->enqueue(semaphore, value, [self] { self->completeFromGpu(); });
+                }
+                return;
+            }
+        }
+        pool->post(std::move(callback));
+    }
+};
+
+template <typename T, typename Fn>
+struct GpuContinuationResult
+{
+    using type = std::invoke_result_t<Fn, const T&>;
+};
+template <typename Fn>
+struct GpuContinuationResult<void, Fn>
+{
+    using type = std::invoke_result_t<Fn>;
+};
+
+template <typename T>
+class GpuPromise;
+
+// Result of GPU work, available once a timeline semaphore reaches a given value. Copies share the
+// same state. Continuations attached with then() run on the completion pool, so host code can
+// chain work without a thread blocked per pending job.
+template <typename T = void>
+class GpuFuture
+{
+  public:
+    using State = GpuFutureState<T>;
+
+    GpuFuture() {}
+
+    // The resolver runs once on the host when the value is reached, to produce the result (e.g.
+    // reading back a staging buffer). Without resolver non void results are value initialized.
+    GpuFuture(
+        CompletionPool& pool,
+        const VkSemaphore semaphore,
+        const uint64_t value,
+        std::function<T()> resolver = {})
+        : state_{std::make_shared<State>()}
+    {
+        VKW_ASSERT(semaphore != VK_NULL_HANDLE);
+
+        state_->pool = &pool;
+        state_->semaphore = semaphore;
+        state_->value = value;
+        state_->resolver = std::move(resolver);
+    }
+
+    explicit GpuFuture(std::shared_ptr<State> state) : state_{std::move(state)} {}
+
+    GpuFuture(const GpuFuture&) = default;
+    GpuFuture(GpuFuture&&) = default;
+
+    GpuFuture& operator=(const GpuFuture&) = default;
+    GpuFuture& operator=(GpuFuture&&) = default;
+
+    ~GpuFuture() {}
+
+    bool valid() const { return state_ != nullptr; }
+
+    CompletionPool& pool() const
+    {
+        VKW_ASSERT(this->valid());
+        return *state_->pool;
+    }
+
+    // Non blocking
+    bool ready() const
+    {
+        VKW_ASSERT(this->valid());
+
+        if(state_->isCompleted())
+        {
+            return true;
+        }
+        if(state_->semaphore != VK_NULL_HANDLE && state_->gpuValueReached())
+        {
+            return state_->completeFromGpu();
+        }
+        return false;
+    }
+
+    // Timeout in nanoseconds, returns false if it expired
+    bool wait(const uint64_t timeout = ~uint64_t(0)) const
+    {
+        VKW_ASSERT(this->valid());
+
+        if(state_->semaphore != VK_NULL_HANDLE)
+        {
+            if(!state_->isCompleted())
+            {
+                if(state_->waitGpu(timeout) != VK_SUCCESS)
+                {
+                    return false;
+                }
+                return state_->completeFromGpu();
+            }
+            return true;
+        }
+
+        std::unique_lock<std::mutex> lock(state_->mutex);
+        const auto isCompleted = [this] { return state_->completed; };
+        if(timeout == ~uint64_t(0))
+        {
+            state_->condition.wait(lock, isCompleted);
+            return true;
+        }
+
+        const auto maxTimeout = static_cast<uint64_t>(std::chrono::nanoseconds::max().count());
+        return state_->condition.wait_for(
+            lock,
+            std::chrono::nanoseconds(static_cast<int64_t>(std::min(timeout, maxTimeout))),
+            isCompleted);
+    }
+
+    // Blocks until completion
+    template <typename U = T>
+    std::enable_if_t<!std::is_void<U>::value, const U&> get() const
+    {
+        this->wait();
+        return state_->result;
+    }
+    template <typename U = T>
+    std::enable_if_t<std::is_void<U>::value> get() const
+    {
+        this->wait();
+    }
+
+    // Runs callback on the completion pool once the future has completed
+    void onComplete(CompletionPool::Callback&& callback) const
+    {
+        VKW_ASSERT(this->valid());
+        state_->addContinuation(std::move(callback));
+    }
+
+    // Returns the future of fn(result), or fn() for void futures, run on the completion pool
+    template <typename Fn>
+    auto then(Fn&& fn) const
+    {
+        using R = typename GpuContinuationResult<T, std::decay_t<Fn>>::type;
+
+        VKW_ASSERT(this->valid());
+
+        GpuPromise<R> promise(*state_->pool);
+        auto source = state_;
+        state_->addContinuation([source, promise, fn = std::forward<Fn>(fn)]() mutable {
+            promise.complete([&]() -> R {
+                if constexpr(std::is_void<T>::value)
+                {
+                    return fn();
+                }
+                else
+                {
+                    return fn(source->result);
+                }
+            });
+        });
+
+        return promise.future();
+    }
+
+  private:
+    std::shared_ptr<State> state_{};
+};
+
+// Host side completion of a GpuFuture
+template <typename T = void>
+class GpuPromise
+{
+  public:
+    using State = GpuFutureState<T>;
+
+    explicit GpuPromise(CompletionPool& pool) : state_{std::make_shared<State>()}
+    {
+        state_->pool = &pool;
+    }
+
+    GpuFuture<T> future() const { return GpuFuture<T>(state_); }
+
+    template <typename... Args>
+    void setValue(Args&&... args)
+    {
+        if constexpr(std::is_void<T>::value)
+        {
+            static_assert(sizeof...(Args) == 0, "Void promises take no value");
+            complete([] {});
+        }
+        else
+        {
+            complete([&] { return T(std::forward<Args>(args)...); });
+        }
+    }
+
+    // Completes with the value returned by produce()
+    template <typename Fn>
+    void complete(Fn&& produce)
+    {
+        state_->complete(std::forward<Fn>(produce));
+    }
+
+  private:
+    std::shared_ptr<State> state_{};
+};
+
+// Completes once all the futures have completed
+template <typename T>
+GpuFuture<void> whenAll(CompletionPool& pool, const std::vector<GpuFuture<T>>& futures)
+{
+    GpuPromise<void> promise(pool);
+    if(futures.empty())
+    {
+        promise.setValue();
+        return promise.future();
+    }
+
+    auto remaining = std::make_shared<std::atomic<size_t>>(futures.size());
+    for(const auto& future : futures)
+    {
+        future.onComplete([promise, remaining]() mutable {
+            if(remaining->fetch_sub(1) == 1)
+            {
+                promise.setValue();
+            }
+        });
+    }
+
+    return promise.future();
+}
+
+template <typename... Ts>
+GpuFuture<void> whenAll(CompletionPool& pool, const GpuFuture<Ts>&... futures)
+{
+    static_assert(sizeof...(Ts) > 0, "At least one future is required");
+
+    GpuPromise<void> promise(pool);
+    auto remaining = std::make_shared<std::atomic<size_t>>(sizeof...(Ts));
+    const auto onComplete = [promise, remaining]() mutable {
+        if(remaining->fetch_sub(1) == 1)
+        {
+            promise.setValue();
+        }
+    };
+    (futures.onComplete(onComplete), ...);
+
+    return promise.future();
+}
+} // namespace vkw
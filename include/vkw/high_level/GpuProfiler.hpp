@@ -0,0 +1,389 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "vkw/vkw.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace vkw
+{
+// Measures GPU time spent in named scopes using timestamp queries. One query pool is kept per
+// frame in flight so that results of a frame can be read back once its fence has been waited,
+// without ever stalling on the GPU.
+class GpuProfiler
+{
+  public:
+    struct ScopeTiming
+    {
+        std::string name{};
+        uint32_t depth{0};
+        uint64_t startNs{0}; ///< Relative to the first scope of the frame
+        uint64_t durationNs{0};
+    };
+
+    class Scope
+    {
+      public:
+        Scope() {}
+
+        Scope(const Scope&) = delete;
+        Scope(Scope&& cp) { *this = std::move(cp); }
+
+        Scope& operator=(const Scope&) = delete;
+        Scope& operator=(Scope&& cp)
+        {
+            this->end();
+            std::swap(profiler_, cp.profiler_);
+            std::swap(cmdBuffer_, cp.cmdBuffer_);
+            std::swap(frameId_, cp.frameId_);
+            std::swap(scopeId_, cp.scopeId_);
+            return *this;
+        }
+
+        ~Scope() { this->end(); }
+
+        void end()
+        {
+            if(profiler_ != nullptr)
+            {
+                profiler_->endScope(*cmdBuffer_, frameId_, scopeId_);
+            }
+            profiler_ = nullptr;
+            cmdBuffer_ = nullptr;
+        }
+
+      private:
+        friend class GpuProfiler;
+
+        Scope(
+            GpuProfiler* profiler,
+            CommandBuffer* cmdBuffer,
+            const uint32_t frameId,
+            const uint32_t scopeId)
+            : profiler_{profiler}, cmdBuffer_{cmdBuffer}, frameId_{frameId}, scopeId_{scopeId}
+        {}
+
+        GpuProfiler* profiler_{nullptr};
+        CommandBuffer* cmdBuffer_{nullptr};
+        uint32_t frameId_{0};
+        uint32_t scopeId_{0};
+    };
+
+    static constexpr uint32_t defaultMaxScopeCount = 256;
+
+    GpuProfiler() {}
+    GpuProfiler(
+        Device& device,
+        const uint32_t framesInFlight,
+        const uint32_t maxScopeCount = defaultMaxScopeCount)
+    {
+        VKW_CHECK_BOOL_FAIL(
+            this->init(device, framesInFlight, maxScopeCount), "Initializing GPU profiler");
+    }
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler(GpuProfiler&& cp) { *this = std::move(cp); }
+
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(GpuProfiler&& cp)
+    {
+        this->clear();
+        std::swap(device_, cp.device_);
+        std::swap(frames_, cp.frames_);
+        std::swap(results_, cp.results_);
+        std::swap(maxScopeCount_, cp.maxScopeCount_);
+        std::swap(frameId_, cp.frameId_);
+        std::swap(timestampPeriod_, cp.timestampPeriod_);
+        std::swap(timestampMask_, cp.timestampMask_);
+        std::swap(enabled_, cp.enabled_);
+        std::swap(initialized_, cp.initialized_);
+        return *this;
+    }
+
+    ~GpuProfiler() { this->clear(); }
+
+    bool init(
+        Device& device,
+        const uint32_t framesInFlight,
+        const uint32_t maxScopeCount = defaultMaxScopeCount)
+    {
+        VKW_ASSERT(this->initialized() == false);
+        VKW_ASSERT(framesInFlight > 0);
+
+        device_ = &device;
+        maxScopeCount_ = maxScopeCount;
+
+        const auto& properties = device_->getProperties();
+        timestampPeriod_ = properties.limits.timestampPeriod;
+        timestampMask_ = getTimestampMask(device_->getTimestampValidBits());
+        enabled_ = (properties.limits.timestampComputeAndGraphics == VK_TRUE)
+                   && (timestampMask_ != 0);
+
+        if(!enabled_)
+        {
+            utils::Log::Warning("vkw", "Timestamp queries not supported, GPU profiler disabled");
+            initialized_ = true;
+            return true;
+        }
+
+        frames_.resize(framesInFlight);
+        for(auto& frame : frames_)
+        {
+            VKW_INIT_CHECK_BOOL(
+                frame.queryPool.init(*device_, VK_QUERY_TYPE_TIMESTAMP, 2 * maxScopeCount_));
+            frame.scopes.reserve(maxScopeCount_);
+        }
+
+        initialized_ = true;
+
+        return true;
+    }
+
+    void clear()
+    {
+        frames_.clear();
+        results_.clear();
+
+        maxScopeCount_ = 0;
+        frameId_ = 0;
+        timestampPeriod_ = 1.0f;
+        timestampMask_ = ~uint64_t(0);
+        enabled_ = false;
+
+        device_ = nullptr;
+        initialized_ = false;
+    }
+
+    bool initialized() const { return initialized_; }
+    bool enabled() const { return enabled_; }
+
+    // Must be recorded in the first command buffer submitted for the frame. The caller is
+    // expected to have waited on the fence of the frame that previously used the same slot.
+    void beginFrame(CommandBuffer& cmdBuffer)
+    {
+        VKW_ASSERT(this->initialized());
+        if(!enabled_)
+        {
+            return;
+        }
+
+        frameId_ = (frameId_ + 1) % static_cast<uint32_t>(frames_.size());
+
+        auto& frame = frames_[frameId_];
+        if(frame.pending && !resolveFrame(frame))
+        {
+            utils::Log::Debug("vkw", "GPU profiler: dropping unresolved frame results");
+        }
+
+        frame.scopes.clear();
+        frame.depth = 0;
+        frame.pending = false;
+        frame.recording = true;
+        cmdBuffer.resetQueryPool(frame.queryPool);
+    }
+
+    void endFrame()
+    {
+        if(!enabled_)
+        {
+            return;
+        }
+
+        auto& frame = frames_[frameId_];
+        VKW_ASSERT(frame.depth == 0);
+        frame.recording = false;
+        frame.pending = !frame.scopes.empty();
+    }
+
+    [[nodiscard]] Scope scope(
+        CommandBuffer& cmdBuffer,
+        const std::string& name,
+        const VkPipelineStageFlagBits stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT)
+    {
+        if(!enabled_)
+        {
+            return Scope{};
+        }
+
+        auto& frame = frames_[frameId_];
+        VKW_ASSERT(frame.recording);
+        if(frame.scopes.size() >= maxScopeCount_)
+        {
+            utils::Log::Warning(
+                "vkw", "GPU profiler: scope limit reached, skipping %s", name.c_str());
+            return Scope{};
+        }
+
+        const uint32_t scopeId = static_cast<uint32_t>(frame.scopes.size());
+        frame.scopes.push_back({name, frame.depth++, 0, 0});
+        cmdBuffer.beginLabel(name.c_str());
+        cmdBuffer.writeTimestamp(frame.queryPool, 2 * scopeId, stage);
+
+        return Scope{this, &cmdBuffer, frameId_, scopeId};
+    }
+
+    // Non blocking, reads back every frame whose queries are all available. Returns true if the
+    // results have been updated.
+    bool resolve()
+    {
+        bool updated = false;
+        for(size_t i = 1; i <= frames_.size(); ++i)
+        {
+            // Oldest frames first so that results_ ends up holding the most recent one
+            auto& frame = frames_[(frameId_ + i) % frames_.size()];
+            if(frame.pending)
+            {
+                updated |= resolveFrame(frame);
+            }
+        }
+        return updated;
+    }
+
+    const std::vector<ScopeTiming>& getResults() const { return results_; }
+
+    uint64_t getDuration(const std::string& name) const
+    {
+        uint64_t ret = 0;
+        for(const auto& timing : results_)
+        {
+            if(timing.name == name)
+            {
+                ret += timing.durationNs;
+            }
+        }
+        return ret;
+    }
+
+  private:
+    struct ScopeInfo
+    {
+        std::string name;
+        uint32_t depth;
+        uint64_t begin;
+        uint64_t end;
+    };
+
+    struct FrameData
+    {
+        QueryPool queryPool{};
+        std::vector<ScopeInfo> scopes{};
+        std::vector<uint64_t> queryResults{};
+        uint32_t depth{0};
+        bool recording{false};
+        bool pending{false};
+    };
+
+    Device* device_{nullptr};
+
+    std::vector<FrameData> frames_{};
+    std::vector<ScopeTiming> results_{};
+
+    uint32_t maxScopeCount_{0};
+    uint32_t frameId_{0};
+
+    float timestampPeriod_{1.0f};
+    uint64_t timestampMask_{~uint64_t(0)};
+
+    bool enabled_{false};
+    bool initialized_{false};
+
+    void endScope(
+        CommandBuffer& cmdBuffer,
+        const uint32_t frameId,
+        const uint32_t scopeId,
+        const VkPipelineStageFlagBits stage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT)
+    {
+        auto& frame = frames_[frameId];
+        VKW_ASSERT(frame.recording);
+        VKW_ASSERT(frame.depth > 0);
+
+        cmdBuffer.writeTimestamp(frame.queryPool, 2 * scopeId + 1, stage);
+        cmdBuffer.endLabel();
+        frame.depth--;
+    }
+
+    bool resolveFrame(FrameData& frame)
+    {
+        const uint32_t queryCount = 2 * static_cast<uint32_t>(frame.scopes.size());
+
+        // Each query is followed by its availability value
+        const auto res = frame.queryPool.getResults(
+            0, queryCount, frame.queryResults, VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+        if(res != VK_SUCCESS && res != VK_NOT_READY)
+        {
+            utils::Log::Error("vkw", "GPU profiler: error reading query results");
+            frame.pending = false;
+            return false;
+        }
+
+        for(uint32_t i = 0; i < queryCount; ++i)
+        {
+            if(frame.queryResults[2 * i + 1] == 0)
+            {
+                return false;
+            }
+        }
+
+        uint64_t frameStart = ~uint64_t(0);
+        for(size_t i = 0; i < frame.scopes.size(); ++i)
+        {
+            auto& scope = frame.scopes[i];
+            scope.begin = frame.queryResults[4 * i] & timestampMask_;
+            scope.end = frame.queryResults[4 * i + 2] & timestampMask_;
+            frameStart = std::min(frameStart, scope.begin);
+        }
+
+        results_.resize(frame.scopes.size());
+        for(size_t i = 0; i < frame.scopes.size(); ++i)
+        {
+            const auto& scope = frame.scopes[i];
+            auto& timing = results_[i];
+            timing.name = scope.name;
+            timing.depth = scope.depth;
+            timing.startNs = toNanoSeconds(scope.begin - frameStart);
+            timing.durationNs = toNanoSeconds(scope.end - scope.begin);
+        }
+
+        frame.pending = false;
+        return true;
+    }
+
+    uint64_t toNanoSeconds(const uint64_t ticks) const
+    {
+        return static_cast<uint64_t>(
+            static_cast<double>(ticks & timestampMask_) * static_cast<double>(timestampPeriod_));
+    }
+
+    static uint64_t getTimestampMask(const uint32_t validBits)
+    {
+        if(validBits == 0)
+        {
+            return 0;
+        }
+        return (validBits >= 64) ? ~uint64_t(0) : ((uint64_t(1) << validBits) - 1);
+    }
+};
+} // namespace vkw
@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "vkw/vkw.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace vkw
+{
+// Everything a GraphicsPipeline bakes, recorded as dynamic state instead. Meant for shader
+// objects, which carry no state: every state read by a draw must be set on the command buffer.
+// Defaults are those of GraphicsPipeline, with one color attachment.
+// apply() with the state of the previous draw only records what differs, consecutive draws of a
+// material system usually share most of their state.
+struct GraphicsState
+{
+    std::vector<VkViewport> viewports = std::vector<VkViewport>(1);
+    std::vector<VkRect2D> scissors = std::vector<VkRect2D>(1);
+
+    // Vertex input, ignored by mesh shaders
+    std::vector<VkVertexInputBindingDescription2EXT> vertexBindings{};
+    std::vector<VkVertexInputAttributeDescription2EXT> vertexAttributes{};
+    VkPrimitiveTopology topology{VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST};
+    VkBool32 primitiveRestartEnable{VK_FALSE};
+
+    // Tessellation states are only recorded when patchControlPoints is set
+    uint32_t patchControlPoints{0};
+    VkTessellationDomainOrigin domainOrigin{VK_TESSELLATION_DOMAIN_ORIGIN_UPPER_LEFT};
+
+    // Rasterization
+    VkBool32 rasterizerDiscardEnable{VK_FALSE};
+    VkBool32 depthClampEnable{VK_FALSE};
+    VkPolygonMode polygonMode{VK_POLYGON_MODE_FILL};
+    VkCullModeFlags cullMode{VK_CULL_MODE_NONE};
+    VkFrontFace frontFace{VK_FRONT_FACE_CLOCKWISE};
+    VkBool32 depthBiasEnable{VK_FALSE};
+    float depthBiasConstantFactor{0.0f};
+    float depthBiasClamp{0.0f};
+    float depthBiasSlopeFactor{0.0f};
+    float lineWidth{1.0f};
+
+    // Multisampling, up to 32 samples
+    VkSampleCountFlagBits rasterizationSamples{VK_SAMPLE_COUNT_1_BIT};
+    VkSampleMask sampleMask{~0u};
+    VkBool32 alphaToCoverageEnable{VK_FALSE};
+    VkBool32 alphaToOneEnable{VK_FALSE};
+
+    // Depth stencil
+    VkBool32 depthTestEnable{VK_TRUE};
+    VkBool32 depthWriteEnable{VK_TRUE};
+    VkCompareOp depthCompareOp{VK_COMPARE_OP_LESS};
+    VkBool32 depthBoundsTestEnable{VK_FALSE};
+    float minDepthBounds{0.0f};
+    float maxDepthBounds{1.0f};
+    VkBool32 stencilTestEnable{VK_FALSE};
+    VkStencilOpState front{};
+    VkStencilOpState back{};
+
+    // Color blend, one entry per color attachment
+    VkBool32 logicOpEnable{VK_FALSE};
+    VkLogicOp logicOp{VK_LOGIC_OP_COPY};
+    std::vector<VkBool32> colorBlendEnables = {VK_FALSE};
+    std::vector<VkColorBlendEquationEXT> colorBlendEquations = {defaultBlendEquation()};
+    std::vector<VkColorComponentFlags> colorWriteMasks = {defaultColorWriteMask()};
+    float blendConstants[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+
+    GraphicsState& addVertexBinding(
+        const uint32_t binding,
+        const uint32_t stride,
+        const VkVertexInputRate inputRate = VK_VERTEX_INPUT_RATE_VERTEX)
+    {
+        VkVertexInputBindingDescription2EXT description{};
+        description.sType = VK_STRUCTURE_TYPE_VERTEX_INPUT_BINDING_DESCRIPTION_2_EXT;
+        description.pNext = nullptr;
+        description.binding = binding;
+        description.stride = stride;
+        description.inputRate = inputRate;
+        description.divisor = 1;
+        vertexBindings.push_back(description);
+        return *this;
+    }
+
+    GraphicsState& addVertexAttribute(
+        const uint32_t location,
+        const uint32_t binding,
+        const VkFormat format,
+        const uint32_t offset)
+    {
+        VkVertexInputAttributeDescription2EXT description{};
+        description.sType = VK_STRUCTURE_TYPE_VERTEX_INPUT_ATTRIBUTE_DESCRIPTION_2_EXT;
+        description.pNext = nullptr;
+        description.location = location;
+        description.binding = binding;
+        description.format = format;
+        description.offset = offset;
+        vertexAttributes.push_back(description);
+        return *this;
+    }
+
+    // New attachments get the default blend state
+    GraphicsState& setColorAttachmentCount(const uint32_t count)
+    {
+        colorBlendEnables.resize(count, VK_FALSE);
+        colorBlendEquations.resize(count, defaultBlendEquation());
+        colorWriteMasks.resize(count, defaultColorWriteMask());
+        return *this;
+    }
+
+    // Records every state, or only the ones differing from previous if given
+    void apply(CommandBuffer& cmdBuffer, const GraphicsState* previous = nullptr) const
+    {
+        const bool all = (previous == nullptr);
+
+        if(all || !equal(viewports, previous->viewports))
+        {
+            cmdBuffer.setViewportWithCount(viewports);
+        }
+        if(all || !equal(scissors, previous->scissors))
+        {
+            cmdBuffer.setScissorWithCount(scissors);
+        }
+
+        if(all || !equal(vertexBindings, previous->vertexBindings)
+           || !equal(vertexAttributes, previous->vertexAttributes))
+        {
+            cmdBuffer.setVertexInput(vertexBindings, vertexAttributes);
+        }
+        if(all || topology != previous->topology)
+        {
+            cmdBuffer.setPrimitiveTopology(topology);
+        }
+        if(all || primitiveRestartEnable != previous->primitiveRestartEnable)
+        {
+            cmdBuffer.setPrimitiveRestartEnable(primitiveRestartEnable);
+        }
+
+        if(patchControlPoints > 0)
+        {
+            if(all || patchControlPoints != previous->patchControlPoints)
+            {
+                cmdBuffer.setPatchControlPoints(patchControlPoints);
+            }
+            if(all || domainOrigin != previous->domainOrigin)
+            {
+                cmdBuffer.setTessellationDomainOrigin(domainOrigin);
+            }
+        }
+
+        if(all || rasterizerDiscardEnable != previous->rasterizerDiscardEnable)
+        {
+            cmdBuffer.setRasterizerDiscardEnable(rasterizerDiscardEnable);
+        }
+        if(all || depthClampEnable != previous->depthClampEnable)
+        {
+            cmdBuffer.setDepthClampEnable(depthClampEnable);
+        }
+        if(all || polygonMode != previous->polygonMode)
+        {
+            cmdBuffer.setPolygonMode(polygonMode);
+        }
+        if(all || cullMode != previous->cullMode)
+        {
+            cmdBuffer.setCullMode(cullMode);
+        }
+        if(all || frontFace != previous->frontFace)
+        {
+            cmdBuffer.setFrontFace(frontFace);
+        }
+        if(all || depthBiasEnable != previous->depthBiasEnable)
+        {
+            cmdBuffer.setDepthBiasEnable(depthBiasEnable);
+        }
+        if(all || depthBiasConstantFactor != previous->depthBiasConstantFactor
+           || depthBiasClamp != previous->depthBiasClamp
+           || depthBiasSlopeFactor != previous->depthBiasSlopeFactor)
+        {
+            cmdBuffer.setDepthBias(depthBiasConstantFactor, depthBiasClamp, depthBiasSlopeFactor);
+        }
+        if(all || lineWidth != previous->lineWidth)
+        {
+            cmdBuffer.setLineWidth(lineWidth);
+        }
+
+        if(all || rasterizationSamples != previous->rasterizationSamples)
+        {
+            cmdBuffer.setRasterizationSamples(rasterizationSamples);
+        }
+        if(all || rasterizationSamples != previous->rasterizationSamples
+           || sampleMask != previous->sampleMask)
+        {
+            cmdBuffer.setSampleMask(rasterizationSamples, {sampleMask});
+        }
+        if(all || alphaToCoverageEnable != previous->alphaToCoverageEnable)
+        {
+            cmdBuffer.setAlphaToCoverageEnable(alphaToCoverageEnable);
+        }
+        if(all || alphaToOneEnable != previous->alphaToOneEnable)
+        {
+            cmdBuffer.setAlphaToOneEnable(alphaToOneEnable);
+        }
+
+        if(all || depthTestEnable != previous->depthTestEnable)
+        {
+            cmdBuffer.setDepthTestEnable(depthTestEnable);
+        }
+        if(all || depthWriteEnable != previous->depthWriteEnable)
+        {
+            cmdBuffer.setDepthWriteEnable(depthWriteEnable);
+        }
+        if(all || depthCompareOp != previous->depthCompareOp)
+        {
+            cmdBuffer.setDepthCompareOp(depthCompareOp);
+        }
+        if(all || depthBoundsTestEnable != previous->depthBoundsTestEnable)
+        {
+            cmdBuffer.setDepthBoundsTestEnable(depthBoundsTestEnable);
+        }
+        if(all || minDepthBounds != previous->minDepthBounds
+           || maxDepthBounds != previous->maxDepthBounds)
+        {
+            cmdBuffer.setDepthBounds(minDepthBounds, maxDepthBounds);
+        }
+        if(all || stencilTestEnable != previous->stencilTestEnable)
+        {
+            cmdBuffer.setStencilTestEnable(stencilTestEnable);
+        }
+        applyStencil(cmdBuffer, VK_STENCIL_FACE_FRONT_BIT, front, all ? nullptr : &previous->front);
+        applyStencil(cmdBuffer, VK_STENCIL_FACE_BACK_BIT, back, all ? nullptr : &previous->back);
+
+        if(all || logicOpEnable != previous->logicOpEnable)
+        {
+            cmdBuffer.setLogicOpEnable(logicOpEnable);
+        }
+        if(all || logicOp != previous->logicOp)
+        {
+            cmdBuffer.setLogicOp(logicOp);
+        }
+        if(all || !equal(colorBlendEnables, previous->colorBlendEnables))
+        {
+            cmdBuffer.setColorBlendEnable(colorBlendEnables);
+        }
+        if(all || !equal(colorBlendEquations, previous->colorBlendEquations))
+        {
+            cmdBuffer.setColorBlendEquation(colorBlendEquations);
+        }
+        if(all || !equal(colorWriteMasks, previous->colorWriteMasks))
+        {
+            cmdBuffer.setColorWriteMask(colorWriteMasks);
+        }
+        if(all || memcmp(blendConstants, previous->blendConstants, sizeof(blendConstants)) != 0)
+        {
+            cmdBuffer.setBlendConstants(
+                blendConstants[0], blendConstants[1], blendConstants[2], blendConstants[3]);
+        }
+    }
+
+  private:
+    static VkColorBlendEquationEXT defaultBlendEquation()
+    {
+        VkColorBlendEquationEXT ret{};
+        ret.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        ret.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        ret.colorBlendOp = VK_BLEND_OP_ADD;
+        ret.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        ret.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+        ret.alphaBlendOp = VK_BLEND_OP_ADD;
+        return ret;
+    }
+
+    static VkColorComponentFlags defaultColorWriteMask()
+    {
+        return VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT
+               | VK_COLOR_COMPONENT_A_BIT;
+    }
+
+    // Bytewise, padding may make equal states differ and record them again, which is harmless
+    template <typename T>
+    static bool equal(const std::vector<T>& v0, const std::vector<T>& v1)
+    {
+        return v0.size() == v1.size()
+               && (v0.empty() || memcmp(v0.data(), v1.data(), v0.size() * sizeof(T)) == 0);
+    }
+
+    static void applyStencil(
+        CommandBuffer& cmdBuffer,
+        const VkStencilFaceFlags face,
+        const VkStencilOpState& state,
+        const VkStencilOpState* previous)
+    {
+        if(previous == nullptr || state.failOp != previous->failOp
+           || state.passOp != previous->passOp || state.depthFailOp != previous->depthFailOp
+           || state.compareOp != previous->compareOp)
+        {
+            cmdBuffer.setStencilOp(
+                face, state.failOp, state.passOp, state.depthFailOp, state.compareOp);
+        }
+        if(previous == nullptr || state.compareMask != previous->compareMask)
+        {
+            cmdBuffer.setStencilCompareMask(face, state.compareMask);
+        }
+        if(previous == nullptr || state.writeMask != previous->writeMask)
+        {
+            cmdBuffer.setStencilWriteMask(face, state.writeMask);
+        }
+        if(previous == nullptr || state.reference != previous->reference)
+        {
+            cmdBuffer.setStencilReference(face, state.reference);
+        }
+    }
+};
+} // namespace vkw
@@ -0,0 +1,453 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "vkw/vkw.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace vkw
+{
+struct JobState
+{
+    std::function<void()> job{};
+    std::atomic<uint32_t> pendingDependencies{1}; ///< Includes a guard held while submitting
+    std::atomic<bool> done{false};
+
+    std::mutex mutex{};
+    std::vector<std::shared_ptr<JobState>> successors{}; ///< Protected by mutex
+};
+
+class JobHandle
+{
+  public:
+    JobHandle() {}
+
+    bool valid() const { return state_ != nullptr; }
+    bool done() const { return state_ == nullptr || state_->done.load(); }
+
+  private:
+    friend class JobSystem;
+
+    explicit JobHandle(std::shared_ptr<JobState> state) : state_{std::move(state)} {}
+
+    std::shared_ptr<JobState> state_{};
+};
+
+// Small work-stealing job system for CPU side work: command recording, pipeline compilation, host
+// side builds... Each worker owns a deque, jobs it spawns are pushed and popped at the back and
+// idle workers steal from the front of the others, jobs submitted from other threads go through
+// a shared queue. Jobs can depend on other jobs and must not throw.
+//
+// Instead of owning threads, the job system can hand its jobs to an external executor, typically
+// the thread pool of the application, each job then being one task posted to it.
+//
+// Threads waiting on a job run other jobs meanwhile, waiting from inside a job is allowed.
+class JobSystem
+{
+  public:
+    using Job = std::function<void()>;
+    // Runs a task on some thread of an external pool
+    using Executor = std::function<void(std::function<void()>&&)>;
+
+    JobSystem() {}
+    explicit JobSystem(const uint32_t workerCount)
+    {
+        VKW_CHECK_BOOL_FAIL(this->init(workerCount), "Initializing job system");
+    }
+    JobSystem(Executor&& executor, const uint32_t concurrency)
+    {
+        VKW_CHECK_BOOL_FAIL(
+            this->init(std::move(executor), concurrency), "Initializing job system");
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem(JobSystem&&) = delete;
+
+    JobSystem& operator=(const JobSystem&) = delete;
+    JobSystem& operator=(JobSystem&&) = delete;
+
+    ~JobSystem() { this->clear(); }
+
+    bool init(const uint32_t workerCount = defaultWorkerCount())
+    {
+        VKW_ASSERT(this->initialized() == false);
+        VKW_ASSERT(workerCount > 0);
+
+        concurrency_ = workerCount;
+        stop_ = false;
+
+        // One queue per worker, the last one being shared
+        for(uint32_t i = 0; i <= workerCount; ++i)
+        {
+            queues_.emplace_back(std::make_unique<JobQueue>());
+        }
+        for(uint32_t i = 0; i < workerCount; ++i)
+        {
+            workers_.emplace_back([this, i]() { workerLoop(i); });
+        }
+
+        initialized_ = true;
+
+        return true;
+    }
+
+    // Concurrency only sizes parallelFor() chunks, the executor decides how many jobs run at once
+    bool init(Executor&& executor, const uint32_t concurrency)
+    {
+        VKW_ASSERT(this->initialized() == false);
+        VKW_ASSERT(executor);
+        VKW_ASSERT(concurrency > 0);
+
+        executor_ = std::move(executor);
+        concurrency_ = concurrency;
+        stop_ = false;
+        queues_.emplace_back(std::make_unique<JobQueue>());
+
+        initialized_ = true;
+
+        return true;
+    }
+
+    // Runs the queued jobs first, jobs still waiting on dependencies are dropped
+    void clear()
+    {
+        if(!initialized_)
+        {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stop_ = true;
+        }
+        wakeCondition_.notify_all();
+        for(auto& worker : workers_)
+        {
+            worker.join();
+        }
+        workers_.clear();
+
+        if(executor_)
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wakeCondition_.wait(lock, [this] { return externalTaskCount_.load() == 0; });
+        }
+        executor_ = nullptr;
+
+        queues_.clear();
+        queuedJobCount_ = 0;
+        concurrency_ = 0;
+        initialized_ = false;
+    }
+
+    bool initialized() const { return initialized_; }
+
+    // Number of jobs expected to run at once
+    uint32_t concurrency() const { return concurrency_; }
+
+    JobHandle submit(Job&& job) { return submit(std::move(job), nullptr, 0); }
+
+    // The job starts once every dependency is done
+    JobHandle submit(Job&& job, const std::vector<JobHandle>& dependencies)
+    {
+        return submit(std::move(job), dependencies.data(), dependencies.size());
+    }
+
+    // Runs other jobs while waiting
+    void wait(const JobHandle& handle)
+    {
+        VKW_ASSERT(this->initialized());
+        if(!handle.valid())
+        {
+            return;
+        }
+
+        const auto& state = handle.state_;
+        while(!state->done.load())
+        {
+            auto job = pop(currentQueueIndex());
+            if(job != nullptr)
+            {
+                execute(job);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            waiterCount_++;
+            wakeCondition_.wait(
+                lock, [&] { return state->done.load() || queuedJobCount_.load() > 0; });
+            waiterCount_--;
+        }
+    }
+
+    void wait(const std::vector<JobHandle>& handles)
+    {
+        for(const auto& handle : handles)
+        {
+            wait(handle);
+        }
+    }
+
+    // Calls fn(rangeBegin, rangeEnd) over chunks of [begin, end) and returns once all of them are
+    // done. The calling thread takes part. The default grain size splits the range in about
+    // four chunks per thread, the caller included.
+    template <typename Fn>
+    void parallelFor(const size_t begin, const size_t end, Fn&& fn, const size_t grainSize = 0)
+    {
+        VKW_ASSERT(this->initialized());
+        if(end <= begin)
+        {
+            return;
+        }
+
+        const size_t count = end - begin;
+        const size_t threadCount = size_t(concurrency_) + 1;
+        const size_t chunkSize
+            = (grainSize > 0) ? grainSize : std::max(size_t(1), count / (4 * threadCount));
+        const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+        std::vector<JobHandle> handles{};
+        handles.reserve(chunkCount - 1);
+        for(size_t chunk = 1; chunk < chunkCount; ++chunk)
+        {
+            const size_t chunkBegin = begin + chunk * chunkSize;
+            const size_t chunkEnd = std::min(end, chunkBegin + chunkSize);
+            handles.emplace_back(
+                submit([&fn, chunkBegin, chunkEnd]() { fn(chunkBegin, chunkEnd); }));
+        }
+        fn(begin, std::min(end, begin + chunkSize));
+        wait(handles);
+    }
+
+    static uint32_t defaultWorkerCount()
+    {
+        const uint32_t threadCount = std::thread::hardware_concurrency();
+        return (threadCount > 1) ? threadCount - 1 : 1;
+    }
+
+  private:
+    struct JobQueue
+    {
+        std::mutex mutex{};
+        std::deque<std::shared_ptr<JobState>> jobs{};
+    };
+
+    struct WorkerContext
+    {
+        const JobSystem* owner{nullptr};
+        uint32_t index{0};
+    };
+
+    Executor executor_{};
+    std::vector<std::thread> workers_{};
+    std::vector<std::unique_ptr<JobQueue>> queues_{};
+
+    std::mutex sleepMutex_{};
+    std::condition_variable wakeCondition_{};
+    std::atomic<size_t> queuedJobCount_{0};
+    std::atomic<size_t> externalTaskCount_{0};
+    std::atomic<uint32_t> waiterCount_{0};
+    bool stop_{false}; ///< Protected by sleepMutex_
+
+    uint32_t concurrency_{0};
+
+    bool initialized_{false};
+
+    static WorkerContext& workerContext()
+    {
+        static thread_local WorkerContext context{};
+        return context;
+    }
+
+    uint32_t sharedQueueIndex() const { return static_cast<uint32_t>(queues_.size() - 1); }
+
+    uint32_t currentQueueIndex() const
+    {
+        const auto& context = workerContext();
+        return (context.owner == this) ? context.index : sharedQueueIndex();
+    }
+
+    JobHandle submit(Job&& job, const JobHandle* dependencies, const size_t dependencyCount)
+    {
+        VKW_ASSERT(this->initialized());
+
+        auto state = std::make_shared<JobState>();
+        state->job = std::move(job);
+        for(size_t i = 0; i < dependencyCount; ++i)
+        {
+            const auto& dependency = dependencies[i].state_;
+            if(dependency == nullptr)
+            {
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(dependency->mutex);
+            if(!dependency->done.load())
+            {
+                state->pendingDependencies++;
+                dependency->successors.push_back(state);
+            }
+        }
+
+        if(--state->pendingDependencies == 0)
+        {
+            schedule(state);
+        }
+        return JobHandle{std::move(state)};
+    }
+
+    void schedule(const std::shared_ptr<JobState>& state)
+    {
+        // Counted first so that the count never drops below the number of queued jobs
+        queuedJobCount_++;
+        {
+            auto& queue = *queues_[currentQueueIndex()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back(state);
+        }
+
+        if(executor_)
+        {
+            externalTaskCount_++;
+            executor_([this]() {
+                auto job = pop(sharedQueueIndex());
+                if(job != nullptr)
+                {
+                    execute(job);
+                }
+                if(--externalTaskCount_ == 0)
+                {
+                    std::lock_guard<std::mutex> lock(sleepMutex_);
+                    wakeCondition_.notify_all();
+                }
+            });
+        }
+
+        // Locking avoids missing a thread about to sleep
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+        }
+        if(waiterCount_.load() > 0)
+        {
+            wakeCondition_.notify_all();
+        }
+        else
+        {
+            wakeCondition_.notify_one();
+        }
+    }
+
+    // Own jobs are taken from the back, the shared queue and the other workers from the front
+    std::shared_ptr<JobState> pop(const uint32_t queueIndex)
+    {
+        const uint32_t queueCount = static_cast<uint32_t>(queues_.size());
+        for(uint32_t i = 0; i < queueCount; ++i)
+        {
+            auto& queue = *queues_[(queueIndex + i) % queueCount];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if(queue.jobs.empty())
+            {
+                continue;
+            }
+
+            std::shared_ptr<JobState> ret{};
+            if(i == 0 && queueIndex != sharedQueueIndex())
+            {
+                ret = std::move(queue.jobs.back());
+                queue.jobs.pop_back();
+            }
+            else
+            {
+                ret = std::move(queue.jobs.front());
+                queue.jobs.pop_front();
+            }
+            queuedJobCount_--;
+            return ret;
+        }
+        return nullptr;
+    }
+
+    void execute(const std::shared_ptr<JobState>& state)
+    {
+        state->job();
+        state->job = nullptr;
+
+        std::vector<std::shared_ptr<JobState>> successors{};
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->done = true;
+            std::swap(successors, state->successors);
+        }
+        for(const auto& successor : successors)
+        {
+            if(--successor->pendingDependencies == 0)
+            {
+                schedule(successor);
+            }
+        }
+
+        if(waiterCount_.load() > 0)
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            wakeCondition_.notify_all();
+        }
+    }
+
+    void workerLoop(const uint32_t index)
+    {
+        auto& context = workerContext();
+        context.owner = this;
+        context.index = index;
+
+        while(true)
+        {
+            auto job = pop(index);
+            if(job != nullptr)
+            {
+                execute(job);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wakeCondition_.wait(lock, [this] { return stop_ || queuedJobCount_.load() > 0; });
+            if(stop_ && queuedJobCount_.load() == 0)
+            {
+                break;
+            }
+        }
+
+        context.owner = nullptr;
+    }
+};
+} // namespace vkw
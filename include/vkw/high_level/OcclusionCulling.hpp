@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "vkw/vkw.hpp"
+
+#include <vector>
+
+namespace vkw
+{
+struct ProxyBox
+{
+    float min[3];
+    float max[3];
+};
+
+// Draws a list of proxy boxes with one occlusion query each and copies the results into a
+// predicate buffer usable with conditional rendering, so that the objects behind the boxes can be
+// skipped on the next frame without any readback. Expected usage for a frame:
+//   - reset() outside of a render pass
+//   - beginConditional() / endConditional() around the draws of each object
+//   - drawProxies() after the occluders have been drawn, with a pipeline consuming vec3 positions
+//     on binding 0, depth test enabled, depth and color writes disabled and culling disabled
+//   - resolve() once the render pass has ended
+class OcclusionCulling
+{
+  public:
+    OcclusionCulling() {}
+    OcclusionCulling(Device& device, const std::vector<ProxyBox>& boxes, const bool precise = false)
+    {
+        VKW_CHECK_BOOL_FAIL(this->init(device, boxes, precise), "Initializing occlusion culling");
+    }
+
+    OcclusionCulling(const OcclusionCulling&) = delete;
+    OcclusionCulling(OcclusionCulling&& cp) { *this = std::move(cp); }
+
+    OcclusionCulling& operator=(const OcclusionCulling&) = delete;
+    OcclusionCulling& operator=(OcclusionCulling&& cp)
+    {
+        this->clear();
+        std::swap(device_, cp.device_);
+        std::swap(queryPool_, cp.queryPool_);
+        std::swap(vertices_, cp.vertices_);
+        std::swap(indices_, cp.indices_);
+        std::swap(predicates_, cp.predicates_);
+        std::swap(proxyCount_, cp.proxyCount_);
+        std::swap(precise_, cp.precise_);
+        std::swap(predicatesInitialized_, cp.predicatesInitialized_);
+        std::swap(initialized_, cp.initialized_);
+        return *this;
+    }
+
+    ~OcclusionCulling() { this->clear(); }
+
+    bool init(Device& device, const std::vector<ProxyBox>& boxes, const bool precise = false)
+    {
+        VKW_ASSERT(this->initialized() == false);
+        VKW_ASSERT(!boxes.empty());
+
+        device_ = &device;
+        proxyCount_ = static_cast<uint32_t>(boxes.size());
+        precise_ = precise;
+
+        VKW_INIT_CHECK_BOOL(queryPool_.init(*device_, VK_QUERY_TYPE_OCCLUSION, proxyCount_));
+        VKW_INIT_CHECK_BOOL(vertices_.init(*device_, 0, 3 * cornerCount * proxyCount_));
+        VKW_INIT_CHECK_BOOL(indices_.init(*device_, 0, indexCount));
+        VKW_INIT_CHECK_BOOL(predicates_.init(*device_, 0, proxyCount_));
+
+        std::vector<float> vertices;
+        vertices.reserve(3 * cornerCount * proxyCount_);
+        for(const auto& box : boxes)
+        {
+            for(uint32_t i = 0; i < cornerCount; ++i)
+            {
+                vertices.push_back((i & 1) ? box.max[0] : box.min[0]);
+                vertices.push_back((i & 2) ? box.max[1] : box.min[1]);
+                vertices.push_back((i & 4) ? box.max[2] : box.min[2]);
+            }
+        }
+        VKW_INIT_CHECK_BOOL(vertices_.copyFromHost(vertices.data(), vertices.size()));
+
+        static constexpr uint16_t boxIndices[indexCount]
+            = {0, 4, 6, 0, 6, 2, 1, 3, 7, 1, 7, 5, 0, 1, 5, 0, 5, 4,
+               2, 6, 7, 2, 7, 3, 0, 2, 3, 0, 3, 1, 4, 5, 7, 4, 7, 6};
+        VKW_INIT_CHECK_BOOL(indices_.copyFromHost(boxIndices, indexCount));
+
+        predicatesInitialized_ = false;
+        initialized_ = true;
+
+        return true;
+    }
+
+    void clear()
+    {
+        queryPool_.clear();
+        vertices_.clear();
+        indices_.clear();
+        predicates_.clear();
+
+        proxyCount_ = 0;
+        precise_ = false;
+        predicatesInitialized_ = false;
+
+        device_ = nullptr;
+        initialized_ = false;
+    }
+
+    bool initialized() const { return initialized_; }
+
+    uint32_t proxyCount() const { return proxyCount_; }
+
+    // Must be recorded outside of a render pass. On first use every object is marked as visible.
+    void reset(CommandBuffer& cmdBuffer)
+    {
+        VKW_ASSERT(this->initialized());
+
+        cmdBuffer.resetQueryPool(queryPool_);
+        if(!predicatesInitialized_)
+        {
+            cmdBuffer.fillBuffer(predicates_, uint32_t(1), 0, predicates_.sizeBytes());
+            cmdBuffer.bufferMemoryBarrier(
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_CONDITIONAL_RENDERING_BIT_EXT,
+                createBufferMemoryBarrier(
+                    predicates_,
+                    VK_ACCESS_TRANSFER_WRITE_BIT,
+                    VK_ACCESS_CONDITIONAL_RENDERING_READ_BIT_EXT));
+            predicatesInitialized_ = true;
+        }
+    }
+
+    void beginConditional(CommandBuffer& cmdBuffer, const uint32_t proxyId)
+    {
+        VKW_ASSERT(proxyId < proxyCount_);
+        cmdBuffer.beginConditionalRendering(predicates_, proxyId * sizeof(uint32_t));
+    }
+
+    void endConditional(CommandBuffer& cmdBuffer) { cmdBuffer.endConditionalRendering(); }
+
+    void drawProxies(CommandBuffer& cmdBuffer)
+    {
+        VKW_ASSERT(this->initialized());
+
+        cmdBuffer.bindVertexBuffer(0, vertices_, 0);
+        cmdBuffer.bindIndexBuffer(indices_, VK_INDEX_TYPE_UINT16);
+        for(uint32_t i = 0; i < proxyCount_; ++i)
+        {
+            cmdBuffer.beginOcclusionQuery(queryPool_, i, precise_);
+            cmdBuffer.drawIndexed(indexCount, 1, 0, i * cornerCount, 0);
+            cmdBuffer.endOcclusionQuery(queryPool_, i);
+        }
+    }
+
+    // Must be recorded outside of a render pass, after drawProxies()
+    void resolve(CommandBuffer& cmdBuffer)
+    {
+        VKW_ASSERT(this->initialized());
+
+        cmdBuffer.bufferMemoryBarrier(
+            VK_PIPELINE_STAGE_CONDITIONAL_RENDERING_BIT_EXT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            createBufferMemoryBarrier(
+                predicates_,
+                VK_ACCESS_CONDITIONAL_RENDERING_READ_BIT_EXT,
+                VK_ACCESS_TRANSFER_WRITE_BIT));
+        cmdBuffer.copyQueryPoolResults(
+            queryPool_, 0, proxyCount_, predicates_, 0, sizeof(uint32_t), VK_QUERY_RESULT_WAIT_BIT);
+        cmdBuffer.bufferMemoryBarrier(
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_CONDITIONAL_RENDERING_BIT_EXT,
+            createBufferMemoryBarrier(
+                predicates_,
+                VK_ACCESS_TRANSFER_WRITE_BIT,
+                VK_ACCESS_CONDITIONAL_RENDERING_READ_BIT_EXT));
+    }
+
+    const auto& predicateBuffer() const { return predicates_; }
+    const auto& queryPool() const { return queryPool_; }
+
+  private:
+    static constexpr uint32_t cornerCount = 8;
+    static constexpr uint32_t indexCount = 36;
+
+    Device* device_{nullptr};
+
+    QueryPool queryPool_{};
+    Buffer<float, MemoryType::TransferHostDevice, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT> vertices_{};
+    Buffer<uint16_t, MemoryType::TransferHostDevice, VK_BUFFER_USAGE_INDEX_BUFFER_BIT> indices_{};
+    Buffer<
+        uint32_t,
+        MemoryType::Device,
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_CONDITIONAL_RENDERING_BIT_EXT>
+        predicates_{};
+
+    uint32_t proxyCount_{0};
+    bool precise_{false};
+    bool predicatesInitialized_{false};
+
+    bool initialized_{false};
+};
+} // namespace vkw
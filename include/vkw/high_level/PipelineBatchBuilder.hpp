@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "vkw/high_level/JobSystem.hpp"
+#include "vkw/vkw.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vkw
+{
+struct PipelineCompileTiming
+{
+    std::string name{};
+    double compileTimeMs{0.0};
+    bool success{false};
+};
+
+// Compiles many pipelines at once on the threads of a JobSystem, or serially for small batches.
+// Pipelines are initialized and configured (shaders, specialization constants, states...) as
+// usual, then added to the builder with the arguments of their createPipeline call. Every
+// pipeline, layout and render pass added must stay alive and must not be touched until build()
+// returns.
+// All pipelines go through the pipeline cache of their device, compilations that hit the cache
+// are cheap and loading a cache saved by a previous run makes most of a batch free.
+class PipelineBatchBuilder
+{
+  public:
+    // Receives the name given to add(), nullptr if none
+    using Compile = std::function<bool(const char*)>;
+
+    PipelineBatchBuilder() {}
+
+    PipelineBatchBuilder& add(
+        ComputePipeline& pipeline,
+        PipelineLayout& pipelineLayout,
+        const VkPipelineCreateFlags flags = 0,
+        const char* name = nullptr)
+    {
+        ComputePipeline* pPipeline = &pipeline;
+        PipelineLayout* pLayout = &pipelineLayout;
+        return add(name, [pPipeline, pLayout, flags](const char* pipelineName) {
+            return finalize(*pPipeline, pPipeline->createPipeline(*pLayout, flags), pipelineName);
+        });
+    }
+
+    PipelineBatchBuilder& add(
+        GraphicsPipeline& pipeline,
+        RenderPass& renderPass,
+        PipelineLayout& pipelineLayout,
+        const VkPipelineCreateFlagBits flags = {},
+        const uint32_t subPass = 0,
+        const char* name = nullptr)
+    {
+        GraphicsPipeline* pPipeline = &pipeline;
+        RenderPass* pRenderPass = &renderPass;
+        PipelineLayout* pLayout = &pipelineLayout;
+        return add(name, [=](const char* pipelineName) {
+            return finalize(
+                *pPipeline,
+                pPipeline->createPipeline(*pRenderPass, *pLayout, flags, subPass),
+                pipelineName);
+        });
+    }
+
+    // Dynamic rendering
+    PipelineBatchBuilder& add(
+        GraphicsPipeline& pipeline,
+        PipelineLayout& pipelineLayout,
+        const std::vector<VkFormat>& colorFormats,
+        const VkFormat depthFormat = VK_FORMAT_UNDEFINED,
+        const VkFormat stencilFormat = VK_FORMAT_UNDEFINED,
+        const VkPipelineCreateFlagBits flags = {},
+        const uint32_t viewMask = 0,
+        const char* name = nullptr)
+    {
+        GraphicsPipeline* pPipeline = &pipeline;
+        PipelineLayout* pLayout = &pipelineLayout;
+        return add(name, [=](const char* pipelineName) {
+            return finalize(
+                *pPipeline,
+                pPipeline->createPipeline(
+                    *pLayout, colorFormats, depthFormat, stencilFormat, flags, viewMask),
+                pipelineName);
+        });
+    }
+
+    // Any other compilation, compile must be safe to call from a worker thread
+    PipelineBatchBuilder& add(const char* name, Compile&& compile)
+    {
+        entries_.emplace_back(Entry{std::move(compile), (name != nullptr) ? name : ""});
+        return *this;
+    }
+
+    size_t size() const { return entries_.size(); }
+
+    // Compiles every pipeline added since the last build and waits for all of them, the calling
+    // thread takes part. Returns false if any compilation failed, timings tell which ones.
+    bool build(JobSystem& jobSystem)
+    {
+        return runBuild([this, &jobSystem] {
+            // One pipeline per job, compilation times vary too much to group them
+            jobSystem.parallelFor(
+                0,
+                entries_.size(),
+                [this](const size_t rangeBegin, const size_t rangeEnd) {
+                    compileRange(rangeBegin, rangeEnd);
+                },
+                1);
+        });
+    }
+
+    // Same as above on the calling thread only, for batches too small to need a job system
+    bool build()
+    {
+        return runBuild([this] { compileRange(0, entries_.size()); });
+    }
+
+    // Timings of the last build, in the order pipelines were added
+    const std::vector<PipelineCompileTiming>& timings() const { return timings_; }
+
+    // Wall clock time of the last build, compare with the sum of the timings for the speedup
+    double totalTimeMs() const { return totalTimeMs_; }
+
+    void clear()
+    {
+        entries_.clear();
+        timings_.clear();
+        totalTimeMs_ = 0.0;
+    }
+
+  private:
+    struct Entry
+    {
+        Compile compile{};
+        std::string name{};
+    };
+
+    std::vector<Entry> entries_{};
+    std::vector<PipelineCompileTiming> timings_{};
+    double totalTimeMs_{0.0};
+
+    void compileRange(const size_t rangeBegin, const size_t rangeEnd)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        for(size_t i = rangeBegin; i < rangeEnd; ++i)
+        {
+            const auto compileStart = Clock::now();
+            const auto& entry = entries_[i];
+            const bool success = entry.compile(entry.name.empty() ? nullptr : entry.name.c_str());
+            const auto compileEnd = Clock::now();
+
+            auto& timing = timings_[i];
+            timing.name = entry.name;
+            timing.compileTimeMs
+                = std::chrono::duration<double, std::milli>(compileEnd - compileStart).count();
+            timing.success = success;
+        }
+    }
+
+    template <typename CompileAll>
+    bool runBuild(CompileAll&& compileAll)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        timings_.clear();
+        timings_.resize(entries_.size());
+
+        const auto startTime = Clock::now();
+        compileAll();
+        totalTimeMs_
+            = std::chrono::duration<double, std::milli>(Clock::now() - startTime).count();
+        entries_.clear();
+
+        bool ret = true;
+        for(const auto& timing : timings_)
+        {
+            if(!timing.success)
+            {
+                utils::Log::Error("vkw", "Error compiling pipeline %s", timing.name.c_str());
+                ret = false;
+            }
+        }
+        return ret;
+    }
+
+    template <typename PipelineType>
+    static bool finalize(const PipelineType& pipeline, const bool success, const char* name)
+    {
+        if(success && name != nullptr)
+        {
+            pipeline.setName(name);
+        }
+        return success;
+    }
+};
+} // namespace vkw
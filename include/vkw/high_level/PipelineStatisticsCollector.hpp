@@ -0,0 +1,353 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "vkw/vkw.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace vkw
+{
+// Attributes pipeline statistics to named draws and dispatches. Like GpuProfiler, one query pool
+// is kept per frame in flight and results are read back without waiting on the GPU. When the
+// pipelineStatisticsQuery feature has not been enabled on the device, scopes are no-ops and no
+// results are reported.
+class PipelineStatisticsCollector
+{
+  public:
+    struct Entry
+    {
+        std::string name{};
+        PipelineStatistics statistics{};
+    };
+
+    class Scope
+    {
+      public:
+        Scope() {}
+
+        Scope(const Scope&) = delete;
+        Scope(Scope&& cp) { *this = std::move(cp); }
+
+        Scope& operator=(const Scope&) = delete;
+        Scope& operator=(Scope&& cp)
+        {
+            this->end();
+            std::swap(collector_, cp.collector_);
+            std::swap(cmdBuffer_, cp.cmdBuffer_);
+            std::swap(frameId_, cp.frameId_);
+            std::swap(queryId_, cp.queryId_);
+            return *this;
+        }
+
+        ~Scope() { this->end(); }
+
+        void end()
+        {
+            if(collector_ != nullptr)
+            {
+                collector_->endScope(*cmdBuffer_, frameId_, queryId_);
+            }
+            collector_ = nullptr;
+            cmdBuffer_ = nullptr;
+        }
+
+      private:
+        friend class PipelineStatisticsCollector;
+
+        Scope(
+            PipelineStatisticsCollector* collector,
+            CommandBuffer* cmdBuffer,
+            const uint32_t frameId,
+            const uint32_t queryId)
+            : collector_{collector}, cmdBuffer_{cmdBuffer}, frameId_{frameId}, queryId_{queryId}
+        {}
+
+        PipelineStatisticsCollector* collector_{nullptr};
+        CommandBuffer* cmdBuffer_{nullptr};
+        uint32_t frameId_{0};
+        uint32_t queryId_{0};
+    };
+
+    static constexpr uint32_t defaultMaxQueryCount = 256;
+    static constexpr VkQueryPipelineStatisticFlags defaultStatistics
+        = VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT
+          | VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT
+          | VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT
+          | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT
+          | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT
+          | VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT
+          | VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+
+    PipelineStatisticsCollector() {}
+    PipelineStatisticsCollector(
+        Device& device,
+        const uint32_t framesInFlight,
+        const VkQueryPipelineStatisticFlags statistics = defaultStatistics,
+        const uint32_t maxQueryCount = defaultMaxQueryCount)
+    {
+        VKW_CHECK_BOOL_FAIL(
+            this->init(device, framesInFlight, statistics, maxQueryCount),
+            "Initializing pipeline statistics collector");
+    }
+
+    PipelineStatisticsCollector(const PipelineStatisticsCollector&) = delete;
+    PipelineStatisticsCollector(PipelineStatisticsCollector&& cp) { *this = std::move(cp); }
+
+    PipelineStatisticsCollector& operator=(const PipelineStatisticsCollector&) = delete;
+    PipelineStatisticsCollector& operator=(PipelineStatisticsCollector&& cp)
+    {
+        this->clear();
+        std::swap(device_, cp.device_);
+        std::swap(frames_, cp.frames_);
+        std::swap(results_, cp.results_);
+        std::swap(totals_, cp.totals_);
+        std::swap(statistics_, cp.statistics_);
+        std::swap(maxQueryCount_, cp.maxQueryCount_);
+        std::swap(frameId_, cp.frameId_);
+        std::swap(enabled_, cp.enabled_);
+        std::swap(initialized_, cp.initialized_);
+        return *this;
+    }
+
+    ~PipelineStatisticsCollector() { this->clear(); }
+
+    bool init(
+        Device& device,
+        const uint32_t framesInFlight,
+        const VkQueryPipelineStatisticFlags statistics = defaultStatistics,
+        const uint32_t maxQueryCount = defaultMaxQueryCount)
+    {
+        VKW_ASSERT(this->initialized() == false);
+        VKW_ASSERT(framesInFlight > 0);
+
+        device_ = &device;
+        statistics_ = statistics;
+        maxQueryCount_ = maxQueryCount;
+
+        enabled_ = (device_->getEnabledFeatures().pipelineStatisticsQuery == VK_TRUE);
+        if(!enabled_)
+        {
+            utils::Log::Warning(
+                "vkw", "pipelineStatisticsQuery not enabled, pipeline statistics disabled");
+            initialized_ = true;
+            return true;
+        }
+
+        frames_.resize(framesInFlight);
+        for(auto& frame : frames_)
+        {
+            VKW_INIT_CHECK_BOOL(frame.queryPool.init(
+                *device_, VK_QUERY_TYPE_PIPELINE_STATISTICS, maxQueryCount_, statistics_));
+            frame.names.reserve(maxQueryCount_);
+        }
+
+        initialized_ = true;
+
+        return true;
+    }
+
+    void clear()
+    {
+        frames_.clear();
+        results_.clear();
+        totals_ = {};
+
+        statistics_ = 0;
+        maxQueryCount_ = 0;
+        frameId_ = 0;
+        enabled_ = false;
+
+        device_ = nullptr;
+        initialized_ = false;
+    }
+
+    bool initialized() const { return initialized_; }
+    bool enabled() const { return enabled_; }
+
+    // Must be recorded in the first command buffer submitted for the frame
+    void beginFrame(CommandBuffer& cmdBuffer)
+    {
+        VKW_ASSERT(this->initialized());
+        if(!enabled_)
+        {
+            return;
+        }
+
+        frameId_ = (frameId_ + 1) % static_cast<uint32_t>(frames_.size());
+
+        auto& frame = frames_[frameId_];
+        if(frame.pending && !resolveFrame(frame))
+        {
+            utils::Log::Debug("vkw", "Pipeline statistics: dropping unresolved frame results");
+        }
+
+        frame.names.clear();
+        frame.active = false;
+        frame.pending = false;
+        frame.recording = true;
+        cmdBuffer.resetQueryPool(frame.queryPool);
+    }
+
+    void endFrame()
+    {
+        if(!enabled_)
+        {
+            return;
+        }
+
+        auto& frame = frames_[frameId_];
+        VKW_ASSERT(frame.active == false);
+        frame.recording = false;
+        frame.pending = !frame.names.empty();
+    }
+
+    // Pipeline statistics queries of the same pool can not be nested, only one scope can be
+    // active at a time.
+    [[nodiscard]] Scope scope(CommandBuffer& cmdBuffer, const std::string& name)
+    {
+        if(!enabled_)
+        {
+            return Scope{};
+        }
+
+        auto& frame = frames_[frameId_];
+        VKW_ASSERT(frame.recording);
+        VKW_ASSERT(frame.active == false);
+        if(frame.names.size() >= maxQueryCount_)
+        {
+            utils::Log::Warning(
+                "vkw", "Pipeline statistics: query limit reached, skipping %s", name.c_str());
+            return Scope{};
+        }
+
+        const uint32_t queryId = static_cast<uint32_t>(frame.names.size());
+        frame.names.push_back(name);
+        frame.active = true;
+        cmdBuffer.beginQuery(frame.queryPool, queryId);
+
+        return Scope{this, &cmdBuffer, frameId_, queryId};
+    }
+
+    // Non blocking, returns true if the results have been updated
+    bool resolve()
+    {
+        bool updated = false;
+        for(size_t i = 1; i <= frames_.size(); ++i)
+        {
+            auto& frame = frames_[(frameId_ + i) % frames_.size()];
+            if(frame.pending)
+            {
+                updated |= resolveFrame(frame);
+            }
+        }
+        return updated;
+    }
+
+    // Statistics of the last resolved frame, scopes with the same name are accumulated
+    const std::vector<Entry>& getResults() const { return results_; }
+    const PipelineStatistics& getFrameTotals() const { return totals_; }
+
+  private:
+    struct FrameData
+    {
+        QueryPool queryPool{};
+        std::vector<std::string> names{};
+        std::vector<uint64_t> queryResults{};
+        bool active{false};
+        bool recording{false};
+        bool pending{false};
+    };
+
+    Device* device_{nullptr};
+
+    std::vector<FrameData> frames_{};
+    std::vector<Entry> results_{};
+    PipelineStatistics totals_{};
+
+    VkQueryPipelineStatisticFlags statistics_{0};
+    uint32_t maxQueryCount_{0};
+    uint32_t frameId_{0};
+
+    bool enabled_{false};
+    bool initialized_{false};
+
+    void endScope(CommandBuffer& cmdBuffer, const uint32_t frameId, const uint32_t queryId)
+    {
+        auto& frame = frames_[frameId];
+        VKW_ASSERT(frame.active);
+
+        cmdBuffer.endQuery(frame.queryPool, queryId);
+        frame.active = false;
+    }
+
+    bool resolveFrame(FrameData& frame)
+    {
+        const uint32_t queryCount = static_cast<uint32_t>(frame.names.size());
+        const uint32_t valueCount = frame.queryPool.valuesPerQuery() + 1;
+
+        const auto res = frame.queryPool.getResults(
+            0, queryCount, frame.queryResults, VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+        if(res != VK_SUCCESS && res != VK_NOT_READY)
+        {
+            utils::Log::Error("vkw", "Pipeline statistics: error reading query results");
+            frame.pending = false;
+            return false;
+        }
+
+        for(uint32_t i = 0; i < queryCount; ++i)
+        {
+            if(frame.queryResults[i * valueCount + valueCount - 1] == 0)
+            {
+                return false;
+            }
+        }
+
+        results_.clear();
+        totals_ = {};
+        for(uint32_t i = 0; i < queryCount; ++i)
+        {
+            const auto statistics = PipelineStatistics::fromQueryResults(
+                statistics_, frame.queryResults.data() + i * valueCount);
+            totals_ += statistics;
+
+            auto it = std::find_if(results_.begin(), results_.end(), [&](const Entry& entry) {
+                return entry.name == frame.names[i];
+            });
+            if(it == results_.end())
+            {
+                results_.push_back({frame.names[i], statistics});
+            }
+            else
+            {
+                it->statistics += statistics;
+            }
+        }
+
+        frame.pending = false;
+        return true;
+    }
+};
+} // namespace vkw
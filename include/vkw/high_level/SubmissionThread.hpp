@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "vkw/high_level/GpuFuture.hpp"
+#include "vkw/vkw.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vkw
+{
+// Work submitted through a SubmissionThread, equivalent to one submission of a SubmitBatch
+struct SubmitRequest
+{
+    struct SemaphoreOp
+    {
+        VkSemaphore semaphore;
+        VkPipelineStageFlags2 stageMask;
+        uint64_t value; ///< Only used by timeline semaphores
+    };
+
+    std::vector<VkCommandBuffer> cmdBuffers{};
+    std::vector<SemaphoreOp> waits{};
+    std::vector<SemaphoreOp> signals{};
+
+    template <typename CommandBuffer>
+    SubmitRequest& addCommandBuffer(const CommandBuffer& cmdBuffer)
+    {
+        cmdBuffers.push_back(cmdBuffer.getHandle());
+        return *this;
+    }
+
+    template <typename Semaphore>
+    SubmitRequest& addWait(
+        const Semaphore& semaphore,
+        const VkPipelineStageFlags2 stageMask,
+        const uint64_t value = 0)
+    {
+        waits.push_back({semaphore.getHandle(), stageMask, value});
+        return *this;
+    }
+
+    template <typename Semaphore>
+    SubmitRequest& addSignal(
+        const Semaphore& semaphore,
+        const VkPipelineStageFlags2 stageMask,
+        const uint64_t value = 0)
+    {
+        signals.push_back({semaphore.getHandle(), stageMask, value});
+        return *this;
+    }
+};
+
+// Owns the submissions to one queue. Any thread can hand requests over with submit(), which pushes
+// to a lock-free queue, wakes the submission thread and never waits on the driver. The submission
+// thread drains the requests, coalesces them into a single vkQueueSubmit2 call and submits them in
+// ticket order.
+// Every request signals its ticket on a timeline semaphore owned by the thread, so completion can
+// be polled or waited on the host, or waited on the GPU through semaphore().
+// The device must enable timeline semaphores.
+class SubmissionThread
+{
+  public:
+    SubmissionThread() {}
+    SubmissionThread(Device& device, const Queue& queue)
+    {
+        VKW_CHECK_BOOL_FAIL(this->init(device, queue), "Initializing submission thread");
+    }
+
+    // The worker thread refers to this object, it can not be moved
+    SubmissionThread(const SubmissionThread&) = delete;
+    SubmissionThread(SubmissionThread&&) = delete;
+
+    SubmissionThread& operator=(const SubmissionThread&) = delete;
+    SubmissionThread& operator=(SubmissionThread&&) = delete;
+
+    ~SubmissionThread() { this->clear(); }
+
+    bool init(Device& device, const Queue& queue)
+    {
+        VKW_ASSERT(this->initialized() == false);
+
+        device_ = &device;
+        queue_ = queue;
+
+        VKW_INIT_CHECK_BOOL(timeline_.init(*device_, 0));
+        nextTicket_.store(0);
+        submittedTicket_ = 0;
+        pushCount_ = 0;
+        failed_.store(false);
+        stop_.store(false);
+
+        thread_ = std::thread([this] { this->run(); });
+
+        initialized_ = true;
+
+        return true;
+    }
+
+    // Flushes the pending requests and waits for all of them to complete
+    void clear()
+    {
+        if(thread_.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(wakeMutex_);
+                stop_.store(true);
+            }
+            wakeCondition_.notify_one();
+            thread_.join();
+            timeline_.wait(submittedTicket_);
+        }
+
+        timeline_.clear();
+        pending_.clear();
+        batch_.clear();
+
+        queue_ = {};
+        nextTicket_.store(0);
+        submittedTicket_ = 0;
+        pushCount_ = 0;
+
+        device_ = nullptr;
+        initialized_ = false;
+    }
+
+    bool initialized() const { return initialized_; }
+
+    // Thread safe, returns the ticket of the request
+    uint64_t submit(SubmitRequest&& request)
+    {
+        VKW_ASSERT(this->initialized());
+
+        const uint64_t ticket = nextTicket_.fetch_add(1) + 1;
+        requests_.push({ticket, std::move(request)});
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+            pushCount_++;
+        }
+        wakeCondition_.notify_one();
+        return ticket;
+    }
+
+    bool isComplete(const uint64_t ticket) const { return timeline_.getValue() >= ticket; }
+
+    bool wait(const uint64_t ticket, const uint64_t timeout = ~uint64_t(0))
+    {
+        VKW_ASSERT(this->initialized());
+        return timeline_.wait(ticket, timeout);
+    }
+
+    // Future completed with the request, continuations run on the given pool
+    GpuFuture<> getFuture(const uint64_t ticket, CompletionPool& pool) const
+    {
+        VKW_ASSERT(this->initialized());
+        return GpuFuture<>(pool, timeline_.getHandle(), ticket);
+    }
+
+    // Signaled with the ticket of each request, lets GPU work wait on a request
+    const TimelineSemaphore& semaphore() const { return timeline_; }
+
+    // Set when a submission failed, the tickets it contained are signaled from the host
+    bool failed() const { return failed_.load(); }
+
+  private:
+    struct PendingRequest
+    {
+        uint64_t ticket{0};
+        SubmitRequest request{};
+    };
+
+    Device* device_{nullptr};
+    Queue queue_{};
+
+    TimelineSemaphore timeline_{};
+
+    utils::MpscQueue<PendingRequest> requests_{};
+    std::atomic<uint64_t> nextTicket_{0};
+
+    // Only accessed by the submission thread
+    std::vector<PendingRequest> pending_{};
+    SubmitBatch batch_{};
+    uint64_t submittedTicket_{0};
+
+    std::thread thread_{};
+    std::mutex wakeMutex_{};
+    std::condition_variable wakeCondition_{};
+    uint64_t pushCount_{0}; ///< Guarded by wakeMutex_, incremented after each push
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> failed_{false};
+
+    bool initialized_{false};
+
+    // Time given to the previous submissions to complete before signaling failed tickets
+    static constexpr uint64_t failedSubmitTimeout = 1000000000; // 1s
+
+    // True once every ticket handed out has been submitted
+    bool allSubmitted() const { return pending_.empty() && submittedTicket_ == nextTicket_.load(); }
+
+    void run()
+    {
+        while(true)
+        {
+            // Every request counted here has been pushed and is visible to the pops below
+            uint64_t drainedPushCount = 0;
+            {
+                std::lock_guard<std::mutex> lock(wakeMutex_);
+                drainedPushCount = pushCount_;
+            }
+
+            PendingRequest request{};
+            while(requests_.pop(request))
+            {
+                pending_.push_back(std::move(request));
+            }
+
+            if(!pending_.empty())
+            {
+                flushPending();
+            }
+
+            // Only stop once every ticket handed out has been submitted
+            if(stop_.load() && allSubmitted())
+            {
+                break;
+            }
+
+            // Tickets are taken before being pushed, a missing ticket is always followed by a push
+            // that increments the count and wakes the thread
+            std::unique_lock<std::mutex> lock(wakeMutex_);
+            wakeCondition_.wait(lock, [&] {
+                return pushCount_ != drainedPushCount || (stop_.load() && allSubmitted());
+            });
+        }
+    }
+
+    // Submits the requests following the last submitted ticket without gaps
+    void flushPending()
+    {
+        std::sort(pending_.begin(), pending_.end(), [](const auto& r0, const auto& r1) {
+            return r0.ticket < r1.ticket;
+        });
+
+        size_t readyCount = 0;
+        while(readyCount < pending_.size()
+              && pending_[readyCount].ticket == submittedTicket_ + readyCount + 1)
+        {
+            readyCount++;
+        }
+        if(readyCount == 0)
+        {
+            return;
+        }
+
+        for(size_t i = 0; i < readyCount; ++i)
+        {
+            const auto& pending = pending_[i];
+            const auto& request = pending.request;
+
+            batch_.nextSubmit();
+            for(const auto cmdBuffer : request.cmdBuffers)
+            {
+                batch_.addCommandBuffer(cmdBuffer);
+            }
+            for(const auto& wait : request.waits)
+            {
+                batch_.addWait(wait.semaphore, wait.stageMask, wait.value);
+            }
+            for(const auto& signal : request.signals)
+            {
+                batch_.addSignal(signal.semaphore, signal.stageMask, signal.value);
+            }
+            batch_.addSignal(timeline_, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, pending.ticket);
+        }
+
+        const uint64_t lastTicket = submittedTicket_ + readyCount;
+        if(queue_.submit(batch_) != VK_SUCCESS)
+        {
+            // Nothing is pending on the GPU for these tickets, signal them so waiters are released.
+            // The host signal must come after the previous tickets, which may never complete if
+            // the device is lost: host waits then fail instead of being released.
+            utils::Log::Error(
+                "vkw",
+                "Error submitting requests %llu to %llu",
+                static_cast<unsigned long long>(submittedTicket_ + 1),
+                static_cast<unsigned long long>(lastTicket));
+            failed_.store(true);
+            if(timeline_.wait(submittedTicket_, failedSubmitTimeout))
+            {
+                timeline_.signal(lastTicket);
+            }
+            else
+            {
+                utils::Log::Error(
+                    "vkw",
+                    "Previous requests not completed, requests %llu to %llu not signaled",
+                    static_cast<unsigned long long>(submittedTicket_ + 1),
+                    static_cast<unsigned long long>(lastTicket));
+            }
+        }
+        submittedTicket_ = lastTicket;
+
+        pending_.erase(pending_.begin(), pending_.begin() + static_cast<ptrdiff_t>(readyCount));
+    }
+};
+} // namespace vkw
@@ -54,6 +54,28 @@ using AccelerationStructureSratchBuffer = Buffer<
     MemoryType::HostDevice,
     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT>;
 
+// Indirect command buffers, written either by the host or by a compute pass
+using DispatchIndirectBuffer = Buffer<
+    VkDispatchIndirectCommand,
+    MemoryType::Device,
+    VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT>;
+
+using DrawIndirectBuffer = Buffer<
+    VkDrawIndirectCommand,
+    MemoryType::Device,
+    VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT>;
+
+using DrawIndexedIndirectBuffer = Buffer<
+    VkDrawIndexedIndirectCommand,
+    MemoryType::Device,
+    VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT>;
+
+using IndirectCountBuffer = Buffer<
+    uint32_t,
+    MemoryType::Device,
+    VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+        | VK_BUFFER_USAGE_TRANSFER_DST_BIT>;
+
 // Various image types
 using RenderImage = Image<MemoryType::Device, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT>;
 using DepthImage = Image<MemoryType::Device, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT>;
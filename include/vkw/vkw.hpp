@@ -28,8 +28,11 @@
 #include "vkw/detail/BufferView.hpp"
 #include "vkw/detail/CommandBuffer.hpp"
 #include "vkw/detail/CommandPool.hpp"
+#include "vkw/detail/CommandStream.hpp"
 #include "vkw/detail/ComputePipeline.hpp"
 #include "vkw/detail/DebugMessenger.hpp"
+#include "vkw/detail/DebugUtils.hpp"
+#include "vkw/detail/DescriptorBuffer.hpp"
 #include "vkw/detail/DescriptorPool.hpp"
 #include "vkw/detail/DescriptorSet.hpp"
 #include "vkw/detail/DescriptorSetLayout.hpp"
@@ -39,11 +42,14 @@
 #include "vkw/detail/Image.hpp"
 #include "vkw/detail/ImageView.hpp"
 #include "vkw/detail/Instance.hpp"
+#include "vkw/detail/PipelineCache.hpp"
 #include "vkw/detail/PipelineLayout.hpp"
+#include "vkw/detail/QueryPool.hpp"
 #include "vkw/detail/Queue.hpp"
 #include "vkw/detail/RenderPass.hpp"
 #include "vkw/detail/RenderingAttachment.hpp"
 #include "vkw/detail/Sampler.hpp"
+#include "vkw/detail/ShaderObject.hpp"
 #include "vkw/detail/Surface.hpp"
 #include "vkw/detail/Swapchain.hpp"
 #include "vkw/detail/Synchronization.hpp"
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BindBenchmark.hpp"
+
+#include "Common.hpp"
+
+BindBenchmark::BindBenchmark()
+{
+    // Dynamic rendering
+    dynamicRenderingFeatures_.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES;
+    dynamicRenderingFeatures_.pNext = nullptr;
+    dynamicRenderingFeatures_.dynamicRendering = VK_TRUE;
+
+    // Shader objects
+    shaderObjectFeatures_.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT;
+    shaderObjectFeatures_.pNext = &dynamicRenderingFeatures_;
+    shaderObjectFeatures_.shaderObject = VK_TRUE;
+
+    deviceFeatures_.pNext = &shaderObjectFeatures_;
+
+    deviceExtensions_.push_back(VK_EXT_SHADER_OBJECT_EXTENSION_NAME);
+}
+
+VkPhysicalDevice BindBenchmark::findSupportedDevice() const
+{
+    return findCompatibleDevice(
+        instance_, deviceExtensions_, dynamicRenderingFeatures_, shaderObjectFeatures_);
+}
+
+bool BindBenchmark::init()
+{
+    static constexpr uint32_t vertexCount = 3;
+    static const glm::vec3 positions[vertexCount]
+        = {{0.0f, -0.5f, 0.0f}, {0.5f, 0.5f, 0.0f}, {-0.5f, 0.5f, 0.0f}};
+    static const glm::vec3 colors[vertexCount]
+        = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+
+    // Initialize resources
+    VKW_CHECK_BOOL_RETURN_FALSE(positions_.init(
+        device_,
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        vertexCount));
+    VKW_CHECK_BOOL_RETURN_FALSE(colors_.init(
+        device_,
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        vertexCount));
+
+    VKW_CHECK_BOOL_RETURN_FALSE(pipelineLayout_.init(device_));
+    pipelineLayout_.create();
+
+    // The variants only differ by their blend state
+    for(uint32_t i = 0; i < variantCount; ++i)
+    {
+        auto& pipeline = pipelines_[i];
+        VKW_CHECK_BOOL_RETURN_FALSE(pipeline.init(device_));
+        pipeline.addShaderStage(VK_SHADER_STAGE_VERTEX_BIT, "build/spv/triangle.vert.spv");
+        pipeline.addShaderStage(VK_SHADER_STAGE_FRAGMENT_BIT, "build/spv/triangle.frag.spv");
+        pipeline.addDynamicState(VK_DYNAMIC_STATE_VIEWPORT);
+        pipeline.addDynamicState(VK_DYNAMIC_STATE_SCISSOR);
+        pipeline.addVertexBinding(0, sizeof(glm::vec3))
+            .addVertexAttribute(0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0);
+        pipeline.addVertexBinding(1, sizeof(glm::vec3))
+            .addVertexAttribute(1, 1, VK_FORMAT_R32G32B32_SFLOAT, 0);
+        pipeline.colorBlendAttachmentStates()[0].blendEnable = (i == 0) ? VK_FALSE : VK_TRUE;
+        VKW_CHECK_BOOL_RETURN_FALSE(pipeline.createPipeline(pipelineLayout_, {colorFormat}));
+
+        auto& state = states_[i];
+        state.addVertexBinding(0, sizeof(glm::vec3))
+            .addVertexAttribute(0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0);
+        state.addVertexBinding(1, sizeof(glm::vec3))
+            .addVertexAttribute(1, 1, VK_FORMAT_R32G32B32_SFLOAT, 0);
+        state.depthTestEnable = VK_FALSE;
+        state.depthWriteEnable = VK_FALSE;
+        state.colorBlendEnables[0] = (i == 0) ? VK_FALSE : VK_TRUE;
+    }
+
+    VKW_CHECK_BOOL_RETURN_FALSE(shaderObject_.init(device_));
+    shaderObject_.addShaderStage(VK_SHADER_STAGE_VERTEX_BIT, "build/spv/triangle.vert.spv");
+    shaderObject_.addShaderStage(VK_SHADER_STAGE_FRAGMENT_BIT, "build/spv/triangle.frag.spv");
+    VKW_CHECK_BOOL_RETURN_FALSE(shaderObject_.createShaders(pipelineLayout_));
+
+    // Stream vertices
+    VKW_CHECK_BOOL_RETURN_FALSE(uploadData(device_, positions, positions_, graphicsQueue_));
+    VKW_CHECK_BOOL_RETURN_FALSE(uploadData(device_, colors, colors_, graphicsQueue_));
+
+    return true;
+}
+
+bool BindBenchmark::recordInitCommands(
+    vkw::CommandBuffer& /*cmdBuffer*/, const uint32_t /*frameId*/)
+{
+    return false;
+}
+
+void BindBenchmark::recordDrawCommands(
+    vkw::CommandBuffer& cmdBuffer, const uint32_t /*frameId*/, const uint32_t imageId)
+{
+    VkClearValue clearColor = {};
+    clearColor.color = {0.1f, 0.1f, 0.1f, 1.0f};
+
+    const VkRect2D renderArea = {{0, 0}, {frameWidth_, frameHeight_}};
+    const VkViewport viewport = {0.0f, 0.0f, float(frameWidth_), float(frameHeight_), 0.0f, 1.0f};
+    for(auto& state : states_)
+    {
+        state.viewports[0] = viewport;
+        state.scissors[0] = renderArea;
+    }
+
+    cmdBuffer.reset();
+    cmdBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+    // Pipelines
+    {
+        vkw::RenderingAttachment colorAttachment{
+            swapchain_.imageView(imageId),
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            clearColor,
+            VK_ATTACHMENT_LOAD_OP_CLEAR,
+            VK_ATTACHMENT_STORE_OP_STORE};
+        cmdBuffer.beginRendering(colorAttachment, renderArea);
+        cmdBuffer.setViewport(0.0f, 0.0f, float(frameWidth_), float(frameHeight_));
+        cmdBuffer.setScissor(renderArea.offset, renderArea.extent);
+        cmdBuffer.bindVertexBuffer(0, positions_, 0);
+        cmdBuffer.bindVertexBuffer(1, colors_, 0);
+
+        const auto start = Clock::now();
+        for(uint32_t i = 0; i < drawCount; ++i)
+        {
+            cmdBuffer.bindGraphicsPipeline(pipelines_[i % variantCount]);
+            cmdBuffer.draw(3, 1, 0, 0);
+        }
+        pipelineTimeMs_ += elapsedMs(start, Clock::now());
+
+        cmdBuffer.endRendering();
+    }
+
+    // Shader objects, the first draw records the whole state
+    {
+        vkw::RenderingAttachment colorAttachment{
+            swapchain_.imageView(imageId),
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            clearColor,
+            VK_ATTACHMENT_LOAD_OP_LOAD,
+            VK_ATTACHMENT_STORE_OP_STORE};
+        cmdBuffer.beginRendering(colorAttachment, renderArea);
+        cmdBuffer.bindVertexBuffer(0, positions_, 0);
+        cmdBuffer.bindVertexBuffer(1, colors_, 0);
+
+        const auto start = Clock::now();
+        const vkw::GraphicsState* previous = nullptr;
+        for(uint32_t i = 0; i < drawCount; ++i)
+        {
+            const auto& state = states_[i % variantCount];
+            cmdBuffer.bindShaders(shaderObject_);
+            state.apply(cmdBuffer, previous);
+            cmdBuffer.draw(3, 1, 0, 0);
+            previous = &state;
+        }
+        shaderObjectTimeMs_ += elapsedMs(start, Clock::now());
+
+        cmdBuffer.endRendering();
+    }
+
+    cmdBuffer.end();
+
+    if(++frameCount_ == reportInterval)
+    {
+        vkw::utils::Log::Info(
+            "samples",
+            "%u draws: bindGraphicsPipeline %.3f ms, bindShaders + GraphicsState %.3f ms",
+            drawCount,
+            pipelineTimeMs_ / frameCount_,
+            shaderObjectTimeMs_ / frameCount_);
+        pipelineTimeMs_ = 0.0;
+        shaderObjectTimeMs_ = 0.0;
+        frameCount_ = 0;
+    }
+}
+
+bool BindBenchmark::recordPostDrawCommands(
+    vkw::CommandBuffer& /*cmdBuffer*/, const uint32_t /*frameId*/, const uint32_t /*imageId*/)
+{
+    return false;
+}
+
+bool BindBenchmark::postDraw() { return true; }
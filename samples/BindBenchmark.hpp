@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "IGraphicsSample.hpp"
+
+#include <vkw/high_level/GraphicsState.hpp>
+
+#include <glm/glm.hpp>
+
+#include <chrono>
+
+// Compares the CPU cost of recording draws that switch state through pipelines and through
+// shader objects. Each frame records the same draws twice: once binding one of a few pipelines
+// before each draw, once binding a shader object and applying the matching GraphicsState, only
+// recording the states that differ from the previous draw. Average recording times are logged
+// periodically.
+class BindBenchmark final : public IGraphicsSample
+{
+  public:
+    BindBenchmark();
+
+    BindBenchmark(const BindBenchmark&) = delete;
+    BindBenchmark(BindBenchmark&&) = delete;
+
+    BindBenchmark& operator=(const BindBenchmark&) = delete;
+    BindBenchmark& operator=(BindBenchmark&&) = delete;
+
+    ~BindBenchmark() {}
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr uint32_t drawCount = 4096;
+    static constexpr uint32_t variantCount = 2;
+    static constexpr uint32_t reportInterval = 256;
+
+    VkPhysicalDeviceDynamicRenderingFeatures dynamicRenderingFeatures_{};
+    VkPhysicalDeviceShaderObjectFeaturesEXT shaderObjectFeatures_{};
+
+    vkw::DeviceBuffer<glm::vec3> positions_{};
+    vkw::DeviceBuffer<glm::vec3> colors_{};
+
+    vkw::PipelineLayout pipelineLayout_{};
+    vkw::GraphicsPipeline pipelines_[variantCount]{};
+
+    vkw::ShaderObject shaderObject_{};
+    vkw::GraphicsState states_[variantCount]{};
+
+    double pipelineTimeMs_{0.0};
+    double shaderObjectTimeMs_{0.0};
+    uint32_t frameCount_{0};
+
+    VkPhysicalDevice findSupportedDevice() const override;
+
+    bool init() override;
+    bool recordInitCommands(vkw::CommandBuffer& cmdBuffer, const uint32_t frameId) override;
+    void recordDrawCommands(
+        vkw::CommandBuffer& cmdBuffer, const uint32_t frameId, const uint32_t imageId) override;
+    bool recordPostDrawCommands(
+        vkw::CommandBuffer& cmdBuffer, const uint32_t frameId, const uint32_t imageId) override;
+    bool postDraw() override;
+
+    static double elapsedMs(const Clock::time_point start, const Clock::time_point end)
+    {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+};
@@ -24,45 +24,155 @@
 
 #include <vkw/vkw.hpp>
 
+// The copy runs on a dedicated transfer queue when the device has one, ownership of the buffer is
+// then handed over to the queue that is going to use it. Returns false if a submission fails.
 template <typename T>
-void uploadData(vkw::Device& device, const T* srcPtr, vkw::DeviceBuffer<T>& dst)
+bool uploadData(
+    vkw::Device& device, const T* srcPtr, vkw::DeviceBuffer<T>& dst, vkw::Queue& dstQueue)
 {
     vkw::HostStagingBuffer<T> stagingBuffer(
         device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, dst.size());
     stagingBuffer.copyFromHost(srcPtr, dst.size());
 
-    vkw::Queue transferQueue = device.getQueues(vkw::QueueUsageBits::Transfer)[0];
-    vkw::CommandPool cmdPool(device, transferQueue);
-    auto cmdBuffer = cmdPool.createCommandBuffer();
+    vkw::Queue transferQueue = device.getPreferredQueues(vkw::QueueUsageBits::Transfer)[0];
+    vkw::CommandPool transferCmdPool(device, transferQueue);
+    auto transferCmdBuffer = transferCmdPool.createCommandBuffer();
+
+    transferCmdBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    transferCmdBuffer.copyBuffer(stagingBuffer, dst);
+    transferCmdBuffer.releaseBufferOwnership(
+        dst, transferQueue, dstQueue, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+    transferCmdBuffer.end();
+
+    vkw::CommandPool dstCmdPool(device, dstQueue);
+    auto acquireCmdBuffer = dstCmdPool.createCommandBuffer();
+
+    acquireCmdBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    acquireCmdBuffer.acquireBufferOwnership(
+        dst,
+        transferQueue,
+        dstQueue,
+        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+        VK_ACCESS_MEMORY_READ_BIT);
+    acquireCmdBuffer.end();
+
+    auto semaphore = device.semaphorePool().acquire();
+    auto fence = device.fencePool().acquire();
+
+    vkw::SubmitBatch batch{};
+    batch.addCommandBuffer(transferCmdBuffer)
+        .addSignal(semaphore, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+    if(transferQueue.submit(batch) != VK_SUCCESS)
+    {
+        device.semaphorePool().release(std::move(semaphore));
+        device.fencePool().release(std::move(fence), false);
+        return false;
+    }
 
-    vkw::Fence fence(device);
-    cmdBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-    cmdBuffer.copyBuffer(stagingBuffer, dst);
-    cmdBuffer.end();
+    batch.addCommandBuffer(acquireCmdBuffer)
+        .addWait(semaphore, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+    if(dstQueue.submit(batch, fence) != VK_SUCCESS)
+    {
+        // The semaphore stays signaled without a wait, it is destroyed instead of recycled
+        transferQueue.waitIdle();
+        device.fencePool().release(std::move(fence), false);
+        return false;
+    }
+    VKW_CHECK_BOOL_RETURN_FALSE(fence.wait());
 
-    transferQueue.submit(cmdBuffer, fence);
-    fence.wait();
+    // The acquire submission waiting on the semaphore is done
+    device.semaphorePool().release(std::move(semaphore));
+    device.fencePool().release(std::move(fence));
+    return true;
 }
 
+// Same as uploadData(), the buffer is handed over to the transfer queue for the copy and given
+// back to the queue that owns it.
 template <typename T>
-void downloadData(vkw::Device& device, const vkw::DeviceBuffer<T>& src, T* dstPtr)
+bool downloadData(
+    vkw::Device& device, const vkw::DeviceBuffer<T>& src, T* dstPtr, vkw::Queue& srcQueue)
 {
     vkw::HostStagingBuffer<T> stagingBuffer(
         device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, src.size());
 
-    vkw::Queue transferQueue = device.getQueues(vkw::QueueUsageBits::Transfer)[0];
-    vkw::CommandPool cmdPool(device, transferQueue);
-    auto cmdBuffer = cmdPool.createCommandBuffer();
+    vkw::Queue transferQueue = device.getPreferredQueues(vkw::QueueUsageBits::Transfer)[0];
+    vkw::CommandPool srcCmdPool(device, srcQueue);
+    vkw::CommandPool transferCmdPool(device, transferQueue);
+    auto releaseCmdBuffer = srcCmdPool.createCommandBuffer();
+    auto transferCmdBuffer = transferCmdPool.createCommandBuffer();
+    auto acquireCmdBuffer = srcCmdPool.createCommandBuffer();
+
+    releaseCmdBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    releaseCmdBuffer.releaseBufferOwnership(
+        src,
+        srcQueue,
+        transferQueue,
+        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+        VK_ACCESS_MEMORY_WRITE_BIT);
+    releaseCmdBuffer.end();
+
+    transferCmdBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    transferCmdBuffer.acquireBufferOwnership(
+        src, srcQueue, transferQueue, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+    transferCmdBuffer.copyBuffer(src, stagingBuffer);
+    transferCmdBuffer.releaseBufferOwnership(
+        src, transferQueue, srcQueue, VK_PIPELINE_STAGE_TRANSFER_BIT, 0);
+    transferCmdBuffer.end();
+
+    acquireCmdBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    acquireCmdBuffer.acquireBufferOwnership(
+        src,
+        transferQueue,
+        srcQueue,
+        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+        VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT);
+    acquireCmdBuffer.end();
+
+    auto releaseSemaphore = device.semaphorePool().acquire();
+    auto transferSemaphore = device.semaphorePool().acquire();
+    auto fence = device.fencePool().acquire();
+
+    vkw::SubmitBatch batch{};
+    batch.addCommandBuffer(releaseCmdBuffer)
+        .addSignal(releaseSemaphore, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+    if(srcQueue.submit(batch) != VK_SUCCESS)
+    {
+        device.semaphorePool().release(std::move(releaseSemaphore));
+        device.semaphorePool().release(std::move(transferSemaphore));
+        device.fencePool().release(std::move(fence), false);
+        return false;
+    }
 
-    vkw::Fence fence(device);
-    cmdBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-    cmdBuffer.copyBuffer(src, stagingBuffer);
-    cmdBuffer.end();
+    // On failure, semaphores left signaled without a wait are destroyed instead of recycled
+    batch.addCommandBuffer(transferCmdBuffer)
+        .addWait(releaseSemaphore, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT)
+        .addSignal(transferSemaphore, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+    if(transferQueue.submit(batch) != VK_SUCCESS)
+    {
+        srcQueue.waitIdle();
+        device.semaphorePool().release(std::move(transferSemaphore));
+        device.fencePool().release(std::move(fence), false);
+        return false;
+    }
+
+    batch.addCommandBuffer(acquireCmdBuffer)
+        .addWait(transferSemaphore, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+    if(srcQueue.submit(batch, fence) != VK_SUCCESS)
+    {
+        transferQueue.waitIdle();
+        device.semaphorePool().release(std::move(releaseSemaphore));
+        device.fencePool().release(std::move(fence), false);
+        return false;
+    }
+    VKW_CHECK_BOOL_RETURN_FALSE(fence.wait());
 
-    transferQueue.submit(cmdBuffer, fence);
-    fence.wait();
+    // The last submission waited on the copy and on both semaphores
+    device.semaphorePool().release(std::move(releaseSemaphore));
+    device.semaphorePool().release(std::move(transferSemaphore));
+    device.fencePool().release(std::move(fence));
 
     stagingBuffer.copyToHost(dstPtr, src.size());
+    return true;
 }
 
 template <typename... Args>
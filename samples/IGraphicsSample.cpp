@@ -58,14 +58,17 @@ IGraphicsSample::IGraphicsSample()
 
 IGraphicsSample::~IGraphicsSample()
 {
+    // Deferred callbacks call into the derived sample, already destroyed here
+    if(frameScheduler_.initialized())
+    {
+        frameScheduler_.discardDeferred();
+    }
     postDrawCmdBuffers_.clear();
     drawCmdBuffers_.clear();
     initCmdBuffers_.clear();
     cmdPool_.clear();
 
-    renderSemaphores_.clear();
-    imgSemaphores_.clear();
-    frameFences_.clear();
+    frameScheduler_.clear();
     swapchain_.clear();
 
     device_.clear();
@@ -91,11 +94,17 @@ bool IGraphicsSample::initSample()
         fprintf(stderr, "Error: no supported device for this sample\n");
         return false;
     }
+    // One queue for rendering and a lower priority one for uploads, picked from a dedicated
+    // transfer family when there is one
+    vkw::QueuePlan queuePlan{};
+    queuePlan.add(vkw::QueueUsageBits::Graphics | vkw::QueueUsageBits::Compute, {1.0f})
+        .add(vkw::QueueUsageBits::Transfer, {0.5f});
     VKW_CHECK_BOOL_RETURN_FALSE(device_.init(
         instance_,
         physicalDevice,
         deviceExtensions_,
         deviceFeatures_.features,
+        queuePlan,
         deviceFeatures_.pNext));
     const auto graphicsQueues
         = device_.getQueues(vkw::QueueUsageBits::Graphics | vkw::QueueUsageBits::Compute);
@@ -110,8 +119,6 @@ bool IGraphicsSample::initSample()
 
     cmdPool_.init(device_, graphicsQueue_);
     initCmdBuffers_ = cmdPool_.createCommandBuffers(framesInFlight);
-    drawCmdBuffers_ = cmdPool_.createCommandBuffers(framesInFlight);
-    postDrawCmdBuffers_ = cmdPool_.createCommandBuffers(framesInFlight);
 
     VKW_CHECK_BOOL_RETURN_FALSE(swapchain_.init(
         surface_,
@@ -123,15 +130,17 @@ bool IGraphicsSample::initSample()
         VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
         colorSpace));
 
-    frameFences_.resize(framesInFlight);
-    imgSemaphores_.resize(framesInFlight);
-    renderSemaphores_.resize(framesInFlight);
+    VKW_CHECK_BOOL_RETURN_FALSE(frameScheduler_.init(
+        device_, swapchain_, graphicsQueue_, presentQueue_, framesInFlight));
     for(uint32_t i = 0; i < framesInFlight; ++i)
     {
-        VKW_CHECK_BOOL_RETURN_FALSE(frameFences_[i].init(device_, true));
-        VKW_CHECK_BOOL_RETURN_FALSE(imgSemaphores_[i].init(device_));
-        VKW_CHECK_BOOL_RETURN_FALSE(renderSemaphores_[i].init(device_));
+        // Per frame pools are reset by the scheduler when the frame slot is reused
+        drawCmdBuffers_.emplace_back(frameScheduler_.commandPool(i).createCommandBuffer());
+        postDrawCmdBuffers_.emplace_back(frameScheduler_.commandPool(i).createCommandBuffer());
     }
+    // Missing or stale caches are simply ignored
+    device_.pipelineCache().load(pipelineCacheFile);
+    VKW_CHECK_BOOL_RETURN_FALSE(jobSystem_.init());
     VKW_CHECK_BOOL_RETURN_FALSE(this->init());
 
     initImageLayouts();
@@ -139,6 +148,17 @@ bool IGraphicsSample::initSample()
 }
 
 bool IGraphicsSample::runSample()
+{
+    VKW_CHECK_BOOL_RETURN_FALSE(startSample());
+    while(!glfwWindowShouldClose(window_))
+    {
+        glfwPollEvents();
+        renderFrame();
+    }
+    return stopSample();
+}
+
+bool IGraphicsSample::startSample()
 {
     std::vector<vkw::Fence> initFences{};
     for(uint32_t id = 0; id < framesInFlight; ++id)
@@ -146,89 +166,74 @@ bool IGraphicsSample::runSample()
         const bool initRecorded = recordInitCommands(initCmdBuffers_[id], id);
         if(initRecorded)
         {
-            vkw::Fence initFence{device_, false};
-            graphicsQueue_.submit(initCmdBuffers_[id], initFence);
+            auto initFence = device_.fencePool().acquire();
+            if(graphicsQueue_.submit(initCmdBuffers_[id], initFence) != VK_SUCCESS)
+            {
+                device_.fencePool().release(std::move(initFence), false);
+                continue;
+            }
             initFences.emplace_back(std::move(initFence));
         }
     }
     vkw::Fence::wait(device_, initFences);
-    initFences.clear();
-
-    uint32_t imageIndex;
-    uint32_t frameIndex = 0;
-    while(!glfwWindowShouldClose(window_))
+    for(auto& initFence : initFences)
     {
-        glfwPollEvents();
-
-        auto& fence = frameFences_[frameIndex];
-        auto& imgSemaphore = imgSemaphores_[frameIndex];
-        auto& renderSemaphore = renderSemaphores_[frameIndex];
-
-        auto& drawCmdBuffer = drawCmdBuffers_[frameIndex];
-        auto& postDrawCmdBuffer = postDrawCmdBuffers_[frameIndex];
-
-        fence.wait();
+        device_.fencePool().release(std::move(initFence));
+    }
+    return true;
+}
 
-        VkResult res = VK_SUCCESS;
-        res = swapchain_.getNextImage(imageIndex, imgSemaphore, UINT64_MAX);
+void IGraphicsSample::renderFrame()
+{
+    VkResult res = frameScheduler_.beginFrame();
+    if(res == VK_ERROR_OUT_OF_DATE_KHR)
+    {
+        handleResize();
+        return;
+    }
+    else if((res != VK_SUCCESS) && (res != VK_SUBOPTIMAL_KHR))
+    {
+        throw std::runtime_error("Error acquiring the swap chain image");
+    }
 
-        if(res == VK_ERROR_OUT_OF_DATE_KHR)
-        {
-            handleResize();
-            continue;
-        }
-        else if((res != VK_SUCCESS) && (res != VK_SUBOPTIMAL_KHR))
-        {
-            throw std::runtime_error("Error acquiring the swap chain image");
-        }
-        fence.reset();
-
-        // Perform draw
-        recordDrawCommands(drawCmdBuffer, frameIndex, imageIndex);
-        res = graphicsQueue_.submit(
-            drawCmdBuffer,
-            std::vector<vkw::Semaphore*>{&imgSemaphore},
-            std::vector<VkPipelineStageFlags>{VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT},
-            std::vector<vkw::Semaphore*>{&renderSemaphore},
-            fence);
-        if(res != VK_SUCCESS)
-        {
-            throw std::runtime_error("Error submitting graphics commands");
-        }
+    const uint32_t frameIndex = frameScheduler_.frameIndex();
+    const uint32_t imageIndex = frameScheduler_.imageIndex();
+    auto& drawCmdBuffer = drawCmdBuffers_[frameIndex];
+    auto& postDrawCmdBuffer = postDrawCmdBuffers_[frameIndex];
 
-        res = presentQueue_.present(
-            swapchain_, std::vector<vkw::Semaphore*>{&renderSemaphore}, imageIndex);
-        if((res == VK_ERROR_OUT_OF_DATE_KHR) || (res == VK_SUBOPTIMAL_KHR) || needsResize_)
-        {
-            handleResize();
-            needsResize_ = false;
-        }
-        else if(res != VK_SUCCESS)
-        {
-            throw std::runtime_error("Error presenting image");
-        }
+    // Draw and post draw commands go in a single submission. Post draw commands are only
+    // ordered after the draw by submission order and must start with the barriers they need.
+    recordDrawCommands(drawCmdBuffer, frameIndex, imageIndex);
+    const bool postDrawRecorded = recordPostDrawCommands(postDrawCmdBuffer, frameIndex, imageIndex);
 
-        // Perform post draw operations
-        const bool postDrawRecorded
-            = recordPostDrawCommands(postDrawCmdBuffer, frameIndex, imageIndex);
-        if(postDrawRecorded)
-        {
-            auto postDrawFence = vkw::Fence{device_, false};
-            graphicsQueue_.submit(
-                postDrawCmdBuffer,
-                std::vector<vkw::Semaphore*>{&renderSemaphore},
-                std::vector<VkPipelineStageFlags>{VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT},
-                std::vector<vkw::Semaphore*>{},
-                postDrawFence);
-            postDrawFence.wait();
-            postDraw();
-        }
+    auto& submitBatch = frameScheduler_.batch();
+    submitBatch.addCommandBuffer(drawCmdBuffer);
+    if(postDrawRecorded)
+    {
+        submitBatch.nextSubmit().addCommandBuffer(postDrawCmdBuffer);
+        frameScheduler_.defer([this]() { postDraw(); });
+    }
 
-        frameIndex = (frameIndex + 1) % framesInFlight;
-        device_.waitIdle(); // Remove after debug
+    res = frameScheduler_.endFrame();
+    if((res == VK_ERROR_OUT_OF_DATE_KHR) || (res == VK_SUBOPTIMAL_KHR) || needsResize_)
+    {
+        handleResize();
+        needsResize_ = false;
     }
+    else if(res != VK_SUCCESS)
+    {
+        throw std::runtime_error("Error presenting image");
+    }
+}
+
+bool IGraphicsSample::stopSample()
+{
+    // Runs the pending post draw operations while the sample is still alive
+    frameScheduler_.waitIdle();
     device_.waitIdle();
 
+    device_.pipelineCache().save(pipelineCacheFile);
+
     return true;
 }
 
@@ -280,7 +285,8 @@ void IGraphicsSample::initImageLayouts()
         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, memoryBarriers);
     cmdBuffer.end();
 
-    auto initFence = vkw::Fence(device_, false);
+    auto initFence = device_.fencePool().acquire();
     graphicsQueue_.submit(cmdBuffer, initFence);
     initFence.wait();
+    device_.fencePool().release(std::move(initFence));
 }
\ No newline at end of file
@@ -24,6 +24,9 @@
 
 #include "Common.hpp"
 
+#include <vkw/high_level/FrameScheduler.hpp>
+#include <vkw/high_level/JobSystem.hpp>
+
 #include <vector>
 
 struct GLFWwindow;
@@ -38,12 +41,18 @@ class IGraphicsSample
     bool initSample();
     bool runSample();
 
+    // Steps of runSample(), for callers driving the frames themselves
+    bool startSample();
+    void renderFrame();
+    bool stopSample();
+
     void requestResize() { needsResize_ = true; }
 
   protected:
     static constexpr uint32_t initWidth = 800;
     static constexpr uint32_t initHeight = 600;
     static constexpr uint32_t framesInFlight = 3;
+    static constexpr const char* pipelineCacheFile = "pipeline_cache.bin";
 
     static constexpr VkFormat colorFormat = VK_FORMAT_R8G8B8A8_UNORM;
     static constexpr VkColorSpaceKHR colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
@@ -64,13 +73,13 @@ class IGraphicsSample
     vkw::Queue presentQueue_{};
 
     vkw::Swapchain swapchain_{};
-
-    std::vector<vkw::Fence> frameFences_{};
-    std::vector<vkw::Semaphore> imgSemaphores_{};
-    std::vector<vkw::Semaphore> renderSemaphores_{};
+    vkw::FrameScheduler frameScheduler_{};
 
     bool needsResize_{false};
 
+    // Long lived workers for the startup work of the samples, such as pipeline compilation
+    vkw::JobSystem jobSystem_{};
+
     vkw::CommandPool cmdPool_{};
     std::vector<vkw::CommandBuffer> initCmdBuffers_{};
     std::vector<vkw::CommandBuffer> drawCmdBuffers_{};
@@ -89,7 +98,8 @@ class IGraphicsSample
         vkw::CommandBuffer& cmdBuffer, const uint32_t frameId, const uint32_t imageId)
         = 0;
 
-    /// Use it to perform post draw operations - Synchronized with post draw commands execution.
+    /// Use it to perform post draw operations - Runs once the post draw commands of the frame have
+    /// executed, when its frame slot is reused.
     virtual bool postDraw() = 0;
 
     void handleResize();
@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "IndirectDispatch.hpp"
+
+#include <cstdlib>
+#include <stdexcept>
+
+IndirectDispatch::IndirectDispatch() {}
+
+VkPhysicalDevice IndirectDispatch::findSupportedDevice() const
+{
+    return findCompatibleDevice(instance_, deviceExtensions_);
+}
+
+bool IndirectDispatch::init()
+{
+    VKW_CHECK_BOOL_RETURN_FALSE(descriptorSetLayout_.init(device_));
+    descriptorSetLayout_
+        .addBinding<vkw::DescriptorType::StorageBuffer>(VK_SHADER_STAGE_COMPUTE_BIT, 0)
+        .addBinding<vkw::DescriptorType::StorageBuffer>(VK_SHADER_STAGE_COMPUTE_BIT, 1)
+        .addBinding<vkw::DescriptorType::StorageImage>(VK_SHADER_STAGE_COMPUTE_BIT, 2)
+        .addBinding<vkw::DescriptorType::UniformBuffer>(VK_SHADER_STAGE_COMPUTE_BIT, 3)
+        .create();
+
+    VKW_CHECK_BOOL_RETURN_FALSE(pipelineLayout_.init(device_, descriptorSetLayout_));
+    pipelineLayout_.create();
+
+    VKW_CHECK_BOOL_RETURN_FALSE(
+        argsPipeline_.init(device_, "build/spv/indirect_dispatch_args.comp.spv"));
+    VKW_CHECK_BOOL_RETURN_FALSE(
+        fillPipeline_.init(device_, "build/spv/indirect_dispatch_fill.comp.spv"));
+
+    // Compiled on the workers shared by the samples, the wall time compared to the sum of the
+    // compile times shows the speedup
+    vkw::PipelineBatchBuilder pipelineBuilder{};
+    pipelineBuilder.add(argsPipeline_, pipelineLayout_, 0, "indirect_dispatch_args")
+        .add(fillPipeline_, pipelineLayout_, 0, "indirect_dispatch_fill");
+    VKW_CHECK_BOOL_RETURN_FALSE(pipelineBuilder.build(jobSystem_));
+    double compileTimeMs = 0.0;
+    for(const auto& timing : pipelineBuilder.timings())
+    {
+        vkw::utils::Log::Info(
+            "samples", "Pipeline %s: %.2f ms", timing.name.c_str(), timing.compileTimeMs);
+        compileTimeMs += timing.compileTimeMs;
+    }
+    vkw::utils::Log::Info(
+        "samples",
+        "Pipelines: %.2f ms wall time, %.2f ms compile time",
+        pipelineBuilder.totalTimeMs(),
+        compileTimeMs);
+
+    // The first frame covers the whole image to clear it
+    Params initParams = {};
+    initParams.prevRect[2] = static_cast<int32_t>(initWidth);
+    initParams.prevRect[3] = static_cast<int32_t>(initHeight);
+
+    argsBuffers_.resize(framesInFlight);
+    paramsBuffers_.resize(framesInFlight);
+    outputImages_.resize(framesInFlight);
+    outputImagesViews_.resize(framesInFlight);
+    bundles_.resize(framesInFlight);
+    for(uint32_t i = 0; i < framesInFlight; ++i)
+    {
+        VKW_CHECK_BOOL_RETURN_FALSE(
+            argsBuffers_[i].init(device_, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 1));
+        VKW_CHECK_BOOL_RETURN_FALSE(paramsBuffers_[i].init(
+            device_, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, 1));
+        VKW_CHECK_BOOL_RETURN_FALSE(
+            uploadData(device_, &initParams, paramsBuffers_[i], graphicsQueue_));
+
+        VKW_CHECK_BOOL_RETURN_FALSE(outputImages_[i].init(
+            device_,
+            VK_IMAGE_TYPE_2D,
+            VK_FORMAT_R32G32B32A32_SFLOAT,
+            VkExtent3D{initWidth, initHeight, 1},
+            VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT));
+
+        VKW_CHECK_BOOL_RETURN_FALSE(outputImagesViews_[i].init(
+            device_,
+            outputImages_[i],
+            VK_IMAGE_VIEW_TYPE_2D,
+            VK_FORMAT_R32G32B32A32_SFLOAT,
+            {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1}));
+
+        VKW_CHECK_BOOL_RETURN_FALSE(bundles_[i].init(device_, cmdPool_));
+        frameParamsSlot_ = bundles_[i].addSlot<FrameParams>();
+        VKW_CHECK_BOOL_RETURN_FALSE(bundles_[i].createParameterBuffer());
+    }
+
+    descriptorPool_.init(
+        device_,
+        framesInFlight,
+        {{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2 * framesInFlight},
+         {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, framesInFlight},
+         {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, framesInFlight}});
+
+    for(uint32_t i = 0; i < framesInFlight; ++i)
+    {
+        vkw::DescriptorSet descriptorSet{device_, descriptorSetLayout_, descriptorPool_};
+        descriptorSet.bindStorageBuffer(0, argsBuffers_[i]);
+        descriptorSet.bindStorageBuffer(1, paramsBuffers_[i]);
+        descriptorSet.bindStorageImage(2, outputImagesViews_[i]);
+        descriptorSet.bindUniformBuffer(
+            3,
+            bundles_[i].parameterBuffer(),
+            frameParamsSlot_.offset,
+            frameParamsSlot_.sizeBytes());
+        descriptorSets_.emplace_back(std::move(descriptorSet));
+    }
+
+    // The bundles are only recorded again if one of the resources they use is recreated
+    for(uint32_t i = 0; i < framesInFlight; ++i)
+    {
+        VKW_CHECK_BOOL_RETURN_FALSE(bundles_[i].record(
+            [this, i](vkw::CommandBuffer& cmdBuffer) { recordComputeCommands(cmdBuffer, i); },
+            argsPipeline_,
+            fillPipeline_,
+            descriptorSets_[i],
+            argsBuffers_[i],
+            outputImages_[i]));
+    }
+
+    startTime_ = std::chrono::steady_clock::now();
+
+    return true;
+}
+
+bool IndirectDispatch::recordInitCommands(vkw::CommandBuffer& initCmdBuffer, const uint32_t frameId)
+{
+    initCmdBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    initCmdBuffer.imageMemoryBarrier(
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        vkw::createImageMemoryBarrier(
+            outputImages_[frameId],
+            0,
+            VK_ACCESS_SHADER_WRITE_BIT,
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_GENERAL));
+    initCmdBuffer.end();
+    return true;
+}
+
+void IndirectDispatch::recordDrawCommands(
+    vkw::CommandBuffer& cmdBuffer, const uint32_t frameId, const uint32_t imageId)
+{
+    const std::chrono::duration<float> elapsed = std::chrono::steady_clock::now() - startTime_;
+
+    FrameParams params{};
+    params.sizeX = initWidth;
+    params.sizeY = initHeight;
+    params.time = elapsed.count();
+
+    // The previous use of this bundle has completed, it can be updated
+    auto& bundle = bundles_[frameId];
+    bundle.setSlot(frameParamsSlot_, params);
+    const bool prepared = bundle.prepare(
+        argsPipeline_,
+        fillPipeline_,
+        descriptorSets_[frameId],
+        argsBuffers_[frameId],
+        outputImages_[frameId]);
+    if(!prepared)
+    {
+        throw std::runtime_error("Error recording command bundle");
+    }
+
+    cmdBuffer.reset();
+    cmdBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    cmdBuffer.executeCommands(bundle.commandBuffer());
+
+    cmdBuffer.imageMemoryBarrier(
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        vkw::createImageMemoryBarrier(
+            swapchain_.images()[imageId],
+            0,
+            VK_ACCESS_TRANSFER_WRITE_BIT,
+            VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL));
+
+    VkImageBlit region = {};
+    region.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    region.srcOffsets[0] = {0, 0, 0};
+    region.srcOffsets[1] = {initWidth, initHeight, 1};
+    region.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    region.dstOffsets[0] = {0, 0, 0};
+    region.dstOffsets[1]
+        = {static_cast<int32_t>(frameWidth_), static_cast<int32_t>(frameHeight_), 1};
+    cmdBuffer.blitImage(
+        outputImages_[frameId].getHandle(),
+        VK_IMAGE_LAYOUT_GENERAL,
+        swapchain_.images()[imageId],
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        region);
+
+    cmdBuffer.imageMemoryBarrier(
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        vkw::createImageMemoryBarrier(
+            swapchain_.images()[imageId],
+            VK_ACCESS_TRANSFER_WRITE_BIT,
+            0,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_IMAGE_LAYOUT_PRESENT_SRC_KHR));
+    cmdBuffer.end();
+}
+
+void IndirectDispatch::recordComputeCommands(vkw::CommandBuffer& cmdBuffer, const uint32_t frameId)
+{
+    cmdBuffer.bindComputeDescriptorSet(pipelineLayout_, 0, descriptorSets_[frameId]);
+
+    // Size the fill pass on the GPU
+    cmdBuffer.bindComputePipeline(argsPipeline_);
+    cmdBuffer.dispatch(1);
+    cmdBuffer.bufferMemoryBarriers(
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        vkw::createBufferMemoryBarrier(
+            argsBuffers_[frameId], VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT),
+        vkw::createBufferMemoryBarrier(
+            paramsBuffers_[frameId], VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT));
+
+    cmdBuffer.bindComputePipeline(fillPipeline_);
+    cmdBuffer.dispatchIndirect(argsBuffers_[frameId]);
+
+    cmdBuffer.imageMemoryBarrier(
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        vkw::createImageMemoryBarrier(
+            outputImages_[frameId],
+            VK_ACCESS_SHADER_WRITE_BIT,
+            VK_ACCESS_TRANSFER_READ_BIT,
+            VK_IMAGE_LAYOUT_GENERAL,
+            VK_IMAGE_LAYOUT_GENERAL));
+}
+
+bool IndirectDispatch::recordPostDrawCommands(
+    vkw::CommandBuffer& /*cmdBuffer*/, const uint32_t /*frameId*/, const uint32_t /*imageId*/)
+{
+    return false;
+}
+
+bool IndirectDispatch::postDraw() { return true; }
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "IGraphicsSample.hpp"
+
+#include <vkw/high_level/CommandBundle.hpp>
+#include <vkw/high_level/PipelineBatchBuilder.hpp>
+
+#include <chrono>
+
+// A first compute pass computes the region of the image that changes this frame and writes the
+// dispatch size for a second compute pass, which only processes that region. The host never
+// knows how many work groups are dispatched.
+// Both passes are recorded once per frame in flight in a command bundle, only the frame
+// parameters are updated from one frame to the next.
+class IndirectDispatch final : public IGraphicsSample
+{
+  public:
+    IndirectDispatch();
+
+    IndirectDispatch(const IndirectDispatch&) = delete;
+    IndirectDispatch(IndirectDispatch&&) = delete;
+
+    IndirectDispatch& operator=(const IndirectDispatch&) = delete;
+    IndirectDispatch& operator=(IndirectDispatch&&) = delete;
+
+    ~IndirectDispatch() {}
+
+  private:
+    // Matches the layout of the FrameParams uniform buffer in the shaders
+    struct FrameParams
+    {
+        uint32_t sizeX;
+        uint32_t sizeY;
+        float time;
+    };
+
+    // Matches the layout of the Params buffer in the shaders
+    struct Params
+    {
+        int32_t prevRect[4];
+        int32_t rect[4];
+        float disk[4];
+    };
+
+    vkw::DescriptorSetLayout descriptorSetLayout_{};
+    vkw::PipelineLayout pipelineLayout_{};
+    vkw::ComputePipeline argsPipeline_{};
+    vkw::ComputePipeline fillPipeline_{};
+
+    vkw::DescriptorPool descriptorPool_{};
+    std::vector<vkw::DescriptorSet> descriptorSets_{};
+
+    std::vector<vkw::DeviceBuffer<VkDispatchIndirectCommand, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT>>
+        argsBuffers_{};
+    std::vector<vkw::DeviceBuffer<Params>> paramsBuffers_{};
+    std::vector<vkw::DeviceImage<>> outputImages_{};
+    std::vector<vkw::ImageView> outputImagesViews_{};
+
+    std::vector<vkw::CommandBundle> bundles_{};
+    vkw::BundleSlot<FrameParams> frameParamsSlot_{};
+
+    std::chrono::steady_clock::time_point startTime_{};
+
+    VkPhysicalDevice findSupportedDevice() const override;
+
+    bool init() override;
+    bool recordInitCommands(vkw::CommandBuffer& cmdBuffer, const uint32_t frameId) override;
+    void recordDrawCommands(
+        vkw::CommandBuffer& cmdBuffer, const uint32_t frameId, const uint32_t imageId) override;
+    bool recordPostDrawCommands(
+        vkw::CommandBuffer& cmdBuffer, const uint32_t frameId, const uint32_t imageId) override;
+    bool postDraw() override;
+
+    void recordComputeCommands(vkw::CommandBuffer& cmdBuffer, const uint32_t frameId);
+};
@@ -97,9 +97,9 @@ bool RayQueryTriangle::init()
             | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR,
         1));
 
-    uploadData(device_, triangleData, vertexBuffer_);
-    uploadData(device_, indices, indexBuffer_);
-    uploadData(device_, &transform, transformBuffer_);
+    VKW_CHECK_BOOL_RETURN_FALSE(uploadData(device_, triangleData, vertexBuffer_, graphicsQueue_));
+    VKW_CHECK_BOOL_RETURN_FALSE(uploadData(device_, indices, indexBuffer_, graphicsQueue_));
+    VKW_CHECK_BOOL_RETURN_FALSE(uploadData(device_, &transform, transformBuffer_, graphicsQueue_));
 
     // Build acceleration structures
     geometryData_
@@ -71,8 +71,8 @@ bool SimpleTriangle::init()
     graphicsPipeline_.createPipeline(pipelineLayout_, {colorFormat});
 
     // Stream vertices
-    uploadData(device_, positions, positions_);
-    uploadData(device_, colors, colors_);
+    VKW_CHECK_BOOL_RETURN_FALSE(uploadData(device_, positions, positions_, graphicsQueue_));
+    VKW_CHECK_BOOL_RETURN_FALSE(uploadData(device_, colors, colors_, graphicsQueue_));
 
     return true;
 }
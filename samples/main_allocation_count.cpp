@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "IndirectDispatch.hpp"
+#include "SimpleTriangle.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+// Checks that a steady state frame records and submits without heap allocation. Global operator
+// new is replaced to count the allocations made while frames are rendered, after a few warm up
+// frames that let the scheduler, batches and pools reach their final capacity.
+
+static std::atomic<bool> countAllocations{false};
+static std::atomic<uint64_t> allocationCount{0};
+
+static void* allocate(const size_t size)
+{
+    if(countAllocations.load(std::memory_order_relaxed))
+    {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    return std::malloc(size > 0 ? size : 1);
+}
+
+void* operator new(size_t size)
+{
+    void* ptr = allocate(size);
+    if(ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+static constexpr uint32_t warmUpFrameCount = 16;
+static constexpr uint32_t measuredFrameCount = 256;
+
+static bool checkSample(const char* name, IGraphicsSample& sample)
+{
+    VKW_CHECK_BOOL_RETURN_FALSE(sample.initSample());
+    VKW_CHECK_BOOL_RETURN_FALSE(sample.startSample());
+
+    for(uint32_t i = 0; i < warmUpFrameCount; ++i)
+    {
+        sample.renderFrame();
+    }
+
+    allocationCount = 0;
+    countAllocations = true;
+    for(uint32_t i = 0; i < measuredFrameCount; ++i)
+    {
+        sample.renderFrame();
+    }
+    countAllocations = false;
+
+    VKW_CHECK_BOOL_RETURN_FALSE(sample.stopSample());
+
+    const uint64_t count = allocationCount;
+    if(count > 0)
+    {
+        vkw::utils::Log::Error(
+            "samples",
+            "%s: %llu allocations in %u frames",
+            name,
+            static_cast<unsigned long long>(count),
+            measuredFrameCount);
+        return false;
+    }
+    vkw::utils::Log::Info("samples", "%s: no allocation in %u frames", name, measuredFrameCount);
+    return true;
+}
+
+int main(int /*argc*/, char** /*argv*/)
+{
+    bool success = true;
+    try
+    {
+        {
+            auto sample = std::make_unique<SimpleTriangle>();
+            success &= checkSample("SimpleTriangle", *sample);
+        }
+        {
+            auto sample = std::make_unique<IndirectDispatch>();
+            success &= checkSample("IndirectDispatch", *sample);
+        }
+    }
+    catch(std::exception& e)
+    {
+        fprintf(stderr, "%s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -20,6 +20,8 @@
  * SOFTWARE.
  */
 
+#include "BindBenchmark.hpp"
+#include "IndirectDispatch.hpp"
 #include "RayQueryTriangle.hpp"
 #include "SimpleTriangle.hpp"
 
@@ -32,7 +34,9 @@ enum class TestCase : uint32_t
 {
     SimpleTriangle = 0,
     RayQueryTriangle = 1,
-    TestCaseCount = 2
+    IndirectDispatch = 2,
+    BindBenchmark = 3,
+    TestCaseCount = 4
 };
 
 int main(int argc, char** argv)
@@ -60,6 +64,12 @@ int main(int argc, char** argv)
             case TestCase::RayQueryTriangle:
                 graphicsSample.reset(new RayQueryTriangle());
                 break;
+            case TestCase::IndirectDispatch:
+                graphicsSample.reset(new IndirectDispatch());
+                break;
+            case TestCase::BindBenchmark:
+                graphicsSample.reset(new BindBenchmark());
+                break;
             default:
                 break;
         }
@@ -0,0 +1,750 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "vkw/detail/CommandStream.hpp"
+
+#include "vkw/detail/CommandBuffer.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <new>
+
+namespace vkw
+{
+class CommandStream::Translator
+{
+  public:
+    Translator(
+        CommandStream& stream,
+        const VolkDeviceTable& vk,
+        const VkCommandBuffer commandBuffer,
+        const TranslateOptions& options)
+        : stream_{stream}, vk_{vk}, commandBuffer_{commandBuffer}, options_{options}
+    {}
+
+    TranslateStats run()
+    {
+        const auto& packets = stream_.packets_;
+        const size_t packetCount = packets.size();
+
+        stats_.commandCount = static_cast<uint32_t>(packetCount);
+
+        size_t i = 0;
+        while(i < packetCount)
+        {
+            const PacketType type = packets[i]->type;
+            if(isAction(type))
+            {
+                flushBarriers();
+
+                bool hasDispatch = false;
+                bool hasDraw = false;
+                size_t end = i;
+                stream_.order_.clear();
+                while(end < packetCount && isAction(packets[end]->type))
+                {
+                    const bool dispatch = isDispatch(packets[end]->type);
+                    hasDispatch |= dispatch;
+                    hasDraw |= !dispatch;
+                    stream_.order_.push_back(static_cast<uint32_t>(end));
+                    ++end;
+                }
+
+                const bool sort = (!hasDispatch || options_.sortDispatches)
+                                  && (!hasDraw || options_.sortDraws);
+                if(sort)
+                {
+                    std::stable_sort(
+                        stream_.order_.begin(),
+                        stream_.order_.end(),
+                        [&packets](const uint32_t a, const uint32_t b) {
+                            const bool drawA = !isDispatch(packets[a]->type);
+                            const bool drawB = !isDispatch(packets[b]->type);
+                            if(drawA != drawB)
+                            {
+                                return drawB;
+                            }
+                            return std::less<VkPipeline>{}(
+                                getState(packets[a])->pipeline, getState(packets[b])->pipeline);
+                        });
+                }
+
+                for(const uint32_t id : stream_.order_)
+                {
+                    emitAction(packets[id]);
+                }
+                i = end;
+            }
+            else if(type == PacketType::PipelineBarrier)
+            {
+                const auto* packet = reinterpret_cast<const PipelineBarrierPacket*>(packets[i]);
+                appendBarrier(*packet);
+                if(!options_.mergeBarriers)
+                {
+                    flushBarriers();
+                }
+                ++i;
+            }
+            else
+            {
+                flushBarriers();
+                emitTransfer(packets[i]);
+                ++i;
+            }
+        }
+        flushBarriers();
+
+        return stats_;
+    }
+
+  private:
+    // What has actually been recorded into the command buffer for one bind point
+    struct BoundState
+    {
+        VkPipeline pipeline{VK_NULL_HANDLE};
+        VkPipelineLayout layout{VK_NULL_HANDLE};
+        VkDescriptorSet descriptorSets[maxDescriptorSets]{};
+        uint32_t descriptorSetMask{0};
+        const PushConstantsPacket* pushConstants[maxPushConstantRanges]{};
+        uint32_t pushConstantCount{0};
+
+        VkBuffer vertexBuffers[maxVertexBindings]{};
+        VkDeviceSize vertexOffsets[maxVertexBindings]{};
+        uint32_t vertexBufferMask{0};
+        VkBuffer indexBuffer{VK_NULL_HANDLE};
+        VkIndexType indexType{VK_INDEX_TYPE_UINT32};
+        VkViewport viewport{};
+        VkRect2D scissor{};
+        bool hasViewport{false};
+        bool hasScissor{false};
+    };
+
+    CommandStream& stream_;
+    const VolkDeviceTable& vk_;
+    VkCommandBuffer commandBuffer_{VK_NULL_HANDLE};
+    TranslateOptions options_{};
+    TranslateStats stats_{};
+
+    BoundState compute_{};
+    BoundState graphics_{};
+
+    bool barrierPending_{false};
+    VkPipelineStageFlags barrierSrcFlags_{0};
+    VkPipelineStageFlags barrierDstFlags_{0};
+
+    // Dispatches and draws come first in PacketType
+    static bool isAction(const PacketType type) { return type <= PacketType::DrawIndexedIndirect; }
+
+    static bool isDispatch(const PacketType type)
+    {
+        return type == PacketType::Dispatch || type == PacketType::DispatchIndirect;
+    }
+
+    static const BindState* getState(const PacketHeader* header)
+    {
+        switch(header->type)
+        {
+            case PacketType::Dispatch:
+                return reinterpret_cast<const DispatchPacket*>(header)->state;
+            case PacketType::Draw:
+            case PacketType::DrawIndexed:
+                return reinterpret_cast<const DrawPacket*>(header)->state;
+            default:
+                return reinterpret_cast<const IndirectPacket*>(header)->state;
+        }
+    }
+
+    void applyState(const BindState& state, const VkPipelineBindPoint bindPoint)
+    {
+        auto& bound = (bindPoint == VK_PIPELINE_BIND_POINT_COMPUTE) ? compute_ : graphics_;
+
+        if(state.pipeline != bound.pipeline)
+        {
+            vk_.vkCmdBindPipeline(commandBuffer_, bindPoint, state.pipeline);
+            bound.pipeline = state.pipeline;
+            stats_.bindCount++;
+        }
+        else
+        {
+            stats_.skippedBindCount++;
+        }
+
+        // Changing the layout may disturb previously bound sets and push constants
+        if(state.layout != bound.layout)
+        {
+            bound.layout = state.layout;
+            bound.descriptorSetMask = 0;
+            bound.pushConstantCount = 0;
+        }
+
+        for(uint32_t i = 0; i < maxDescriptorSets; ++i)
+        {
+            const uint32_t bit = 1u << i;
+            if((state.descriptorSetMask & bit) == 0)
+            {
+                continue;
+            }
+            if((bound.descriptorSetMask & bit) != 0
+               && bound.descriptorSets[i] == state.descriptorSets[i])
+            {
+                stats_.skippedBindCount++;
+                continue;
+            }
+            vk_.vkCmdBindDescriptorSets(
+                commandBuffer_,
+                bindPoint,
+                state.layout,
+                i,
+                1,
+                &state.descriptorSets[i],
+                0,
+                nullptr);
+            bound.descriptorSets[i] = state.descriptorSets[i];
+            bound.descriptorSetMask |= bit;
+            stats_.bindCount++;
+        }
+
+        for(uint32_t i = 0; i < state.pushConstantCount; ++i)
+        {
+            applyPushConstants(bound, state.pushConstants[i]);
+        }
+
+        if(bindPoint == VK_PIPELINE_BIND_POINT_GRAPHICS)
+        {
+            applyGraphicsState(state, bound);
+        }
+    }
+
+    void applyPushConstants(BoundState& bound, const PushConstantsPacket* packet)
+    {
+        const auto* data = trailingData<uint8_t>(packet, sizeof(PushConstantsPacket));
+
+        uint32_t slot = bound.pushConstantCount;
+        for(uint32_t i = 0; i < bound.pushConstantCount; ++i)
+        {
+            const auto* current = bound.pushConstants[i];
+            if(current->stages == packet->stages && current->offset == packet->offset
+               && current->size == packet->size)
+            {
+                const auto* currentData
+                    = trailingData<uint8_t>(current, sizeof(PushConstantsPacket));
+                if(current == packet || std::memcmp(currentData, data, packet->size) == 0)
+                {
+                    stats_.skippedBindCount++;
+                    return;
+                }
+                slot = i;
+                break;
+            }
+        }
+
+        vk_.vkCmdPushConstants(
+            commandBuffer_, packet->layout, packet->stages, packet->offset, packet->size, data);
+        stats_.bindCount++;
+
+        if(slot == bound.pushConstantCount)
+        {
+            if(slot == maxPushConstantRanges)
+            {
+                return;
+            }
+            bound.pushConstantCount++;
+        }
+        bound.pushConstants[slot] = packet;
+    }
+
+    void applyGraphicsState(const BindState& state, BoundState& bound)
+    {
+        for(uint32_t i = 0; i < maxVertexBindings; ++i)
+        {
+            const uint32_t bit = 1u << i;
+            if((state.vertexBufferMask & bit) == 0)
+            {
+                continue;
+            }
+            if((bound.vertexBufferMask & bit) != 0
+               && bound.vertexBuffers[i] == state.vertexBuffers[i]
+               && bound.vertexOffsets[i] == state.vertexOffsets[i])
+            {
+                stats_.skippedBindCount++;
+                continue;
+            }
+            vk_.vkCmdBindVertexBuffers(
+                commandBuffer_, i, 1, &state.vertexBuffers[i], &state.vertexOffsets[i]);
+            bound.vertexBuffers[i] = state.vertexBuffers[i];
+            bound.vertexOffsets[i] = state.vertexOffsets[i];
+            bound.vertexBufferMask |= bit;
+            stats_.bindCount++;
+        }
+
+        if(state.indexBuffer != VK_NULL_HANDLE)
+        {
+            if(state.indexBuffer != bound.indexBuffer || state.indexType != bound.indexType)
+            {
+                vk_.vkCmdBindIndexBuffer(commandBuffer_, state.indexBuffer, 0, state.indexType);
+                bound.indexBuffer = state.indexBuffer;
+                bound.indexType = state.indexType;
+                stats_.bindCount++;
+            }
+            else
+            {
+                stats_.skippedBindCount++;
+            }
+        }
+
+        if(state.hasViewport)
+        {
+            if(!bound.hasViewport
+               || std::memcmp(&state.viewport, &bound.viewport, sizeof(VkViewport)) != 0)
+            {
+                vk_.vkCmdSetViewport(commandBuffer_, 0, 1, &state.viewport);
+                bound.viewport = state.viewport;
+                bound.hasViewport = true;
+                stats_.bindCount++;
+            }
+            else
+            {
+                stats_.skippedBindCount++;
+            }
+        }
+
+        if(state.hasScissor)
+        {
+            if(!bound.hasScissor
+               || std::memcmp(&state.scissor, &bound.scissor, sizeof(VkRect2D)) != 0)
+            {
+                vk_.vkCmdSetScissor(commandBuffer_, 0, 1, &state.scissor);
+                bound.scissor = state.scissor;
+                bound.hasScissor = true;
+                stats_.bindCount++;
+            }
+            else
+            {
+                stats_.skippedBindCount++;
+            }
+        }
+    }
+
+    void emitAction(const PacketHeader* header)
+    {
+        switch(header->type)
+        {
+            case PacketType::Dispatch:
+            {
+                const auto* packet = reinterpret_cast<const DispatchPacket*>(header);
+                applyState(*packet->state, VK_PIPELINE_BIND_POINT_COMPUTE);
+                vk_.vkCmdDispatch(
+                    commandBuffer_,
+                    packet->groupCount[0],
+                    packet->groupCount[1],
+                    packet->groupCount[2]);
+                break;
+            }
+            case PacketType::DispatchIndirect:
+            {
+                const auto* packet = reinterpret_cast<const IndirectPacket*>(header);
+                applyState(*packet->state, VK_PIPELINE_BIND_POINT_COMPUTE);
+                vk_.vkCmdDispatchIndirect(commandBuffer_, packet->buffer, packet->offset);
+                break;
+            }
+            case PacketType::Draw:
+            {
+                const auto* packet = reinterpret_cast<const DrawPacket*>(header);
+                applyState(*packet->state, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                vk_.vkCmdDraw(
+                    commandBuffer_,
+                    packet->count,
+                    packet->instanceCount,
+                    packet->first,
+                    packet->firstInstance);
+                break;
+            }
+            case PacketType::DrawIndexed:
+            {
+                const auto* packet = reinterpret_cast<const DrawPacket*>(header);
+                applyState(*packet->state, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                vk_.vkCmdDrawIndexed(
+                    commandBuffer_,
+                    packet->count,
+                    packet->instanceCount,
+                    packet->first,
+                    packet->vertexOffset,
+                    packet->firstInstance);
+                break;
+            }
+            case PacketType::DrawIndirect:
+            {
+                const auto* packet = reinterpret_cast<const IndirectPacket*>(header);
+                applyState(*packet->state, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                vk_.vkCmdDrawIndirect(
+                    commandBuffer_,
+                    packet->buffer,
+                    packet->offset,
+                    packet->drawCount,
+                    packet->stride);
+                break;
+            }
+            case PacketType::DrawIndexedIndirect:
+            {
+                const auto* packet = reinterpret_cast<const IndirectPacket*>(header);
+                applyState(*packet->state, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                vk_.vkCmdDrawIndexedIndirect(
+                    commandBuffer_,
+                    packet->buffer,
+                    packet->offset,
+                    packet->drawCount,
+                    packet->stride);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    void emitTransfer(const PacketHeader* header)
+    {
+        switch(header->type)
+        {
+            case PacketType::CopyBuffer:
+            {
+                const auto* packet = reinterpret_cast<const CopyBufferPacket*>(header);
+                vk_.vkCmdCopyBuffer(
+                    commandBuffer_,
+                    packet->src,
+                    packet->dst,
+                    packet->regionCount,
+                    trailingData<VkBufferCopy>(packet, sizeof(CopyBufferPacket)));
+                break;
+            }
+            case PacketType::FillBuffer:
+            {
+                const auto* packet = reinterpret_cast<const FillBufferPacket*>(header);
+                vk_.vkCmdFillBuffer(
+                    commandBuffer_, packet->buffer, packet->offset, packet->size, packet->data);
+                break;
+            }
+            case PacketType::CopyBufferToImage:
+            {
+                const auto* packet = reinterpret_cast<const CopyBufferToImagePacket*>(header);
+                vk_.vkCmdCopyBufferToImage(
+                    commandBuffer_,
+                    packet->buffer,
+                    packet->image,
+                    packet->layout,
+                    1,
+                    &packet->region);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    void appendBarrier(const PipelineBarrierPacket& packet)
+    {
+        size_t offset = sizeof(PipelineBarrierPacket);
+        const auto* memoryBarriers = trailingData<VkMemoryBarrier>(&packet, offset);
+        offset += packet.memoryBarrierCount * sizeof(VkMemoryBarrier);
+        const auto* bufferBarriers = trailingData<VkBufferMemoryBarrier>(&packet, offset);
+        offset += packet.bufferMemoryBarrierCount * sizeof(VkBufferMemoryBarrier);
+        const auto* imageBarriers = trailingData<VkImageMemoryBarrier>(&packet, offset);
+
+        // Two layout transitions of the same image can not be part of the same barrier
+        if(barrierPending_)
+        {
+            bool conflict = false;
+            for(uint32_t i = 0; i < packet.imageMemoryBarrierCount && !conflict; ++i)
+            {
+                for(const auto& pending : stream_.imageMemoryBarriers_)
+                {
+                    if(pending.image == imageBarriers[i].image)
+                    {
+                        conflict = true;
+                        break;
+                    }
+                }
+            }
+            if(conflict)
+            {
+                flushBarriers();
+            }
+            else
+            {
+                stats_.mergedBarrierCount++;
+            }
+        }
+
+        barrierPending_ = true;
+        barrierSrcFlags_ |= packet.srcFlags;
+        barrierDstFlags_ |= packet.dstFlags;
+        stream_.memoryBarriers_.insert(
+            stream_.memoryBarriers_.end(),
+            memoryBarriers,
+            memoryBarriers + packet.memoryBarrierCount);
+        stream_.bufferMemoryBarriers_.insert(
+            stream_.bufferMemoryBarriers_.end(),
+            bufferBarriers,
+            bufferBarriers + packet.bufferMemoryBarrierCount);
+        stream_.imageMemoryBarriers_.insert(
+            stream_.imageMemoryBarriers_.end(),
+            imageBarriers,
+            imageBarriers + packet.imageMemoryBarrierCount);
+    }
+
+    void flushBarriers()
+    {
+        if(!barrierPending_)
+        {
+            return;
+        }
+
+        vk_.vkCmdPipelineBarrier(
+            commandBuffer_,
+            barrierSrcFlags_,
+            barrierDstFlags_,
+            0,
+            static_cast<uint32_t>(stream_.memoryBarriers_.size()),
+            stream_.memoryBarriers_.data(),
+            static_cast<uint32_t>(stream_.bufferMemoryBarriers_.size()),
+            stream_.bufferMemoryBarriers_.data(),
+            static_cast<uint32_t>(stream_.imageMemoryBarriers_.size()),
+            stream_.imageMemoryBarriers_.data());
+        stats_.barrierCount++;
+
+        stream_.memoryBarriers_.clear();
+        stream_.bufferMemoryBarriers_.clear();
+        stream_.imageMemoryBarriers_.clear();
+        barrierSrcFlags_ = 0;
+        barrierDstFlags_ = 0;
+        barrierPending_ = false;
+    }
+};
+
+// -------------------------------------------------------------------------------------------------
+
+void CommandStream::reset()
+{
+    packets_.clear();
+    blockId_ = 0;
+    blockOffset_ = 0;
+
+    computeState_ = {};
+    graphicsState_ = {};
+    computeSnapshot_ = nullptr;
+    graphicsSnapshot_ = nullptr;
+}
+
+void CommandStream::clear()
+{
+    this->reset();
+
+    blocks_.clear();
+    packets_.shrink_to_fit();
+    order_.clear();
+    order_.shrink_to_fit();
+}
+
+size_t CommandStream::memoryUsage() const
+{
+    size_t ret = 0;
+    for(const auto& block : blocks_)
+    {
+        ret += block.size;
+    }
+    return ret;
+}
+
+CommandStream::TranslateStats CommandStream::translate(
+    CommandBuffer& cmdBuffer, const TranslateOptions& options)
+{
+    VKW_ASSERT(cmdBuffer.recording_);
+
+    Translator translator{*this, cmdBuffer.device_->vk(), cmdBuffer.commandBuffer_, options};
+    return translator.run();
+}
+
+// -------------------------------------------------------------------------------------------------
+
+CommandStream& CommandStream::pushConstants(
+    const VkPipelineLayout pipelineLayout,
+    const VkShaderStageFlags stages,
+    const uint32_t offset,
+    const uint32_t size,
+    const void* values)
+{
+    VKW_ASSERT(size > 0);
+
+    auto* packet
+        = reinterpret_cast<PushConstantsPacket*>(allocate(sizeof(PushConstantsPacket) + size));
+    packet->layout = pipelineLayout;
+    packet->stages = stages;
+    packet->offset = offset;
+    packet->size = size;
+    std::memcpy(reinterpret_cast<uint8_t*>(packet) + sizeof(PushConstantsPacket), values, size);
+
+    const bool compute = (stages & VK_SHADER_STAGE_COMPUTE_BIT) != 0;
+    auto& state = compute ? computeState_ : graphicsState_;
+    if(compute)
+    {
+        computeSnapshot_ = nullptr;
+    }
+    else
+    {
+        graphicsSnapshot_ = nullptr;
+    }
+
+    if(state.layout != pipelineLayout)
+    {
+        state.layout = pipelineLayout;
+        state.descriptorSetMask = 0;
+        state.pushConstantCount = 0;
+    }
+
+    for(uint32_t i = 0; i < state.pushConstantCount; ++i)
+    {
+        if(state.pushConstants[i]->stages == stages && state.pushConstants[i]->offset == offset)
+        {
+            state.pushConstants[i] = packet;
+            return *this;
+        }
+    }
+
+    if(state.pushConstantCount == maxPushConstantRanges)
+    {
+        utils::Log::Error("vkw", "Too many push constant ranges recorded in command stream");
+        return *this;
+    }
+    state.pushConstants[state.pushConstantCount++] = packet;
+
+    return *this;
+}
+
+CommandStream& CommandStream::copyBuffer(
+    const VkBuffer src, const VkBuffer dst, const VkBufferCopy* regions, const uint32_t regionCount)
+{
+    auto* packet = allocPacket<CopyBufferPacket>(
+        PacketType::CopyBuffer, regionCount * sizeof(VkBufferCopy));
+    packet->src = src;
+    packet->dst = dst;
+    packet->regionCount = regionCount;
+    std::memcpy(
+        reinterpret_cast<uint8_t*>(packet) + sizeof(CopyBufferPacket),
+        regions,
+        regionCount * sizeof(VkBufferCopy));
+
+    return *this;
+}
+
+CommandStream& CommandStream::pipelineBarrier(
+    const VkPipelineStageFlags srcFlags,
+    const VkPipelineStageFlags dstFlags,
+    const VkMemoryBarrier* memoryBarriers,
+    const uint32_t memoryBarrierCount,
+    const VkBufferMemoryBarrier* bufferMemoryBarriers,
+    const uint32_t bufferMemoryBarrierCount,
+    const VkImageMemoryBarrier* imageMemoryBarriers,
+    const uint32_t imageMemoryBarrierCount)
+{
+    const size_t memorySize = memoryBarrierCount * sizeof(VkMemoryBarrier);
+    const size_t bufferSize = bufferMemoryBarrierCount * sizeof(VkBufferMemoryBarrier);
+    const size_t imageSize = imageMemoryBarrierCount * sizeof(VkImageMemoryBarrier);
+
+    auto* packet = allocPacket<PipelineBarrierPacket>(
+        PacketType::PipelineBarrier, memorySize + bufferSize + imageSize);
+    packet->srcFlags = srcFlags;
+    packet->dstFlags = dstFlags;
+    packet->memoryBarrierCount = memoryBarrierCount;
+    packet->bufferMemoryBarrierCount = bufferMemoryBarrierCount;
+    packet->imageMemoryBarrierCount = imageMemoryBarrierCount;
+
+    auto* data = reinterpret_cast<uint8_t*>(packet) + sizeof(PipelineBarrierPacket);
+    if(memorySize > 0)
+    {
+        std::memcpy(data, memoryBarriers, memorySize);
+    }
+    if(bufferSize > 0)
+    {
+        std::memcpy(data + memorySize, bufferMemoryBarriers, bufferSize);
+    }
+    if(imageSize > 0)
+    {
+        std::memcpy(data + memorySize + bufferSize, imageMemoryBarriers, imageSize);
+    }
+
+    return *this;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void* CommandStream::allocate(const size_t size)
+{
+    const size_t allocSize = utils::alignedSize(size, packetAlignment);
+
+    while(blockId_ < blocks_.size() && blockOffset_ + allocSize > blocks_[blockId_].size)
+    {
+        blockId_++;
+        blockOffset_ = 0;
+    }
+
+    if(blockId_ == blocks_.size())
+    {
+        Block block{};
+        block.size = std::max(blockSize_, allocSize);
+        block.data.reset(new uint8_t[block.size]);
+        blocks_.emplace_back(std::move(block));
+        blockOffset_ = 0;
+    }
+
+    void* ret = blocks_[blockId_].data.get() + blockOffset_;
+    blockOffset_ += allocSize;
+
+    return ret;
+}
+
+void CommandStream::bindDescriptorSet(
+    BindState& state,
+    const VkPipelineLayout layout,
+    const uint32_t firstSet,
+    const VkDescriptorSet descriptorSet)
+{
+    if(firstSet >= maxDescriptorSets)
+    {
+        utils::Log::Error("vkw", "Descriptor set index %u out of command stream range", firstSet);
+        return;
+    }
+
+    if(state.layout != layout)
+    {
+        state.layout = layout;
+        state.descriptorSetMask = 0;
+        state.pushConstantCount = 0;
+    }
+
+    state.descriptorSets[firstSet] = descriptorSet;
+    state.descriptorSetMask |= (1u << firstSet);
+}
+
+const CommandStream::BindState* CommandStream::snapshot(const BindState& state)
+{
+    return new(allocate(sizeof(BindState))) BindState(state);
+}
+} // namespace vkw
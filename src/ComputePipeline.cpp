@@ -22,6 +22,8 @@
 
 #include "vkw/detail/ComputePipeline.hpp"
 
+#include "vkw/detail/PipelineCache.hpp"
+
 #include <stdexcept>
 
 namespace vkw
@@ -40,6 +42,7 @@ ComputePipeline& ComputePipeline::operator=(ComputePipeline&& cp)
     std::swap(device_, cp.device_);
     std::swap(shaderSource_, cp.shaderSource_);
     std::swap(pipeline_, cp.pipeline_);
+    std::swap(generation_, cp.generation_);
     std::swap(initialized_, cp.initialized_);
 
     return *this;
@@ -71,6 +74,7 @@ void ComputePipeline::clear()
 
     device_ = nullptr;
     pipeline_ = VK_NULL_HANDLE;
+    generation_ = 0;
 
     specData_.clear();
     specSizes_.clear();
@@ -78,7 +82,8 @@ void ComputePipeline::clear()
     initialized_ = false;
 }
 
-bool ComputePipeline::createPipeline(PipelineLayout& pipelineLayout)
+bool ComputePipeline::createPipeline(
+    PipelineLayout& pipelineLayout, const VkPipelineCreateFlags flags)
 {
     VKW_ASSERT(this->initialized());
 
@@ -113,14 +118,20 @@ bool ComputePipeline::createPipeline(PipelineLayout& pipelineLayout)
     VkComputePipelineCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
     createInfo.pNext = nullptr;
-    createInfo.flags = 0;
+    createInfo.flags = flags;
     createInfo.stage = stageCreateInfo;
     createInfo.layout = pipelineLayout.getHandle();
     createInfo.basePipelineHandle = VK_NULL_HANDLE;
     createInfo.basePipelineIndex = 0;
 
     VKW_CHECK_VK_RETURN_FALSE(device_->vk().vkCreateComputePipelines(
-        device_->getHandle(), VK_NULL_HANDLE, 1, &createInfo, nullptr, &pipeline_));
+        device_->getHandle(),
+        device_->pipelineCache().getHandle(),
+        1,
+        &createInfo,
+        nullptr,
+        &pipeline_));
+    generation_ = utils::nextGeneration();
 
     device_->vk().vkDestroyShaderModule(device_->getHandle(), shaderModule, nullptr);
 
@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "vkw/detail/DescriptorBuffer.hpp"
+
+#include "vkw/detail/utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace vkw
+{
+DescriptorBuffer::DescriptorBuffer(
+    Device& device, const DescriptorSetLayout& layout, const uint32_t setCount)
+{
+    VKW_CHECK_BOOL_FAIL(
+        this->init(device, layout, setCount), "Error initializing descriptor buffer");
+}
+
+DescriptorBuffer& DescriptorBuffer::operator=(DescriptorBuffer&& rhs)
+{
+    this->clear();
+
+    std::swap(device_, rhs.device_);
+    std::swap(buffer_, rhs.buffer_);
+
+    std::swap(properties_, rhs.properties_);
+    std::swap(usage_, rhs.usage_);
+
+    std::swap(bindingOffsets_, rhs.bindingOffsets_);
+    std::swap(bindingTypes_, rhs.bindingTypes_);
+
+    std::swap(setStride_, rhs.setStride_);
+    std::swap(setCount_, rhs.setCount_);
+
+    std::swap(initialized_, rhs.initialized_);
+
+    return *this;
+}
+
+bool DescriptorBuffer::init(
+    Device& device, const DescriptorSetLayout& layout, const uint32_t setCount)
+{
+    VKW_ASSERT(this->initialized() == false);
+    VKW_ASSERT(layout.isDescriptorBuffer());
+
+    device_ = &device;
+    setCount_ = setCount;
+
+    properties_ = {};
+    properties_.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT;
+    properties_.pNext = nullptr;
+
+    VkPhysicalDeviceProperties2 properties2 = {};
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties2.pNext = &properties_;
+    vkGetPhysicalDeviceProperties2(device_->getPhysicalDevice(), &properties2);
+
+    VkDeviceSize layoutSize = 0;
+    device_->vk().vkGetDescriptorSetLayoutSizeEXT(
+        device_->getHandle(), layout.getHandle(), &layoutSize);
+    setStride_ = utils::alignedSize(
+        std::max(layoutSize, VkDeviceSize(1)), properties_.descriptorBufferOffsetAlignment);
+
+    // Binding offsets inside one set, sampler descriptors need a buffer with the sampler usage
+    uint32_t bindingCount = 0;
+    for(const auto& binding : layout.bindingList())
+    {
+        bindingCount = std::max(bindingCount, binding.binding + 1);
+    }
+    bindingOffsets_.assign(bindingCount, 0);
+    bindingTypes_.assign(bindingCount, VK_DESCRIPTOR_TYPE_MAX_ENUM);
+
+    usage_ = 0;
+    for(const auto& binding : layout.bindingList())
+    {
+        device_->vk().vkGetDescriptorSetLayoutBindingOffsetEXT(
+            device_->getHandle(),
+            layout.getHandle(),
+            binding.binding,
+            &bindingOffsets_[binding.binding]);
+        bindingTypes_[binding.binding] = binding.descriptorType;
+
+        if(binding.descriptorType == VK_DESCRIPTOR_TYPE_SAMPLER
+           || binding.descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
+        {
+            usage_ |= VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT;
+        }
+        else
+        {
+            usage_ |= VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT;
+        }
+    }
+    if(usage_ == 0)
+    {
+        usage_ = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT;
+    }
+
+    VKW_INIT_CHECK_BOOL(buffer_.init(
+        device,
+        usage_,
+        static_cast<size_t>(setStride_ * setCount_),
+        properties_.descriptorBufferOffsetAlignment));
+    memset(buffer_.data(), 0, buffer_.size());
+
+    initialized_ = true;
+
+    return true;
+}
+
+void DescriptorBuffer::clear()
+{
+    buffer_.clear();
+
+    properties_ = {};
+    usage_ = 0;
+
+    bindingOffsets_.clear();
+    bindingTypes_.clear();
+
+    setStride_ = 0;
+    setCount_ = 0;
+
+    device_ = nullptr;
+    initialized_ = false;
+}
+
+DescriptorBuffer& DescriptorBuffer::bindSampler(
+    const uint32_t descriptorSetId, const uint32_t binding, const VkSampler sampler)
+{
+    VkDescriptorGetInfoEXT info = {};
+    info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
+    info.pNext = nullptr;
+    info.type = VK_DESCRIPTOR_TYPE_SAMPLER;
+    info.data.pSampler = &sampler;
+
+    return writeDescriptor(descriptorSetId, binding, info);
+}
+
+DescriptorBuffer& DescriptorBuffer::bindCombinedImageSampler(
+    const uint32_t descriptorSetId,
+    const uint32_t binding,
+    const VkSampler sampler,
+    const VkImageView imageView,
+    const VkImageLayout layout)
+{
+    VkDescriptorImageInfo imageInfo = {};
+    imageInfo.sampler = sampler;
+    imageInfo.imageView = imageView;
+    imageInfo.imageLayout = layout;
+
+    VkDescriptorGetInfoEXT info = {};
+    info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
+    info.pNext = nullptr;
+    info.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    info.data.pCombinedImageSampler = &imageInfo;
+
+    return writeDescriptor(descriptorSetId, binding, info);
+}
+
+DescriptorBuffer& DescriptorBuffer::bindSampledImage(
+    const uint32_t descriptorSetId,
+    const uint32_t binding,
+    const VkImageView imageView,
+    const VkImageLayout layout)
+{
+    VkDescriptorImageInfo imageInfo = {};
+    imageInfo.sampler = VK_NULL_HANDLE;
+    imageInfo.imageView = imageView;
+    imageInfo.imageLayout = layout;
+
+    VkDescriptorGetInfoEXT info = {};
+    info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
+    info.pNext = nullptr;
+    info.type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    info.data.pSampledImage = &imageInfo;
+
+    return writeDescriptor(descriptorSetId, binding, info);
+}
+
+DescriptorBuffer& DescriptorBuffer::bindStorageImage(
+    const uint32_t descriptorSetId,
+    const uint32_t binding,
+    const VkImageView imageView,
+    const VkImageLayout layout)
+{
+    VkDescriptorImageInfo imageInfo = {};
+    imageInfo.sampler = VK_NULL_HANDLE;
+    imageInfo.imageView = imageView;
+    imageInfo.imageLayout = layout;
+
+    VkDescriptorGetInfoEXT info = {};
+    info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
+    info.pNext = nullptr;
+    info.type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    info.data.pStorageImage = &imageInfo;
+
+    return writeDescriptor(descriptorSetId, binding, info);
+}
+
+DescriptorBuffer& DescriptorBuffer::bindUniformTexelBuffer(
+    const uint32_t descriptorSetId,
+    const uint32_t binding,
+    const VkDeviceAddress address,
+    const VkDeviceSize range,
+    const VkFormat format)
+{
+    VkDescriptorAddressInfoEXT addressInfo = {};
+    addressInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT;
+    addressInfo.pNext = nullptr;
+    addressInfo.address = address;
+    addressInfo.range = range;
+    addressInfo.format = format;
+
+    VkDescriptorGetInfoEXT info = {};
+    info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
+    info.pNext = nullptr;
+    info.type = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+    info.data.pUniformTexelBuffer = &addressInfo;
+
+    return writeDescriptor(descriptorSetId, binding, info);
+}
+
+DescriptorBuffer& DescriptorBuffer::bindStorageTexelBuffer(
+    const uint32_t descriptorSetId,
+    const uint32_t binding,
+    const VkDeviceAddress address,
+    const VkDeviceSize range,
+    const VkFormat format)
+{
+    VkDescriptorAddressInfoEXT addressInfo = {};
+    addressInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT;
+    addressInfo.pNext = nullptr;
+    addressInfo.address = address;
+    addressInfo.range = range;
+    addressInfo.format = format;
+
+    VkDescriptorGetInfoEXT info = {};
+    info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
+    info.pNext = nullptr;
+    info.type = VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+    info.data.pStorageTexelBuffer = &addressInfo;
+
+    return writeDescriptor(descriptorSetId, binding, info);
+}
+
+DescriptorBuffer& DescriptorBuffer::bindUniformBuffer(
+    const uint32_t descriptorSetId,
+    const uint32_t binding,
+    const VkDeviceAddress address,
+    const VkDeviceSize range)
+{
+    VkDescriptorAddressInfoEXT addressInfo = {};
+    addressInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT;
+    addressInfo.pNext = nullptr;
+    addressInfo.address = address;
+    addressInfo.range = range;
+    addressInfo.format = VK_FORMAT_UNDEFINED;
+
+    VkDescriptorGetInfoEXT info = {};
+    info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
+    info.pNext = nullptr;
+    info.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    info.data.pUniformBuffer = &addressInfo;
+
+    return writeDescriptor(descriptorSetId, binding, info);
+}
+
+DescriptorBuffer& DescriptorBuffer::bindStorageBuffer(
+    const uint32_t descriptorSetId,
+    const uint32_t binding,
+    const VkDeviceAddress address,
+    const VkDeviceSize range)
+{
+    VkDescriptorAddressInfoEXT addressInfo = {};
+    addressInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT;
+    addressInfo.pNext = nullptr;
+    addressInfo.address = address;
+    addressInfo.range = range;
+    addressInfo.format = VK_FORMAT_UNDEFINED;
+
+    VkDescriptorGetInfoEXT info = {};
+    info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
+    info.pNext = nullptr;
+    info.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    info.data.pStorageBuffer = &addressInfo;
+
+    return writeDescriptor(descriptorSetId, binding, info);
+}
+
+DescriptorBuffer& DescriptorBuffer::bindAccelerationStructure(
+    const uint32_t descriptorSetId, const uint32_t binding, const VkDeviceAddress address)
+{
+    VkDescriptorGetInfoEXT info = {};
+    info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
+    info.pNext = nullptr;
+    info.type = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+    info.data.accelerationStructure = address;
+
+    return writeDescriptor(descriptorSetId, binding, info);
+}
+
+DescriptorBuffer& DescriptorBuffer::writeDescriptor(
+    const uint32_t descriptorSetId, const uint32_t binding, const VkDescriptorGetInfoEXT& info)
+{
+    VKW_ASSERT(this->initialized());
+
+    if(descriptorSetId >= setCount_ || binding >= bindingTypes_.size())
+    {
+        utils::Log::Error(
+            "vkw",
+            "Descriptor buffer write out of range (set %u, binding %u)",
+            descriptorSetId,
+            binding);
+        return *this;
+    }
+    if(bindingTypes_[binding] != info.type)
+    {
+        utils::Log::Error("vkw", "Descriptor type mismatch for binding %u", binding);
+        return *this;
+    }
+
+    // The driver writes the descriptor straight into the mapped buffer
+    auto* dst = buffer_.data() + this->setOffset(descriptorSetId) + bindingOffsets_[binding];
+    device_->vk().vkGetDescriptorEXT(device_->getHandle(), &info, descriptorSize(info.type), dst);
+
+    return *this;
+}
+
+size_t DescriptorBuffer::descriptorSize(const VkDescriptorType type) const
+{
+    switch(type)
+    {
+        case VK_DESCRIPTOR_TYPE_SAMPLER:
+            return properties_.samplerDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+            return properties_.combinedImageSamplerDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+            return properties_.sampledImageDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+            return properties_.storageImageDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+            return properties_.uniformTexelBufferDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+            return properties_.storageTexelBufferDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            return properties_.uniformBufferDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            return properties_.storageBufferDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+            return properties_.inputAttachmentDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR:
+            return properties_.accelerationStructureDescriptorSize;
+        default:
+            return 0;
+    }
+}
+} // namespace vkw
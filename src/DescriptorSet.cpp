@@ -38,6 +38,7 @@ DescriptorSet& DescriptorSet::operator=(DescriptorSet&& rhs)
     std::swap(device_, rhs.device_);
     std::swap(descriptorPool_, rhs.descriptorPool_);
     std::swap(descriptorSet_, rhs.descriptorSet_);
+    std::swap(generation_, rhs.generation_);
     std::swap(initialized_, rhs.initialized_);
 
     return *this;
@@ -64,6 +65,7 @@ bool DescriptorSet::init(
     VKW_INIT_CHECK_VK(device_->vk().vkAllocateDescriptorSets(
         device_->getHandle(), &allocateInfo, &descriptorSet_));
 
+    generation_ = utils::nextGeneration();
     initialized_ = true;
     return true;
 }
@@ -79,6 +81,7 @@ void DescriptorSet::clear()
 
     descriptorPool_ = nullptr;
     device_ = nullptr;
+    generation_ = 0;
     initialized_ = false;
 }
 
@@ -99,6 +102,7 @@ DescriptorSet& DescriptorSet::bindSampler(const uint32_t binding, const VkSample
     writeDescriptorSet.pTexelBufferView = nullptr;
 
     device_->vk().vkUpdateDescriptorSets(device_->getHandle(), 1, &writeDescriptorSet, 0, nullptr);
+    generation_ = utils::nextGeneration();
     return *this;
 }
 
@@ -123,6 +127,7 @@ DescriptorSet& DescriptorSet::bindCombinedImageSampler(
     writeDescriptorSet.pTexelBufferView = nullptr;
 
     device_->vk().vkUpdateDescriptorSets(device_->getHandle(), 1, &writeDescriptorSet, 0, nullptr);
+    generation_ = utils::nextGeneration();
     return *this;
 }
 
@@ -144,6 +149,7 @@ DescriptorSet& DescriptorSet::bindSampledImage(
     writeDescriptorSet.pTexelBufferView = nullptr;
 
     device_->vk().vkUpdateDescriptorSets(device_->getHandle(), 1, &writeDescriptorSet, 0, nullptr);
+    generation_ = utils::nextGeneration();
     return *this;
 }
 
@@ -165,6 +171,7 @@ DescriptorSet& DescriptorSet::bindStorageImage(
     writeDescriptorSet.pTexelBufferView = nullptr;
 
     device_->vk().vkUpdateDescriptorSets(device_->getHandle(), 1, &writeDescriptorSet, 0, nullptr);
+    generation_ = utils::nextGeneration();
     return *this;
 }
 
@@ -184,6 +191,7 @@ DescriptorSet& DescriptorSet::bindUniformTexelBuffer(
     writeDescriptorSet.pTexelBufferView = &bufferView;
 
     device_->vk().vkUpdateDescriptorSets(device_->getHandle(), 1, &writeDescriptorSet, 0, nullptr);
+    generation_ = utils::nextGeneration();
     return *this;
 }
 
@@ -203,6 +211,7 @@ DescriptorSet& DescriptorSet::bindStorageTexelBuffer(
     writeDescriptorSet.pTexelBufferView = &bufferView;
 
     device_->vk().vkUpdateDescriptorSets(device_->getHandle(), 1, &writeDescriptorSet, 0, nullptr);
+    generation_ = utils::nextGeneration();
     return *this;
 }
 
@@ -227,6 +236,7 @@ DescriptorSet& DescriptorSet::bindStorageBuffer(
     writeDescriptorSet.pTexelBufferView = nullptr;
 
     device_->vk().vkUpdateDescriptorSets(device_->getHandle(), 1, &writeDescriptorSet, 0, nullptr);
+    generation_ = utils::nextGeneration();
     return *this;
 }
 
@@ -251,6 +261,7 @@ DescriptorSet& DescriptorSet::bindUniformBuffer(
     writeDescriptorSet.pTexelBufferView = nullptr;
 
     device_->vk().vkUpdateDescriptorSets(device_->getHandle(), 1, &writeDescriptorSet, 0, nullptr);
+    generation_ = utils::nextGeneration();
     return *this;
 }
 
@@ -275,6 +286,7 @@ DescriptorSet& DescriptorSet::bindStorageBufferDynamic(
     writeDescriptorSet.pTexelBufferView = nullptr;
 
     device_->vk().vkUpdateDescriptorSets(device_->getHandle(), 1, &writeDescriptorSet, 0, nullptr);
+    generation_ = utils::nextGeneration();
     return *this;
 }
 
@@ -299,6 +311,7 @@ DescriptorSet& DescriptorSet::bindUniformBufferDynamic(
     writeDescriptorSet.pTexelBufferView = nullptr;
 
     device_->vk().vkUpdateDescriptorSets(device_->getHandle(), 1, &writeDescriptorSet, 0, nullptr);
+    generation_ = utils::nextGeneration();
     return *this;
 }
 
@@ -324,6 +337,7 @@ DescriptorSet& DescriptorSet::bindAccelerationStructure(
     writeDescriptorSet.pTexelBufferView = nullptr;
 
     device_->vk().vkUpdateDescriptorSets(device_->getHandle(), 1, &writeDescriptorSet, 0, nullptr);
+    generation_ = utils::nextGeneration();
     return *this;
 }
 } // namespace vkw
\ No newline at end of file
@@ -38,7 +38,9 @@ DescriptorSetLayout& DescriptorSetLayout::operator=(DescriptorSetLayout&& cp)
     std::swap(device_, cp.device_);
     std::swap(descriptorSetLayout_, cp.descriptorSetLayout_);
 
+    std::swap(bindingCounts_, cp.bindingCounts_);
     std::swap(bindings_, cp.bindings_);
+    std::swap(flags_, cp.flags_);
 
     std::swap(initialized_, cp.initialized_);
 
@@ -59,6 +61,7 @@ bool DescriptorSetLayout::init(Device& device)
 void DescriptorSetLayout::clear()
 {
     bindings_.clear();
+    flags_ = 0;
 
     VKW_DELETE_VK(DescriptorSetLayout, descriptorSetLayout_);
     memset(bindingCounts_, 0, descriptorTypeCount * sizeof(uint32_t));
@@ -72,7 +75,7 @@ void DescriptorSetLayout::create()
     VkDescriptorSetLayoutCreateInfo createInfo = {};
     createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     createInfo.pNext = nullptr;
-    createInfo.flags = 0;
+    createInfo.flags = flags_;
     createInfo.bindingCount = static_cast<uint32_t>(bindings_.size());
     createInfo.pBindings = reinterpret_cast<const VkDescriptorSetLayoutBinding*>(bindings_.data());
 
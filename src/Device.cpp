@@ -22,10 +22,13 @@
 
 #include "vkw/detail/Device.hpp"
 
+#include "vkw/detail/PipelineCache.hpp"
+#include "vkw/detail/Synchronization.hpp"
 #include "vkw/detail/utils.hpp"
 
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <stdexcept>
 #include <vector>
 
@@ -61,6 +64,22 @@ Device::Device(
         "Creating device");
 }
 
+Device::Device(
+    Instance& instance,
+    const VkPhysicalDevice& physicalDevice,
+    const std::vector<const char*>& extensions,
+    const VkPhysicalDeviceFeatures& requiredFeatures,
+    const QueuePlan& queuePlan,
+    const void* pCreateNext)
+{
+    VKW_CHECK_BOOL_FAIL(
+        this->init(
+            instance, physicalDevice, extensions, requiredFeatures, queuePlan, pCreateNext),
+        "Creating device");
+}
+
+Device::Device() {}
+
 Device::Device(Device&& rhs) { *this = std::move(rhs); }
 
 Device& Device::operator=(Device&& rhs)
@@ -70,15 +89,23 @@ Device& Device::operator=(Device&& rhs)
     std::swap(instance_, rhs.instance_);
 
     std::swap(deviceFeatures_, rhs.deviceFeatures_);
+    std::swap(enabledFeatures_, rhs.enabledFeatures_);
+    std::swap(enabledExtensions_, rhs.enabledExtensions_);
     std::swap(deviceProperties_, rhs.deviceProperties_);
     std::swap(physicalDevice_, rhs.physicalDevice_);
     std::swap(memProperties_, rhs.memProperties_);
 
     std::swap(memAllocator_, rhs.memAllocator_);
 
+    std::swap(queueMutexes_, rhs.queueMutexes_);
     std::swap(device_, rhs.device_);
 
+    std::swap(fencePool_, rhs.fencePool_);
+    std::swap(semaphorePool_, rhs.semaphorePool_);
+    std::swap(pipelineCache_, rhs.pipelineCache_);
+
     std::swap(useDeviceBufferAddress_, rhs.useDeviceBufferAddress_);
+    std::swap(useSynchronization2_, rhs.useSynchronization2_);
 
     std::swap(initialized_, rhs.initialized_);
 
@@ -93,14 +120,22 @@ bool Device::init(
     const std::vector<const char*>& extensions,
     const VkPhysicalDeviceFeatures& requiredFeatures,
     const void* pCreateNext)
+{
+    return init(instance, physicalDevice, extensions, requiredFeatures, QueuePlan{}, pCreateNext);
+}
+
+bool Device::init(
+    Instance& instance,
+    const VkPhysicalDevice& physicalDevice,
+    const std::vector<const char*>& extensions,
+    const VkPhysicalDeviceFeatures& requiredFeatures,
+    const QueuePlan& queuePlan,
+    const void* pCreateNext)
 {
     VKW_ASSERT(this->initialized() == false);
 
     instance_ = &instance;
 
-    queuePriorities_.resize(maxQueueCount);
-    std::fill(queuePriorities_.begin(), queuePriorities_.end(), 1.0f);
-
     physicalDevice_ = physicalDevice;
 
     VkPhysicalDeviceProperties properties{};
@@ -113,6 +148,8 @@ bool Device::init(
     vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
 
     deviceFeatures_ = features;
+    enabledFeatures_ = requiredFeatures;
+    enabledExtensions_.assign(extensions.begin(), extensions.end());
     deviceProperties_ = properties;
     memProperties_ = memProperties;
 
@@ -120,7 +157,13 @@ bool Device::init(
     utils::Log::Info("vkw", "Device type : %s", getStringDeviceType(properties.deviceType));
 
     // Create logical device
-    auto queueCreateInfoList = getAvailableQueuesInfo();
+    auto queueCreateInfoList = getAvailableQueuesInfo(queuePlan);
+    if(queueCreateInfoList.empty())
+    {
+        utils::Log::Error("vkw", "No queue can be created for this queue plan");
+        clear();
+        return false;
+    }
 
     VkDeviceCreateInfo deviceCreateInfo = {};
     deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -133,14 +176,27 @@ bool Device::init(
     deviceCreateInfo.pEnabledFeatures = &requiredFeatures;
     deviceCreateInfo.enabledLayerCount = 0;
     deviceCreateInfo.ppEnabledLayerNames = nullptr;
-    VKW_INIT_CHECK_VK(vkCreateDevice(physicalDevice_, &deviceCreateInfo, nullptr, &device_));
+    VkResult res = vkCreateDevice(physicalDevice_, &deviceCreateInfo, nullptr, &device_);
+    if(res == VK_ERROR_NOT_PERMITTED_KHR && !queueGlobalPriorities_.empty())
+    {
+        // Raising the global priority may need privileges, fall back to the default one
+        utils::Log::Warning("vkw", "Queue global priority not permitted, using the default one");
+        for(auto& createInfo : queueCreateInfoList)
+        {
+            createInfo.pNext = nullptr;
+        }
+        res = vkCreateDevice(physicalDevice_, &deviceCreateInfo, nullptr, &device_);
+    }
+    queuePriorities_.clear();
+    queueGlobalPriorities_.clear();
+    VKW_INIT_CHECK_VK(res);
     volkLoadDeviceTable(&vkDeviceTable_, device_);
 
+    validateAdditionalFeatures(reinterpret_cast<const VkBaseOutStructure*>(pCreateNext));
+
     // Get queue handles
     allocateQueues();
 
-    validateAdditionalFeatures(reinterpret_cast<const VkBaseOutStructure*>(pCreateNext));
-
     VmaVulkanFunctions vmaVkFunctions = {};
     vmaVkFunctions.vkGetInstanceProcAddr = vkGetInstanceProcAddr;
     vmaVkFunctions.vkGetDeviceProcAddr = vkGetDeviceProcAddr;
@@ -161,6 +217,14 @@ bool Device::init(
     allocatorCreateInfo.pTypeExternalMemoryHandleTypes = nullptr;
     VKW_INIT_CHECK_VK(vmaCreateAllocator(&allocatorCreateInfo, &memAllocator_));
 
+    fencePool_ = std::make_unique<FencePool>();
+    semaphorePool_ = std::make_unique<SemaphorePool>();
+    VKW_INIT_CHECK_BOOL(fencePool_->init(*this));
+    VKW_INIT_CHECK_BOOL(semaphorePool_->init(*this));
+
+    pipelineCache_ = std::make_unique<PipelineCache>();
+    VKW_INIT_CHECK_BOOL(pipelineCache_->init(*this));
+
     initialized_ = true;
 
     utils::Log::Info("wkw", "Logical device created");
@@ -169,10 +233,22 @@ bool Device::init(
 
 void Device::clear()
 {
+    // Pooled fences and semaphores may still be used by the GPU
+    if(device_ != VK_NULL_HANDLE)
+    {
+        this->waitIdle();
+    }
+
+    // Pooled objects must go before the device. Pending semaphore releases may refer to pooled
+    // fences, the semaphore pool goes first.
+    semaphorePool_.reset();
+    fencePool_.reset();
+    pipelineCache_.reset();
+
     vmaDestroyAllocator(memAllocator_);
     memAllocator_ = VK_NULL_HANDLE;
 
-    if(physicalDevice_ != VK_NULL_HANDLE)
+    if(device_ != VK_NULL_HANDLE)
     {
         vk().vkDestroyDevice(device_, nullptr);
     }
@@ -180,15 +256,77 @@ void Device::clear()
     instance_ = nullptr;
 
     deviceFeatures_ = {};
+    enabledFeatures_ = {};
+    enabledExtensions_.clear();
     deviceProperties_ = {};
     physicalDevice_ = VK_NULL_HANDLE;
 
+    queuePriorities_.clear();
+    queueGlobalPriorities_.clear();
     deviceQueues_.clear();
+    queueMutexes_.clear();
     device_ = VK_NULL_HANDLE;
 
     initialized_ = false;
 }
 
+bool Device::isExtensionEnabled(const char* extensionName) const
+{
+    for(const auto& extension : enabledExtensions_)
+    {
+        if(strcmp(extension.c_str(), extensionName) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t Device::getTimestampValidBits(const uint32_t queueFamilyIndex) const
+{
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice_, &queueFamilyCount, nullptr);
+
+    std::vector<VkQueueFamilyProperties> properties;
+    properties.resize(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice_, &queueFamilyCount, properties.data());
+
+    return (queueFamilyIndex < queueFamilyCount) ? properties[queueFamilyIndex].timestampValidBits
+                                                 : 0;
+}
+
+uint32_t Device::getTimestampValidBits() const
+{
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice_, &queueFamilyCount, nullptr);
+
+    std::vector<VkQueueFamilyProperties> properties;
+    properties.resize(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice_, &queueFamilyCount, properties.data());
+
+    uint32_t validBits = 0;
+    for(const auto& props : properties)
+    {
+        if(props.timestampValidBits > 0)
+        {
+            validBits = (validBits > 0) ? std::min(validBits, props.timestampValidBits)
+                                        : props.timestampValidBits;
+        }
+    }
+    return validBits;
+}
+
+void Device::waitIdle() const
+{
+    std::vector<std::unique_lock<std::mutex>> queueLocks;
+    queueLocks.reserve(queueMutexes_.size());
+    for(const auto& mutex : queueMutexes_)
+    {
+        queueLocks.emplace_back(*mutex);
+    }
+    vk().vkDeviceWaitIdle(device_);
+}
+
 std::vector<Queue> Device::getQueues(const QueueUsageFlags requiredFlags) const
 {
     std::vector<Queue> ret = {};
@@ -204,6 +342,17 @@ std::vector<Queue> Device::getQueues(const QueueUsageFlags requiredFlags) const
     return ret;
 }
 
+std::vector<Queue> Device::getPreferredQueues(const QueueUsageFlags requiredFlags) const
+{
+    auto ret = getQueues(requiredFlags);
+    std::stable_sort(ret.begin(), ret.end(), [&](const Queue& q0, const Queue& q1) {
+        return getExtraCapabilityCost(q0.flags(), requiredFlags)
+               < getExtraCapabilityCost(q1.flags(), requiredFlags);
+    });
+
+    return ret;
+}
+
 std::vector<Queue> Device::getPresentQueues(const Surface& surface) const
 {
     std::vector<Queue> ret = {};
@@ -219,9 +368,12 @@ std::vector<Queue> Device::getPresentQueues(const Surface& surface) const
     return ret;
 }
 
-std::vector<VkDeviceQueueCreateInfo> Device::getAvailableQueuesInfo()
+std::vector<VkDeviceQueueCreateInfo> Device::getAvailableQueuesInfo(const QueuePlan& queuePlan)
 {
     deviceQueues_.clear();
+    queueMutexes_.clear();
+    queuePriorities_.clear();
+    queueGlobalPriorities_.clear();
 
     std::vector<VkDeviceQueueCreateInfo> ret{};
 
@@ -232,49 +384,104 @@ std::vector<VkDeviceQueueCreateInfo> Device::getAvailableQueuesInfo()
     properties.resize(queueFamilyCount);
     vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice_, &queueFamilyCount, properties.data());
 
-    for(size_t i = 0; i < properties.size(); ++i)
-    {
-        const auto& props = properties[i];
-        const uint32_t queueCount = props.queueCount;
-        const VkQueueFlags queueFlags = props.queueFlags;
+    // Zero when no global priority is requested for the family
+    std::vector<VkQueueGlobalPriorityKHR> globalPriorities(
+        queueFamilyCount, VkQueueGlobalPriorityKHR(0));
+    queuePriorities_.resize(queueFamilyCount);
 
-        QueueUsageFlags flags = 0;
-        if(queueFlags & VK_QUEUE_GRAPHICS_BIT)
-        {
-            flags |= uint32_t(QueueUsageBits::Graphics);
-        }
-        if(queueFlags & VK_QUEUE_COMPUTE_BIT)
+    if(queuePlan.requests.empty())
+    {
+        for(uint32_t i = 0; i < queueFamilyCount; ++i)
         {
-            flags |= uint32_t(QueueUsageBits::Compute);
+            queuePriorities_[i].assign(std::min(properties[i].queueCount, maxQueueCount), 1.0f);
         }
-        if(queueFlags & VK_QUEUE_TRANSFER_BIT)
+    }
+
+    for(const auto& request : queuePlan.requests)
+    {
+        VKW_ASSERT(!request.priorities.empty());
+
+        // Most specialized family supporting the request with queues left
+        bool supported = false;
+        uint32_t familyIndex = queueFamilyCount;
+        for(uint32_t i = 0; i < queueFamilyCount; ++i)
         {
-            flags |= uint32_t(QueueUsageBits::Transfer);
+            const auto flags = getQueueUsageFlags(properties[i].queueFlags);
+            if((flags & request.flags) != request.flags)
+            {
+                continue;
+            }
+            supported = true;
+
+            const uint32_t familyQueueCount = std::min(properties[i].queueCount, maxQueueCount);
+            if(queuePriorities_[i].size() >= familyQueueCount)
+            {
+                continue;
+            }
+            if(familyIndex == queueFamilyCount
+               || getExtraCapabilityCost(flags, request.flags)
+                      < getExtraCapabilityCost(
+                          getQueueUsageFlags(properties[familyIndex].queueFlags), request.flags))
+            {
+                familyIndex = i;
+            }
         }
-        if(queueFlags & VK_QUEUE_SPARSE_BINDING_BIT)
+
+        if(!supported)
         {
-            flags |= uint32_t(QueueUsageBits::SparseBinding);
+            utils::Log::Error("vkw", "No queue family supports queue usage 0x%x", request.flags);
+            return {};
         }
-        if(queueFlags & VK_QUEUE_PROTECTED_BIT)
+        if(familyIndex == queueFamilyCount)
         {
-            flags |= uint32_t(QueueUsageBits::Protected);
+            // Families supporting the request are full, their queues are shared
+            utils::Log::Warning(
+                "vkw", "No queue left for queue usage 0x%x, sharing existing ones", request.flags);
+            continue;
         }
-        if(queueFlags & VK_QUEUE_VIDEO_DECODE_BIT_KHR)
+
+        auto& priorities = queuePriorities_[familyIndex];
+        const size_t availableCount
+            = std::min(properties[familyIndex].queueCount, maxQueueCount) - priorities.size();
+        const size_t queueCount = std::min(request.priorities.size(), availableCount);
+        if(queueCount < request.priorities.size())
         {
-            flags |= uint32_t(QueueUsageBits::VideoDecode);
+            utils::Log::Warning(
+                "vkw",
+                "Only %zu queues available for queue usage 0x%x, %zu requested",
+                queueCount,
+                request.flags,
+                request.priorities.size());
         }
-        if(queueFlags & VK_QUEUE_VIDEO_ENCODE_BIT_KHR)
+        priorities.insert(
+            priorities.end(), request.priorities.begin(), request.priorities.begin() + queueCount);
+        globalPriorities[familyIndex]
+            = std::max(globalPriorities[familyIndex], request.globalPriority);
+    }
+
+    const bool globalPriorityEnabled = isExtensionEnabled(VK_KHR_GLOBAL_PRIORITY_EXTENSION_NAME)
+                                       || isExtensionEnabled(VK_EXT_GLOBAL_PRIORITY_EXTENSION_NAME);
+
+    // Create infos point in there, no reallocation allowed
+    queueGlobalPriorities_.reserve(queueFamilyCount);
+    for(uint32_t i = 0; i < queueFamilyCount; ++i)
+    {
+        const auto& priorities = queuePriorities_[i];
+        if(priorities.empty())
         {
-            flags |= uint32_t(QueueUsageBits::VideoEncode);
+            continue;
         }
 
-        for(uint32_t ii = 0; ii < std::min(queueCount, maxQueueCount); ++ii)
+        const QueueUsageFlags flags = getQueueUsageFlags(properties[i].queueFlags);
+        for(uint32_t ii = 0; ii < static_cast<uint32_t>(priorities.size()); ++ii)
         {
             Queue queue{vk()};
             queue.flags_ = flags;
-            queue.queueFamilyIndex_ = static_cast<uint32_t>(i);
+            queue.queueFamilyIndex_ = i;
             queue.queueIndex_ = ii;
             queue.physicalDevice_ = physicalDevice_;
+            queueMutexes_.emplace_back(std::make_unique<std::mutex>());
+            queue.mutex_ = queueMutexes_.back().get();
             deviceQueues_.emplace_back(std::move(queue));
         }
 
@@ -282,9 +489,30 @@ std::vector<VkDeviceQueueCreateInfo> Device::getAvailableQueuesInfo()
         createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
         createInfo.pNext = nullptr;
         createInfo.flags = 0;
-        createInfo.pQueuePriorities = queuePriorities_.data();
-        createInfo.queueFamilyIndex = static_cast<uint32_t>(i);
-        createInfo.queueCount = std::min(queueCount, maxQueueCount);
+        createInfo.pQueuePriorities = priorities.data();
+        createInfo.queueFamilyIndex = i;
+        createInfo.queueCount = static_cast<uint32_t>(priorities.size());
+
+        const auto globalPriority = globalPriorities[i];
+        if(globalPriority != 0 && globalPriority != VK_QUEUE_GLOBAL_PRIORITY_MEDIUM_KHR)
+        {
+            if(globalPriorityEnabled)
+            {
+                VkDeviceQueueGlobalPriorityCreateInfoKHR globalPriorityInfo{};
+                globalPriorityInfo.sType
+                    = VK_STRUCTURE_TYPE_DEVICE_QUEUE_GLOBAL_PRIORITY_CREATE_INFO_KHR;
+                globalPriorityInfo.pNext = nullptr;
+                globalPriorityInfo.globalPriority = globalPriority;
+                queueGlobalPriorities_.emplace_back(globalPriorityInfo);
+                createInfo.pNext = &queueGlobalPriorities_.back();
+            }
+            else
+            {
+                utils::Log::Warning(
+                    "vkw", "Global priority extension not enabled, ignoring queue global priority");
+            }
+        }
+
         ret.emplace_back(createInfo);
     }
 
@@ -293,24 +521,56 @@ std::vector<VkDeviceQueueCreateInfo> Device::getAvailableQueuesInfo()
 
 void Device::allocateQueues()
 {
-    uint32_t queueFamilyCount = 0;
-    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice_, &queueFamilyCount, nullptr);
-
-    std::vector<VkQueueFamilyProperties> properties;
-    properties.resize(queueFamilyCount);
-    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice_, &queueFamilyCount, properties.data());
+    for(auto& queue : deviceQueues_)
+    {
+        vk().vkGetDeviceQueue(device_, queue.queueFamilyIndex_, queue.queueIndex_, &queue.queue_);
+        queue.useSynchronization2_ = (useSynchronization2_ == VK_TRUE);
+    }
+}
 
-    size_t index = 0;
-    for(uint32_t i = 0; i < queueFamilyCount; ++i)
+QueueUsageFlags Device::getQueueUsageFlags(const VkQueueFlags queueFlags)
+{
+    QueueUsageFlags flags = 0;
+    if(queueFlags & VK_QUEUE_GRAPHICS_BIT)
     {
-        const auto& props = properties[i];
-        const uint32_t queueCount = props.queueCount;
-        for(uint32_t ii = 0; ii < std::min(queueCount, maxQueueCount); ++ii)
-        {
-            vk().vkGetDeviceQueue(device_, i, ii, &(deviceQueues_[index].queue_));
-            index++;
-        }
+        flags |= uint32_t(QueueUsageBits::Graphics);
+    }
+    if(queueFlags & VK_QUEUE_COMPUTE_BIT)
+    {
+        flags |= uint32_t(QueueUsageBits::Compute);
+    }
+    if(queueFlags & VK_QUEUE_TRANSFER_BIT)
+    {
+        flags |= uint32_t(QueueUsageBits::Transfer);
+    }
+    if(queueFlags & VK_QUEUE_SPARSE_BINDING_BIT)
+    {
+        flags |= uint32_t(QueueUsageBits::SparseBinding);
+    }
+    if(queueFlags & VK_QUEUE_PROTECTED_BIT)
+    {
+        flags |= uint32_t(QueueUsageBits::Protected);
+    }
+    if(queueFlags & VK_QUEUE_VIDEO_DECODE_BIT_KHR)
+    {
+        flags |= uint32_t(QueueUsageBits::VideoDecode);
+    }
+    if(queueFlags & VK_QUEUE_VIDEO_ENCODE_BIT_KHR)
+    {
+        flags |= uint32_t(QueueUsageBits::VideoEncode);
     }
+    return flags;
+}
+
+uint32_t Device::getExtraCapabilityCost(
+    const QueueUsageFlags flags, const QueueUsageFlags requiredFlags)
+{
+    const QueueUsageFlags extraFlags = flags & ~requiredFlags;
+    uint32_t cost = 0;
+    cost += (extraFlags & QueueUsageBits::Graphics) ? 4 : 0;
+    cost += (extraFlags & QueueUsageBits::Compute) ? 2 : 0;
+    cost += (extraFlags & QueueUsageBits::Transfer) ? 1 : 0;
+    return cost;
 }
 
 void Device::validateAdditionalFeatures(const VkBaseOutStructure* pCreateNext)
@@ -326,6 +586,15 @@ void Device::validateAdditionalFeatures(const VkBaseOutStructure* pCreateNext)
                     = reinterpret_cast<VkPhysicalDeviceBufferDeviceAddressFeatures*>(next)
                           ->bufferDeviceAddress;
                 break;
+            case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES:
+                useSynchronization2_
+                    = reinterpret_cast<VkPhysicalDeviceSynchronization2Features*>(next)
+                          ->synchronization2;
+                break;
+            case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES:
+                useSynchronization2_
+                    = reinterpret_cast<VkPhysicalDeviceVulkan13Features*>(next)->synchronization2;
+                break;
             default:
                 break;
         }
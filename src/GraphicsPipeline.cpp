@@ -22,6 +22,7 @@
 
 #include "vkw/detail/GraphicsPipeline.hpp"
 
+#include "vkw/detail/PipelineCache.hpp"
 #include "vkw/detail/utils.hpp"
 
 #include <stdexcept>
@@ -41,6 +42,8 @@ GraphicsPipeline& GraphicsPipeline::operator=(GraphicsPipeline&& cp)
 
     std::swap(device_, cp.device_);
     std::swap(pipeline_, cp.pipeline_);
+    std::swap(generation_, cp.generation_);
+    std::swap(libraryParts_, cp.libraryParts_);
     std::swap(bindingDescriptions_, cp.bindingDescriptions_);
     std::swap(attributeDescriptions_, cp.attributeDescriptions_);
 
@@ -170,25 +173,18 @@ bool GraphicsPipeline::init(Device& device)
 void GraphicsPipeline::clear()
 {
     VKW_DELETE_VK(Pipeline, pipeline_);
-
-    device_ = nullptr;
+    generation_ = 0;
+    libraryParts_ = 0;
 
     bindingDescriptions_.clear();
     attributeDescriptions_.clear();
 
     // Destroy shader modules if not done
-    for(size_t id = 0; id < maxStageCount; ++id)
+    if(device_ != nullptr)
     {
-        if(moduleInfo_[id].shaderModule != VK_NULL_HANDLE)
-        {
-            device_->vk().vkDestroyShaderModule(
-                device_->getHandle(), moduleInfo_[id].shaderModule, nullptr);
-            moduleInfo_[id].shaderModule = VK_NULL_HANDLE;
-        }
+        releasePipelineStages();
     }
-
-    specInfoList_.clear();
-    stageCreateInfoList_.clear();
+    device_ = nullptr;
 
     for(auto& info : moduleInfo_)
     {
@@ -307,20 +303,16 @@ bool GraphicsPipeline::createPipeline(
     createInfo.basePipelineIndex = 0;
 
     VKW_CHECK_VK_RETURN_FALSE(device_->vk().vkCreateGraphicsPipelines(
-        device_->getHandle(), VK_NULL_HANDLE, 1, &createInfo, nullptr, &pipeline_));
+        device_->getHandle(),
+        device_->pipelineCache().getHandle(),
+        1,
+        &createInfo,
+        nullptr,
+        &pipeline_));
+    generation_ = utils::nextGeneration();
 
     // Destroy shader modules
-    for(size_t id = 0; id < maxStageCount; ++id)
-    {
-        if(moduleInfo_[id].shaderModule != VK_NULL_HANDLE)
-        {
-            device_->vk().vkDestroyShaderModule(
-                device_->getHandle(), moduleInfo_[id].shaderModule, nullptr);
-            moduleInfo_[id].shaderModule = VK_NULL_HANDLE;
-        }
-    }
-    specInfoList_.clear();
-    stageCreateInfoList_.clear();
+    releasePipelineStages();
 
     return true;
 }
@@ -368,20 +360,206 @@ bool GraphicsPipeline::createPipeline(
     createInfo.pNext = &pipelineRenderingCreateInfo;
 
     VKW_CHECK_VK_RETURN_FALSE(device_->vk().vkCreateGraphicsPipelines(
-        device_->getHandle(), VK_NULL_HANDLE, 1, &createInfo, nullptr, &pipeline_));
+        device_->getHandle(),
+        device_->pipelineCache().getHandle(),
+        1,
+        &createInfo,
+        nullptr,
+        &pipeline_));
+    generation_ = utils::nextGeneration();
 
     // Destroy shader modules
-    for(size_t id = 0; id < maxStageCount; ++id)
+    releasePipelineStages();
+
+    return true;
+}
+
+bool GraphicsPipeline::createLibrary(
+    const VkGraphicsPipelineLibraryFlagsEXT parts,
+    RenderPass& renderPass,
+    PipelineLayout& pipelineLayout,
+    const VkPipelineCreateFlags flags,
+    const uint32_t subPass)
+{
+    return createLibrary(parts, pipelineLayout, renderPass.getHandle(), subPass, nullptr, flags);
+}
+
+bool GraphicsPipeline::createLibrary(
+    const VkGraphicsPipelineLibraryFlagsEXT parts,
+    PipelineLayout& pipelineLayout,
+    const std::vector<VkFormat>& colorFormats,
+    const VkFormat depthFormat,
+    const VkFormat stencilFormat,
+    const VkPipelineCreateFlags flags,
+    const uint32_t viewMask)
+{
+    VkPipelineRenderingCreateInfo pipelineRenderingCreateInfo{};
+    pipelineRenderingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+    pipelineRenderingCreateInfo.pNext = nullptr;
+    pipelineRenderingCreateInfo.colorAttachmentCount = static_cast<uint32_t>(colorFormats.size());
+    pipelineRenderingCreateInfo.pColorAttachmentFormats = colorFormats.data();
+    pipelineRenderingCreateInfo.depthAttachmentFormat = depthFormat;
+    pipelineRenderingCreateInfo.stencilAttachmentFormat = stencilFormat;
+    pipelineRenderingCreateInfo.viewMask = viewMask;
+
+    return createLibrary(
+        parts, pipelineLayout, VK_NULL_HANDLE, 0, &pipelineRenderingCreateInfo, flags);
+}
+
+bool GraphicsPipeline::linkLibraries(
+    PipelineLayout& pipelineLayout,
+    const std::vector<const GraphicsPipeline*>& libraries,
+    const bool optimize,
+    const VkPipelineCreateFlags flags)
+{
+    VKW_ASSERT(this->initialized());
+    VKW_ASSERT(pipeline_ == VK_NULL_HANDLE);
+
+    if(!device_->isExtensionEnabled(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME))
     {
-        if(moduleInfo_[id].shaderModule != VK_NULL_HANDLE)
-        {
-            device_->vk().vkDestroyShaderModule(
-                device_->getHandle(), moduleInfo_[id].shaderModule, nullptr);
-            moduleInfo_[id].shaderModule = VK_NULL_HANDLE;
-        }
+        utils::Log::Error("vkw", "VK_EXT_graphics_pipeline_library is not enabled");
+        return false;
     }
-    specInfoList_.clear();
-    stageCreateInfoList_.clear();
+
+    VkGraphicsPipelineLibraryFlagsEXT parts = 0;
+    std::vector<VkPipeline> libraryHandles{};
+    libraryHandles.reserve(libraries.size());
+    for(const auto* library : libraries)
+    {
+        VKW_ASSERT(library != nullptr && library->isLibrary());
+        parts |= library->libraryParts();
+        libraryHandles.push_back(library->getHandle());
+    }
+    if(parts != allLibraryParts)
+    {
+        utils::Log::Error("vkw", "Linked libraries must cover the four pipeline parts");
+        return false;
+    }
+
+    VkPipelineLibraryCreateInfoKHR libraryCreateInfo{};
+    libraryCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR;
+    libraryCreateInfo.pNext = nullptr;
+    libraryCreateInfo.libraryCount = static_cast<uint32_t>(libraryHandles.size());
+    libraryCreateInfo.pLibraries = libraryHandles.data();
+
+    VkGraphicsPipelineCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    createInfo.pNext = &libraryCreateInfo;
+    createInfo.flags = flags;
+    if(optimize)
+    {
+        createInfo.flags |= VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT;
+    }
+    createInfo.layout = pipelineLayout.getHandle();
+    createInfo.basePipelineHandle = VK_NULL_HANDLE;
+    createInfo.basePipelineIndex = 0;
+
+    VKW_CHECK_VK_RETURN_FALSE(device_->vk().vkCreateGraphicsPipelines(
+        device_->getHandle(),
+        device_->pipelineCache().getHandle(),
+        1,
+        &createInfo,
+        nullptr,
+        &pipeline_));
+    generation_ = utils::nextGeneration();
+
+    return true;
+}
+
+bool GraphicsPipeline::createLibrary(
+    const VkGraphicsPipelineLibraryFlagsEXT parts,
+    PipelineLayout& pipelineLayout,
+    const VkRenderPass renderPass,
+    const uint32_t subPass,
+    void* pNext,
+    const VkPipelineCreateFlags flags)
+{
+    VKW_ASSERT(this->initialized());
+    VKW_ASSERT(pipeline_ == VK_NULL_HANDLE);
+    VKW_ASSERT(parts != 0 && (parts & ~allLibraryParts) == 0);
+
+    if(!device_->isExtensionEnabled(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME))
+    {
+        utils::Log::Error("vkw", "VK_EXT_graphics_pipeline_library is not enabled");
+        return false;
+    }
+
+    const bool hasVertexInput
+        = (parts & VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT) != 0;
+    const bool hasPreRasterization
+        = (parts & VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT) != 0;
+    const bool hasFragmentShader
+        = (parts & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT) != 0;
+    const bool hasFragmentOutput
+        = (parts & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT) != 0;
+
+    VkShaderStageFlags stageMask = 0;
+    if(hasPreRasterization)
+    {
+        stageMask |= VK_SHADER_STAGE_ALL_GRAPHICS & ~VK_SHADER_STAGE_FRAGMENT_BIT;
+        stageMask |= VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT;
+    }
+    if(hasFragmentShader)
+    {
+        stageMask |= VK_SHADER_STAGE_FRAGMENT_BIT;
+    }
+    this->finalizePipelineStages(stageMask);
+
+    VkGraphicsPipelineLibraryCreateInfoEXT libraryCreateInfo{};
+    libraryCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT;
+    libraryCreateInfo.pNext = pNext;
+    libraryCreateInfo.flags = parts;
+
+    // Each part only reads the states it owns, the others are left null
+    VkGraphicsPipelineCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    createInfo.pNext = &libraryCreateInfo;
+    createInfo.flags = flags | VK_PIPELINE_CREATE_LIBRARY_BIT_KHR
+                       | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+    createInfo.stageCount = static_cast<uint32_t>(stageCreateInfoList_.size());
+    createInfo.pStages = stageCreateInfoList_.data();
+    if(hasVertexInput && !useMeshShaders_)
+    {
+        createInfo.pVertexInputState = &vertexInputStateInfo_;
+        createInfo.pInputAssemblyState = &inputAssemblyStateInfo_;
+    }
+    if(hasPreRasterization)
+    {
+        createInfo.pTessellationState = useTessellation_ ? &tessellationStateInfo_ : nullptr;
+        createInfo.pViewportState = &viewportStateInfo_;
+        createInfo.pRasterizationState = &rasterizationStateInfo_;
+    }
+    if(hasFragmentShader)
+    {
+        createInfo.pDepthStencilState = &depthStencilStateInfo_;
+    }
+    if(hasFragmentShader || hasFragmentOutput)
+    {
+        createInfo.pMultisampleState = &multisamplingStateInfo_;
+    }
+    if(hasFragmentOutput)
+    {
+        createInfo.pColorBlendState = &colorBlendStateInfo_;
+    }
+    createInfo.pDynamicState = &dynamicStateInfo_;
+    createInfo.layout = pipelineLayout.getHandle();
+    createInfo.renderPass = renderPass;
+    createInfo.subpass = subPass;
+    createInfo.basePipelineHandle = VK_NULL_HANDLE;
+    createInfo.basePipelineIndex = 0;
+
+    const VkResult res = device_->vk().vkCreateGraphicsPipelines(
+        device_->getHandle(),
+        device_->pipelineCache().getHandle(),
+        1,
+        &createInfo,
+        nullptr,
+        &pipeline_);
+    releasePipelineStages();
+    VKW_CHECK_VK_RETURN_FALSE(res);
+    generation_ = utils::nextGeneration();
+
+    libraryParts_ = parts;
 
     return true;
 }
@@ -455,15 +633,28 @@ bool GraphicsPipeline::validatePipeline()
     return true;
 }
 
-void GraphicsPipeline::finalizePipelineStages()
+void GraphicsPipeline::finalizePipelineStages(const VkShaderStageFlags stageMask)
 {
+    static constexpr std::array<VkShaderStageFlagBits, maxStageCount> stages
+        = {VK_SHADER_STAGE_VERTEX_BIT,
+           VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT,
+           VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT,
+           VK_SHADER_STAGE_GEOMETRY_BIT,
+           VK_SHADER_STAGE_FRAGMENT_BIT,
+           VK_SHADER_STAGE_TASK_BIT_EXT,
+           VK_SHADER_STAGE_MESH_BIT_EXT};
+
     // Make some pre checks to avoid mixing traditional pipeline and mesh pipeline
-    VKW_CHECK_BOOL_FAIL(validatePipeline(), "Graphics pipeline built with incompatible settings");
+    if(stageMask == VK_SHADER_STAGE_ALL)
+    {
+        VKW_CHECK_BOOL_FAIL(
+            validatePipeline(), "Graphics pipeline built with incompatible settings");
+    }
 
     for(size_t id = 0; id < maxStageCount; ++id)
     {
         auto& info = moduleInfo_[id];
-        if(info.used)
+        if(info.used && (stageMask & stages[id]) != 0)
         {
             info.shaderModule
                 = utils::createShaderModule(device_->vk(), device_->getHandle(), info.shaderSource);
@@ -474,6 +665,7 @@ void GraphicsPipeline::finalizePipelineStages()
     {
         size_t offset = 0;
         auto& specMap = specMaps_[id];
+        specMap.clear();
         for(size_t i = 0; i < moduleInfo_[id].specSizes.size(); i++)
         {
             VkSpecializationMapEntry mapEntry
@@ -561,4 +753,19 @@ void GraphicsPipeline::finalizePipelineStages()
     dynamicStateInfo_.dynamicStateCount = static_cast<uint32_t>(dynamicStates_.size());
     dynamicStateInfo_.pDynamicStates = dynamicStates_.data();
 }
+
+void GraphicsPipeline::releasePipelineStages()
+{
+    for(size_t id = 0; id < maxStageCount; ++id)
+    {
+        if(moduleInfo_[id].shaderModule != VK_NULL_HANDLE)
+        {
+            device_->vk().vkDestroyShaderModule(
+                device_->getHandle(), moduleInfo_[id].shaderModule, nullptr);
+            moduleInfo_[id].shaderModule = VK_NULL_HANDLE;
+        }
+    }
+    specInfoList_.clear();
+    stageCreateInfoList_.clear();
+}
 } // namespace vkw
\ No newline at end of file
@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "vkw/detail/PipelineCache.hpp"
+
+#include "vkw/detail/utils.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#    include <process.h>
+#    define VKW_GETPID _getpid
+#else
+#    include <unistd.h>
+#    define VKW_GETPID getpid
+#endif
+
+namespace vkw
+{
+// Prepended to the data returned by vkGetPipelineCacheData
+struct PipelineCacheFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint32_t driverVersion;
+    uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+    uint64_t dataSize;
+    uint64_t dataHash;
+};
+
+static constexpr uint32_t pipelineCacheMagic = 0x43504b56; // "VKPC"
+static constexpr uint32_t pipelineCacheVersion = 1;
+
+// FNV-1a, only meant to detect damaged files
+static uint64_t hashData(const uint8_t* data, const size_t size)
+{
+    uint64_t ret = 0xcbf29ce484222325;
+    for(size_t i = 0; i < size; ++i)
+    {
+        ret ^= data[i];
+        ret *= 0x100000001b3;
+    }
+    return ret;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+PipelineCache::PipelineCache(Device& device)
+{
+    VKW_CHECK_BOOL_FAIL(this->init(device), "Creating pipeline cache");
+}
+
+PipelineCache& PipelineCache::operator=(PipelineCache&& cp)
+{
+    this->clear();
+
+    std::swap(device_, cp.device_);
+    std::swap(pipelineCache_, cp.pipelineCache_);
+    std::swap(initialized_, cp.initialized_);
+
+    return *this;
+}
+
+bool PipelineCache::init(Device& device)
+{
+    VKW_ASSERT(this->initialized() == false);
+
+    device_ = &device;
+
+    VkPipelineCacheCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.pNext = nullptr;
+    createInfo.flags = 0;
+    createInfo.initialDataSize = 0;
+    createInfo.pInitialData = nullptr;
+    VKW_INIT_CHECK_VK(device_->vk().vkCreatePipelineCache(
+        device_->getHandle(), &createInfo, nullptr, &pipelineCache_));
+
+    initialized_ = true;
+
+    return true;
+}
+
+void PipelineCache::clear()
+{
+    VKW_DELETE_VK(PipelineCache, pipelineCache_);
+
+    device_ = nullptr;
+    initialized_ = false;
+}
+
+bool PipelineCache::load(const std::string& filename)
+{
+    VKW_ASSERT(this->initialized());
+
+    std::vector<uint8_t> data{};
+    if(!readFile(filename, data))
+    {
+        return false;
+    }
+    VKW_CHECK_BOOL_RETURN_FALSE(mergeData(data));
+
+    utils::Log::Info("vkw", "Pipeline cache loaded from %s", filename.c_str());
+    return true;
+}
+
+bool PipelineCache::save(const std::string& filename, const bool mergeExisting)
+{
+    VKW_ASSERT(this->initialized());
+
+    if(mergeExisting)
+    {
+        std::vector<uint8_t> existingData{};
+        if(readFile(filename, existingData))
+        {
+            mergeData(existingData);
+        }
+    }
+
+    const auto data = getData();
+    if(data.empty())
+    {
+        return false;
+    }
+
+    const auto& properties = device_->getProperties();
+    // Padding is written to the file as well
+    PipelineCacheFileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = pipelineCacheMagic;
+    header.version = pipelineCacheVersion;
+    header.vendorID = properties.vendorID;
+    header.deviceID = properties.deviceID;
+    header.driverVersion = properties.driverVersion;
+    memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+    header.dataSize = data.size();
+    header.dataHash = hashData(data.data(), data.size());
+
+    // Unique per writer so that concurrent processes and threads do not write the same temporary
+    // file
+    const std::string tmpFilename
+        = filename + ".tmp" + std::to_string(static_cast<long long>(VKW_GETPID())) + "."
+          + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    {
+        std::ofstream file(tmpFilename, std::ios::binary | std::ios::trunc);
+        if(!file.is_open())
+        {
+            utils::Log::Error("vkw", "Error opening %s", tmpFilename.c_str());
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), std::streamsize(data.size()));
+        file.close();
+        if(file.fail())
+        {
+            utils::Log::Error("vkw", "Error writing %s", tmpFilename.c_str());
+            std::remove(tmpFilename.c_str());
+            return false;
+        }
+    }
+
+    // Renaming over an existing file fails on some platforms, the previous file is kept then
+    // since removing it first would not be atomic
+    if(std::rename(tmpFilename.c_str(), filename.c_str()) != 0)
+    {
+        utils::Log::Warning(
+            "vkw",
+            "Error renaming %s to %s, keeping the previous pipeline cache",
+            tmpFilename.c_str(),
+            filename.c_str());
+        std::remove(tmpFilename.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool PipelineCache::merge(const PipelineCache& other)
+{
+    VKW_ASSERT(this->initialized());
+    VKW_ASSERT(other.initialized());
+
+    VKW_CHECK_VK_RETURN_FALSE(device_->vk().vkMergePipelineCaches(
+        device_->getHandle(), pipelineCache_, 1, &other.getHandle()));
+    return true;
+}
+
+std::vector<uint8_t> PipelineCache::getData() const
+{
+    VKW_ASSERT(this->initialized());
+
+    size_t dataSize = 0;
+    if(device_->vk().vkGetPipelineCacheData(
+           device_->getHandle(), pipelineCache_, &dataSize, nullptr)
+       != VK_SUCCESS)
+    {
+        return {};
+    }
+
+    std::vector<uint8_t> ret(dataSize);
+    if(device_->vk().vkGetPipelineCacheData(
+           device_->getHandle(), pipelineCache_, &dataSize, ret.data())
+       != VK_SUCCESS)
+    {
+        return {};
+    }
+    ret.resize(dataSize);
+
+    return ret;
+}
+
+bool PipelineCache::readFile(const std::string& filename, std::vector<uint8_t>& data) const
+{
+    std::ifstream file(filename, std::ios::ate | std::ios::binary);
+    if(!file.is_open())
+    {
+        return false;
+    }
+
+    const size_t fileSize = static_cast<size_t>(file.tellg());
+    if(fileSize < sizeof(PipelineCacheFileHeader) + sizeof(VkPipelineCacheHeaderVersionOne))
+    {
+        utils::Log::Warning("vkw", "Pipeline cache %s: file too small", filename.c_str());
+        return false;
+    }
+
+    PipelineCacheFileHeader header{};
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    const auto& properties = device_->getProperties();
+    if(header.magic != pipelineCacheMagic || header.version != pipelineCacheVersion
+       || header.dataSize != fileSize - sizeof(header))
+    {
+        utils::Log::Warning("vkw", "Pipeline cache %s: invalid header", filename.c_str());
+        return false;
+    }
+    if(header.vendorID != properties.vendorID || header.deviceID != properties.deviceID
+       || header.driverVersion != properties.driverVersion
+       || memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+    {
+        utils::Log::Info(
+            "vkw", "Pipeline cache %s: written for another device or driver", filename.c_str());
+        return false;
+    }
+
+    data.resize(static_cast<size_t>(header.dataSize));
+    file.read(reinterpret_cast<char*>(data.data()), std::streamsize(data.size()));
+    if(file.fail() || hashData(data.data(), data.size()) != header.dataHash)
+    {
+        utils::Log::Warning("vkw", "Pipeline cache %s: damaged data", filename.c_str());
+        return false;
+    }
+
+    // The driver header must agree as well
+    VkPipelineCacheHeaderVersionOne cacheHeader{};
+    memcpy(&cacheHeader, data.data(), sizeof(cacheHeader));
+    if(cacheHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+       || cacheHeader.vendorID != properties.vendorID
+       || cacheHeader.deviceID != properties.deviceID
+       || memcmp(cacheHeader.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+    {
+        utils::Log::Warning("vkw", "Pipeline cache %s: invalid cache data", filename.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool PipelineCache::mergeData(const std::vector<uint8_t>& data)
+{
+    VkPipelineCacheCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.pNext = nullptr;
+    createInfo.flags = 0;
+    createInfo.initialDataSize = data.size();
+    createInfo.pInitialData = data.data();
+
+    VkPipelineCache srcCache = VK_NULL_HANDLE;
+    VKW_CHECK_VK_RETURN_FALSE(device_->vk().vkCreatePipelineCache(
+        device_->getHandle(), &createInfo, nullptr, &srcCache));
+    const VkResult res = device_->vk().vkMergePipelineCaches(
+        device_->getHandle(), pipelineCache_, 1, &srcCache);
+    device_->vk().vkDestroyPipelineCache(device_->getHandle(), srcCache, nullptr);
+    VKW_CHECK_VK_RETURN_FALSE(res);
+
+    return true;
+}
+} // namespace vkw
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "vkw/detail/QueryPool.hpp"
+
+#include "vkw/detail/utils.hpp"
+
+#include <bitset>
+
+namespace vkw
+{
+// Counters of PipelineStatistics, in the same order as VkQueryPipelineStatisticFlagBits
+static constexpr uint64_t PipelineStatistics::*statisticMembers[] = {
+    &PipelineStatistics::inputAssemblyVertices,
+    &PipelineStatistics::inputAssemblyPrimitives,
+    &PipelineStatistics::vertexShaderInvocations,
+    &PipelineStatistics::geometryShaderInvocations,
+    &PipelineStatistics::geometryShaderPrimitives,
+    &PipelineStatistics::clippingInvocations,
+    &PipelineStatistics::clippingPrimitives,
+    &PipelineStatistics::fragmentShaderInvocations,
+    &PipelineStatistics::tessellationControlShaderPatches,
+    &PipelineStatistics::tessellationEvaluationShaderInvocations,
+    &PipelineStatistics::computeShaderInvocations,
+    &PipelineStatistics::taskShaderInvocations,
+    &PipelineStatistics::meshShaderInvocations};
+static constexpr size_t statisticCount = sizeof(statisticMembers) / sizeof(statisticMembers[0]);
+
+PipelineStatistics& PipelineStatistics::operator+=(const PipelineStatistics& rhs)
+{
+    for(size_t i = 0; i < statisticCount; ++i)
+    {
+        this->*statisticMembers[i] += rhs.*statisticMembers[i];
+    }
+    return *this;
+}
+
+PipelineStatistics PipelineStatistics::fromQueryResults(
+    const VkQueryPipelineStatisticFlags flags, const uint64_t* values)
+{
+    PipelineStatistics ret{};
+
+    size_t index = 0;
+    for(size_t i = 0; i < statisticCount; ++i)
+    {
+        if(flags & (VkQueryPipelineStatisticFlags(1) << i))
+        {
+            ret.*statisticMembers[i] = values[index++];
+        }
+    }
+
+    return ret;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+QueryPool::QueryPool(
+    Device& device,
+    const VkQueryType queryType,
+    const uint32_t queryCount,
+    const VkQueryPipelineStatisticFlags pipelineStatistics)
+{
+    VKW_CHECK_BOOL_FAIL(
+        this->init(device, queryType, queryCount, pipelineStatistics), "Creating query pool");
+}
+
+QueryPool& QueryPool::operator=(QueryPool&& cp)
+{
+    this->clear();
+
+    std::swap(device_, cp.device_);
+    std::swap(queryPool_, cp.queryPool_);
+
+    std::swap(queryType_, cp.queryType_);
+    std::swap(pipelineStatistics_, cp.pipelineStatistics_);
+    std::swap(queryCount_, cp.queryCount_);
+
+    std::swap(initialized_, cp.initialized_);
+
+    return *this;
+}
+
+bool QueryPool::init(
+    Device& device,
+    const VkQueryType queryType,
+    const uint32_t queryCount,
+    const VkQueryPipelineStatisticFlags pipelineStatistics)
+{
+    VKW_ASSERT(this->initialized() == false);
+    VKW_ASSERT(queryCount > 0);
+    VKW_ASSERT((queryType == VK_QUERY_TYPE_PIPELINE_STATISTICS) || (pipelineStatistics == 0));
+
+    device_ = &device;
+
+    queryType_ = queryType;
+    pipelineStatistics_ = pipelineStatistics;
+    queryCount_ = queryCount;
+
+    VkQueryPoolCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    createInfo.pNext = nullptr;
+    createInfo.flags = 0;
+    createInfo.queryType = queryType_;
+    createInfo.queryCount = queryCount_;
+    createInfo.pipelineStatistics = pipelineStatistics_;
+    VKW_INIT_CHECK_VK(
+        device_->vk().vkCreateQueryPool(device_->getHandle(), &createInfo, nullptr, &queryPool_));
+
+    initialized_ = true;
+
+    return true;
+}
+
+void QueryPool::clear()
+{
+    VKW_DELETE_VK(QueryPool, queryPool_);
+
+    queryType_ = VK_QUERY_TYPE_TIMESTAMP;
+    pipelineStatistics_ = 0;
+    queryCount_ = 0;
+
+    device_ = nullptr;
+    initialized_ = false;
+}
+
+void QueryPool::reset(const uint32_t firstQuery, const uint32_t queryCount)
+{
+    VKW_ASSERT(this->initialized());
+    VKW_ASSERT(firstQuery + queryCount <= queryCount_);
+
+    device_->vk().vkResetQueryPool(device_->getHandle(), queryPool_, firstQuery, queryCount);
+}
+
+uint32_t QueryPool::valuesPerQuery() const
+{
+    if(queryType_ == VK_QUERY_TYPE_PIPELINE_STATISTICS)
+    {
+        return static_cast<uint32_t>(std::bitset<32>(pipelineStatistics_).count());
+    }
+    return 1;
+}
+
+VkResult QueryPool::getResults(
+    const uint32_t firstQuery,
+    const uint32_t queryCount,
+    void* data,
+    const size_t dataSize,
+    const VkDeviceSize stride,
+    const VkQueryResultFlags flags) const
+{
+    VKW_ASSERT(this->initialized());
+    VKW_ASSERT(firstQuery + queryCount <= queryCount_);
+
+    return device_->vk().vkGetQueryPoolResults(
+        device_->getHandle(), queryPool_, firstQuery, queryCount, dataSize, data, stride, flags);
+}
+
+VkResult QueryPool::getResults(
+    const uint32_t firstQuery,
+    const uint32_t queryCount,
+    std::vector<uint64_t>& results,
+    const VkQueryResultFlags flags) const
+{
+    const bool withAvailability = (flags & VK_QUERY_RESULT_WITH_AVAILABILITY_BIT) != 0;
+    const size_t valueCount = valuesPerQuery() + (withAvailability ? 1 : 0);
+
+    results.resize(queryCount * valueCount);
+    return getResults(
+        firstQuery,
+        queryCount,
+        results.data(),
+        results.size() * sizeof(uint64_t),
+        valueCount * sizeof(uint64_t),
+        flags | VK_QUERY_RESULT_64_BIT);
+}
+} // namespace vkw
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2025 Adrien ARNAUD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "vkw/detail/ShaderObject.hpp"
+
+#include <cstring>
+
+namespace vkw
+{
+ShaderObject::ShaderObject(Device& device)
+{
+    VKW_CHECK_BOOL_FAIL(this->init(device), "Creating shader object");
+}
+
+ShaderObject::ShaderObject(ShaderObject&& cp) { *this = std::move(cp); }
+
+ShaderObject& ShaderObject::operator=(ShaderObject&& cp)
+{
+    this->clear();
+
+    std::swap(device_, cp.device_);
+    std::swap(stageInfo_, cp.stageInfo_);
+    std::swap(shaders_, cp.shaders_);
+    std::swap(initialized_, cp.initialized_);
+
+    return *this;
+}
+
+ShaderObject::~ShaderObject() { this->clear(); }
+
+bool ShaderObject::init(Device& device)
+{
+    VKW_ASSERT(this->initialized() == false);
+
+    device_ = &device;
+
+    initialized_ = true;
+
+    return true;
+}
+
+void ShaderObject::clear()
+{
+    for(auto& shader : shaders_)
+    {
+        VKW_DELETE_VK(ShaderEXT, shader);
+    }
+
+    for(auto& info : stageInfo_)
+    {
+        info = {};
+    }
+
+    device_ = nullptr;
+    initialized_ = false;
+}
+
+ShaderObject& ShaderObject::addShaderStage(
+    const VkShaderStageFlagBits stage, const std::string& shaderSource)
+{
+    VKW_ASSERT(this->initialized());
+
+    const int id = getStageIndex(stage);
+    VKW_ASSERT(id >= 0);
+
+    auto& info = stageInfo_[id];
+    info.used = true;
+    info.shaderSource = utils::readShader(shaderSource);
+
+    return *this;
+}
+
+ShaderObject& ShaderObject::addShaderStage(
+    const VkShaderStageFlagBits stage, const char* srcData, const size_t byteCount)
+{
+    VKW_ASSERT(this->initialized());
+
+    const int id = getStageIndex(stage);
+    VKW_ASSERT(id >= 0);
+
+    auto& info = stageInfo_[id];
+    info.used = true;
+    info.shaderSource.resize(byteCount);
+    memcpy(info.shaderSource.data(), srcData, byteCount);
+
+    return *this;
+}
+
+bool ShaderObject::createShaders(const PipelineLayout& pipelineLayout, const bool linked)
+{
+    VKW_ASSERT(this->initialized());
+
+    if(!device_->isExtensionEnabled(VK_EXT_SHADER_OBJECT_EXTENSION_NAME))
+    {
+        utils::Log::Error("vkw", "VK_EXT_shader_object is not enabled");
+        return false;
+    }
+    VKW_CHECK_BOOL_RETURN_FALSE(validateStages());
+
+    std::vector<VkPushConstantRange> pushConstantRanges{};
+    for(const auto& range : pipelineLayout.ranges_)
+    {
+        if(range.size != 0)
+        {
+            pushConstantRanges.push_back(range);
+        }
+    }
+    const auto& setLayouts = pipelineLayout.descriptorSetLayouts_;
+
+    std::vector<size_t> stageIndices{};
+    for(size_t id = 0; id < maxStageCount; ++id)
+    {
+        if(stageInfo_[id].used)
+        {
+            stageIndices.push_back(id);
+        }
+    }
+
+    // Kept alive until the shaders are created
+    std::array<std::vector<VkSpecializationMapEntry>, maxStageCount> specMaps{};
+    std::array<VkSpecializationInfo, maxStageCount> specInfos{};
+
+    const bool linkStages = linked && stageIndices.size() > 1;
+    const bool hasTaskShader = stageInfo_[getStageIndex(VK_SHADER_STAGE_TASK_BIT_EXT)].used;
+    std::vector<VkShaderCreateInfoEXT> createInfos{};
+    for(size_t i = 0; i < stageIndices.size(); ++i)
+    {
+        const size_t id = stageIndices[i];
+        const auto& info = stageInfo_[id];
+
+        size_t offset = 0;
+        for(size_t j = 0; j < info.specSizes.size(); ++j)
+        {
+            specMaps[id].push_back(
+                {static_cast<uint32_t>(j), static_cast<uint32_t>(offset), info.specSizes[j]});
+            offset += info.specSizes[j];
+        }
+        specInfos[id].mapEntryCount = static_cast<uint32_t>(specMaps[id].size());
+        specInfos[id].pMapEntries = specMaps[id].data();
+        specInfos[id].dataSize = info.specData.size();
+        specInfos[id].pData = info.specData.data();
+
+        VkShaderCreateInfoEXT createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT;
+        createInfo.pNext = nullptr;
+        createInfo.flags = linkStages ? VK_SHADER_CREATE_LINK_STAGE_BIT_EXT : 0;
+        if(stageList[id] == VK_SHADER_STAGE_MESH_BIT_EXT && !hasTaskShader)
+        {
+            createInfo.flags |= VK_SHADER_CREATE_NO_TASK_SHADER_BIT_EXT;
+        }
+        createInfo.stage = stageList[id];
+        createInfo.nextStage = (i + 1 < stageIndices.size() && id != computeStageIndex)
+                                   ? stageList[stageIndices[i + 1]]
+                                   : 0;
+        createInfo.codeType = VK_SHADER_CODE_TYPE_SPIRV_EXT;
+        createInfo.codeSize = info.shaderSource.size();
+        createInfo.pCode = info.shaderSource.data();
+        createInfo.pName = "main";
+        createInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+        createInfo.pSetLayouts = setLayouts.data();
+        createInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
+        createInfo.pPushConstantRanges
+            = (pushConstantRanges.size() > 0) ? pushConstantRanges.data() : nullptr;
+        createInfo.pSpecializationInfo = (info.specSizes.size() > 0) ? &specInfos[id] : nullptr;
+        createInfos.push_back(createInfo);
+    }
+
+    std::vector<VkShaderEXT> shaders(createInfos.size(), VK_NULL_HANDLE);
+    const VkResult res = device_->vk().vkCreateShadersEXT(
+        device_->getHandle(),
+        static_cast<uint32_t>(createInfos.size()),
+        createInfos.data(),
+        nullptr,
+        shaders.data());
+    if(res != VK_SUCCESS)
+    {
+        // Some shaders may have been created anyway
+        for(auto& shader : shaders)
+        {
+            VKW_DELETE_VK(ShaderEXT, shader);
+        }
+        utils::Log::Error("vkw", "Error creating shader objects");
+        return false;
+    }
+
+    for(size_t i = 0; i < stageIndices.size(); ++i)
+    {
+        VKW_DELETE_VK(ShaderEXT, shaders_[stageIndices[i]]);
+        shaders_[stageIndices[i]] = shaders[i];
+    }
+
+    return true;
+}
+
+bool ShaderObject::validateStages() const
+{
+    const auto used = [this](const VkShaderStageFlagBits stage) {
+        return stageInfo_[getStageIndex(stage)].used;
+    };
+
+    const bool hasVertexShader = used(VK_SHADER_STAGE_VERTEX_BIT);
+    const bool hasMeshShader = used(VK_SHADER_STAGE_MESH_BIT_EXT);
+    const bool hasGraphicsShader = hasVertexShader || hasMeshShader
+                                   || used(VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT)
+                                   || used(VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT)
+                                   || used(VK_SHADER_STAGE_GEOMETRY_BIT)
+                                   || used(VK_SHADER_STAGE_TASK_BIT_EXT)
+                                   || used(VK_SHADER_STAGE_FRAGMENT_BIT);
+
+    if(isCompute())
+    {
+        if(hasGraphicsShader)
+        {
+            utils::Log::Error("vkw", "Compute shader objects must not define graphics stages");
+            return false;
+        }
+        return true;
+    }
+
+    if(hasVertexShader == hasMeshShader)
+    {
+        utils::Log::Error("vkw", "Shader object must define either a vertex or a mesh shader");
+        return false;
+    }
+
+    return true;
+}
+} // namespace vkw
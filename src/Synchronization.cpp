@@ -274,4 +274,216 @@ void Event::clear()
     device_ = nullptr;
     initialized_ = false;
 }
+
+// -------------------------------------------------------------------------------------------------
+
+bool FencePool::init(Device& device)
+{
+    VKW_ASSERT(this->initialized() == false);
+
+    device_ = &device;
+    initialized_ = true;
+
+    return true;
+}
+
+void FencePool::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for(auto& fence : pendingFences_)
+    {
+        // Submitted fences must not be destroyed while in use
+        if(!fence.wait())
+        {
+            utils::Log::Error("vkw", "FencePool: error waiting for a pending fence");
+        }
+    }
+    freeFences_.clear();
+    pendingFences_.clear();
+
+    device_ = nullptr;
+    initialized_ = false;
+}
+
+Fence FencePool::acquire()
+{
+    VKW_ASSERT(this->initialized());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    collectPending();
+    if(freeFences_.empty())
+    {
+        return Fence(*device_, false);
+    }
+
+    Fence ret = std::move(freeFences_.back());
+    freeFences_.pop_back();
+    return ret;
+}
+
+void FencePool::release(Fence&& fence, const bool submitted)
+{
+    VKW_ASSERT(this->initialized());
+    VKW_ASSERT(fence.initialized());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if(!submitted)
+    {
+        // Would never be signaled, it stays unsignaled as handed out by acquire()
+        freeFences_.emplace_back(std::move(fence));
+        return;
+    }
+    if(fence.getStatus() == VK_SUCCESS && fence.reset())
+    {
+        freeFences_.emplace_back(std::move(fence));
+        return;
+    }
+    pendingFences_.emplace_back(std::move(fence));
+}
+
+void FencePool::collectPending()
+{
+    for(size_t i = 0; i < pendingFences_.size();)
+    {
+        auto& fence = pendingFences_[i];
+        if(fence.getStatus() != VK_SUCCESS || !fence.reset())
+        {
+            ++i;
+            continue;
+        }
+
+        freeFences_.emplace_back(std::move(fence));
+        if(i + 1 < pendingFences_.size())
+        {
+            pendingFences_[i] = std::move(pendingFences_.back());
+        }
+        pendingFences_.pop_back();
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+bool SemaphorePool::init(Device& device)
+{
+    VKW_ASSERT(this->initialized() == false);
+
+    device_ = &device;
+    initialized_ = true;
+
+    return true;
+}
+
+void SemaphorePool::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for(const auto& pending : pendingSemaphores_)
+    {
+        // The wait consuming the semaphore must be done before it is destroyed
+        VkResult res = VK_SUCCESS;
+        if(pending.fence != VK_NULL_HANDLE)
+        {
+            res = device_->vk().vkWaitForFences(
+                device_->getHandle(), 1, &pending.fence, VK_TRUE, ~uint64_t(0));
+        }
+        else
+        {
+            VkSemaphoreWaitInfo waitInfo = {};
+            waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+            waitInfo.pNext = nullptr;
+            waitInfo.flags = 0;
+            waitInfo.semaphoreCount = 1;
+            waitInfo.pSemaphores = &pending.timeline;
+            waitInfo.pValues = &pending.value;
+            res = device_->vk().vkWaitSemaphores(device_->getHandle(), &waitInfo, ~uint64_t(0));
+        }
+        if(res != VK_SUCCESS)
+        {
+            utils::Log::Error("vkw", "SemaphorePool: error waiting for a pending semaphore");
+        }
+    }
+    freeSemaphores_.clear();
+    pendingSemaphores_.clear();
+
+    device_ = nullptr;
+    initialized_ = false;
+}
+
+Semaphore SemaphorePool::acquire()
+{
+    VKW_ASSERT(this->initialized());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    collectPending();
+    if(freeSemaphores_.empty())
+    {
+        return Semaphore(*device_);
+    }
+
+    Semaphore ret = std::move(freeSemaphores_.back());
+    freeSemaphores_.pop_back();
+    return ret;
+}
+
+void SemaphorePool::release(Semaphore&& semaphore)
+{
+    VKW_ASSERT(this->initialized());
+    VKW_ASSERT(semaphore.initialized());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    freeSemaphores_.emplace_back(std::move(semaphore));
+}
+
+void SemaphorePool::release(Semaphore&& semaphore, const Fence& fence)
+{
+    VKW_ASSERT(this->initialized());
+    VKW_ASSERT(semaphore.initialized());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    pendingSemaphores_.push_back({std::move(semaphore), fence.getHandle(), VK_NULL_HANDLE, 0});
+}
+
+void SemaphorePool::release(
+    Semaphore&& semaphore, const TimelineSemaphore& timeline, const uint64_t value)
+{
+    VKW_ASSERT(this->initialized());
+    VKW_ASSERT(semaphore.initialized());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    pendingSemaphores_.push_back(
+        {std::move(semaphore), VK_NULL_HANDLE, timeline.getHandle(), value});
+}
+
+void SemaphorePool::collectPending()
+{
+    for(size_t i = 0; i < pendingSemaphores_.size();)
+    {
+        auto& pending = pendingSemaphores_[i];
+
+        bool completed = false;
+        if(pending.fence != VK_NULL_HANDLE)
+        {
+            completed = device_->vk().vkGetFenceStatus(device_->getHandle(), pending.fence)
+                        == VK_SUCCESS;
+        }
+        else
+        {
+            uint64_t currentValue = 0;
+            device_->vk().vkGetSemaphoreCounterValue(
+                device_->getHandle(), pending.timeline, &currentValue);
+            completed = currentValue >= pending.value;
+        }
+        if(!completed)
+        {
+            ++i;
+            continue;
+        }
+
+        freeSemaphores_.emplace_back(std::move(pending.semaphore));
+        if(i + 1 < pendingSemaphores_.size())
+        {
+            pendingSemaphores_[i] = std::move(pendingSemaphores_.back());
+        }
+        pendingSemaphores_.pop_back();
+    }
+}
 } // namespace vkw
\ No newline at end of file